@@ -55,60 +55,89 @@
 //////////////////////////////////////////////////////////////////////////////////////////
 
 #include <avr/interrupt.h>
-#include <util/delay.h>
+#include <avr/pgmspace.h>
 
 #include "UART.h"
 #include "Serial.h"
 #include "CricketBus.h"
+#include "CricketLED.h"
+#include "CricketScript.h"
+#include "CricketTask.h"
 
 #define DELAY_MS  1000              // mS of on time between displayed frames
 
+//
+// Uncomment this to run the same demo from a script (see CricketScript.h) instead of
+//   the C code in main(). The script could just as well be in EEPROM.
+//
+//#define SCRIPT
+
+#ifdef SCRIPT
+static const uint8_t DemoScript[] PROGMEM = {
+    CRICKET_S_BRIGHT(0,4),
+    CRICKET_S_SET(1025),
+    CRICKET_S_REPEAT(0),
+        CRICKET_S_REPEAT(16*4),
+            CRICKET_S_SHOWDEC(0), CRICKET_S_ADD(1), CRICKET_S_WAIT(100),
+        CRICKET_S_NEXT,
+        CRICKET_S_WAIT(DELAY_MS),
+        CRICKET_S_REPEAT(16*4),
+            CRICKET_S_SHOWHEX(0), CRICKET_S_ADD(1), CRICKET_S_WAIT(100),
+        CRICKET_S_NEXT,
+        CRICKET_S_WAIT(DELAY_MS),
+        CRICKET_S_REPEAT(16/2),
+            CRICKET_S_BRIGHT(0,0), CRICKET_S_WAIT(100), CRICKET_S_BRIGHT(0,1), CRICKET_S_WAIT(100),
+            CRICKET_S_BRIGHT(0,2), CRICKET_S_WAIT(100), CRICKET_S_BRIGHT(0,3), CRICKET_S_WAIT(100),
+            CRICKET_S_BRIGHT(0,4), CRICKET_S_WAIT(100), CRICKET_S_BRIGHT(0,5), CRICKET_S_WAIT(100),
+            CRICKET_S_BRIGHT(0,6), CRICKET_S_WAIT(100), CRICKET_S_BRIGHT(0,7), CRICKET_S_WAIT(100),
+        CRICKET_S_NEXT,
+        CRICKET_S_BRIGHT(0,4),
+        CRICKET_S_REPEAT(4),
+            CRICKET_S_WAIT(200), CRICKET_S_PAT(0,0x01,0x01,0x01,0x01),
+            CRICKET_S_WAIT(200), CRICKET_S_PAT(0,0x02,0x02,0x02,0x02),
+            CRICKET_S_WAIT(200), CRICKET_S_PAT(0,0x04,0x04,0x04,0x04),
+            CRICKET_S_WAIT(200), CRICKET_S_PAT(0,0x08,0x08,0x08,0x08),
+            CRICKET_S_WAIT(200), CRICKET_S_PAT(0,0x10,0x10,0x10,0x10),
+            CRICKET_S_WAIT(200), CRICKET_S_PAT(0,0x20,0x20,0x20,0x20),
+            CRICKET_S_WAIT(200), CRICKET_S_PAT(0,0x40,0x40,0x40,0x40),
+            CRICKET_S_WAIT(200), CRICKET_S_PAT(0,0x80,0x80,0x80,0x80),
+            CRICKET_S_WAIT(100),
+        CRICKET_S_NEXT,
+        CRICKET_S_WAIT(DELAY_MS),
+    CRICKET_S_NEXT,
+    CRICKET_S_END };
+#endif
+
 //
 // If you have trouble, uncomment this and look at your bus line (default: PORTD.7)
 //   on an oscilloscope. The bus protocol is available on the net.
+//   Or, run CricketSniffer.c on a second board to log the bus traffic.
 //
 //#define DEBUG
 
+#if !defined(DEBUG) && !defined(SCRIPT)
 //////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////
 //
-// CricketDisplay.c - Test the Arduino interface to a cricket display
+// DemoTask - Run the demo
 //
-// Inputs:      None. (Embedded program - no command line options)
+// A resumable task (see CricketTask.h): each delay lets other tasks run, and the
+//   CPU sleeps when none have anything to do.
 //
-// Outputs:     None. (Never returns)
+// Inputs:      None.
 //
-int main(void) {
-
-    //////////////////////////////////////////////////////////////////////////////////////
-    //
-    // Initialize things
-    //
-    UARTInit();
-
-    CricketBusInit();
-
-    sei();                                          // Enable interrupts
-
-    PrintString("Reset CricketBusTest\r\n");
-
-#ifdef DEBUG
-    while(1) {
-        CricketBusPut(16,true);
-        _delay_ms(10);
-        }
-#endif // DEBUG
+// Outputs:     None.
+//
+static void DemoTask(void) {
+    static uint16_t Number = 1025;
+    static uint8_t  Count;
+    static uint8_t  Bit;
 
-    //////////////////////////////////////////////////////////////////////////////////////
-    //
-    // All done with init,
-    // 
-    uint16_t Number = 1025;
+    CRICKET_PT_BEGIN;
 
     CricketLEDBright(4,0);
 
     while(1) {
-        int Count;
 
         for( Count = 0; Count < 16*4; Count++ ) {
             CricketLEDDec(Number,0);
@@ -118,10 +147,10 @@ int main(void) {
             PrintCRLF();
             
             Number++;
-            _delay_ms(100);
+            CRICKET_PT_DELAY(100);
             }
 
-        _delay_ms(DELAY_MS);              // Wait 1/2 cycle
+        CRICKET_PT_DELAY(DELAY_MS);             // Wait 1/2 cycle
 
         for( Count = 0; Count < 16*4; Count++ ) {
             CricketLEDHex(Number,0);
@@ -129,40 +158,100 @@ int main(void) {
             PrintString("Display hex ");
             PrintD(Number,0);
             PrintCRLF();
-            _delay_ms(100);
-            
+
             Number++;
+            CRICKET_PT_DELAY(100);
             }
 
-        _delay_ms(DELAY_MS);              // Wait 1/2 cycle
+        CRICKET_PT_DELAY(DELAY_MS);             // Wait 1/2 cycle
 
         for( Count = 0; Count < 16*4; Count++ ) {
             uint8_t Bright = Count & 0x07;
 
-            CricketLEDBright(Bright,0)
+            CricketLEDBright(Bright,0);
 
             PrintString("Display bright ");
             PrintD(Bright,0);
             PrintCRLF();
-            _delay_ms(100);
+            CRICKET_PT_DELAY(100);
             }
 
         CricketLEDBright(4,0);
 
         for( Count = 0; Count < 4; Count++ ) {
-            int Bit;
 
             PrintString("Cycle Pattern bits\r\n");
 
             for( Bit = 0; Bit < 8; Bit++ ) {
-                _delay_ms(200);
-                CricketLEDPat(1 << Bit,1 << Bit,1 << Bit,1 << Bit,0)
+                CRICKET_PT_DELAY(200);
+                CricketLEDPat(1 << Bit,1 << Bit,1 << Bit,1 << Bit,0);
                 }
 
-            _delay_ms(100);
+            CRICKET_PT_DELAY(100);
             }
 
-        _delay_ms(DELAY_MS);              // Wait 1/2 cycle
+        CRICKET_PT_DELAY(DELAY_MS);             // Wait 1/2 cycle
         } 
+
+    CRICKET_PT_END;
+    }
+#endif // !DEBUG && !SCRIPT
+
+
+#ifdef DEBUG
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// DebugTask - Send a byte for the scope to look at
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+static void DebugTask(void) {
+
+    CricketBusPut(16,true);
+    }
+#endif // DEBUG
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketDisplay.c - Test the Arduino interface to a cricket display
+//
+// Inputs:      None. (Embedded program - no command line options)
+//
+// Outputs:     None. (Never returns)
+//
+int main(void) {
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    //
+    // Initialize things
+    //
+    UARTInit();
+
+    CricketBusInit();
+    CricketTaskInit();
+
+    sei();                                          // Enable interrupts
+
+    PrintString("Reset CricketBusTest\r\n");
+
+#ifdef DEBUG
+    CricketTaskEvery(DebugTask,10);
+#elif defined(SCRIPT)
+    CricketScriptRun(DemoScript,CRICKET_SCRIPT_PROGMEM);
+    CricketTaskEvery(CricketScriptTick,CRICKET_TICK_MS);
+#else
+    CricketTaskStart(DemoTask);
+#endif
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    //
+    // All done with init, run the tasks
+    // 
+    CricketTaskRun();
     }
 
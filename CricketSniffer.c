@@ -0,0 +1,345 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      CricketSniffer.c
+//
+//  SYNOPSIS
+//
+//      Connect the white, "bus signal" of the cricket bus to PORTB.0 (ICP1, Arduino
+//        pin 8), and black GND to ground. The sniffer only listens: the pin is an input,
+//        with no pullup.
+//
+//      Connect the serial port at 500000 baud (BAUD in sniffer/Makefile), 8,n,1.
+//
+//      Build with sniffer/Makefile, load, and run. The sniffer sends one record per bus
+//        byte, as below.
+//
+//
+//  DESCRIPTION
+//
+//      Passive cricket bus sniffer.
+//
+//      Edges on the bus are captured by the Timer1 input capture unit, so the time of
+//        each edge is exact no matter what else is running. Bytes are decoded from the
+//        edge times in the capture interrupt, by the same decoder as CricketBusRx.c
+//        (CricketBusEdge.h), and queued with a timestamp for the main loop to send.
+//
+//      Records are 6 bytes, binary:
+//
+//          Byte 0      Record type, and flags
+//                          0xF0 | flags    Bus byte
+//                                  0x01        Command bit set (line low)
+//                                  0x02        Framing error (start or stop bit low)
+//                          0xE0            Frames lost (data byte = count, max 255)
+//                          0xE1            Reset (data byte = record format, 1)
+//          Byte 1      Data byte
+//          Byte 2-5    Timestamp, uS since reset, LSB first (end of pre-start)
+//
+//      A fully loaded bus is one byte every 210 uS, or 28.6 KBytes/sec of records. At
+//        500000 baud the serial port can send 50 KBytes/sec, so nothing is lost with
+//        the bus flat out. If the record queue does fill up, the count of frames lost
+//        goes out in a 0xE0 record as soon as there's room.
+//
+//  NOTES
+//
+//      Timestamps wrap after about 35 minutes.
+//
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+
+#include <avr/interrupt.h>
+
+#include "UART.h"
+#include "CricketBus.h"
+#include "CricketBusEdge.h"
+#include "PortMacros.h"
+
+//
+// Sniffer input (must be ICP1)
+//
+#define SNIFF_PORT      B
+#define SNIFF_PIN       0
+
+#define SNIFF_LEVEL     _BIT_ON(_PIN(SNIFF_PORT),SNIFF_PIN)
+
+//
+// Record queue, between the capture interrupt and the main loop. Must be a power of
+//   two long, since the code uses a mask for wraparound.
+//
+#define SNIFF_FIFO_SIZE (1 << 5)            // == 32 records (6.7 mS of full bus)
+#define SNIFF_FIFO_WRAP (SNIFF_FIFO_SIZE-1)
+
+#define SNIFF_BYTE      0xF0                // Record types, per above
+#define SNIFF_LOST      0xE0
+#define SNIFF_RESET     0xE1
+#define SNIFF_FORMAT    1
+
+#define SNIFF_COMMAND   0x01                // SNIFF_BYTE flags
+#define SNIFF_FRAMING   0x02
+
+//
+// Timer1 runs at clk/8, so 2 ticks per uS at 16 MHz
+//
+#define SNIFF_US_TICKS(_us_)    ((uint16_t) (((F_CPU/8000UL)*(_us_))/1000UL))
+
+#define SNIFF_BIT_TICKS     SNIFF_US_TICKS(CRICKET_BIT_US)
+#define SNIFF_PRESTART_MIN  SNIFF_US_TICKS(CRICKET_PRESTART_US/2)
+#define SNIFF_END_TICKS     CRICKET_EDGE_END(SNIFF_BIT_TICKS)       // Middle of stop bit
+#define SNIFF_TICKS_US      (F_CPU/8000000UL)
+
+#if F_CPU % 8000000UL
+#   error "CricketSniffer.c: Timestamps need F_CPU a multiple of 8 MHz"
+#endif
+
+typedef struct {
+    uint8_t     Type;
+    uint8_t     Data;
+    uint32_t    Time;
+    } SNIFF_RECORD;
+
+static struct {
+    SNIFF_RECORD    FIFO[SNIFF_FIFO_SIZE];
+
+    uint8_t     FIFO_In;                    // FIFO input  pointer
+    uint8_t     FIFO_Out;                   // FIFO output pointer
+    uint8_t     Lost;                       // Frames dropped, FIFO full
+
+    uint16_t    Wraps;                      // Timer1 overflows, high half of time
+    uint32_t    Start;                      // Time of current byte, full 32 bits
+
+    CRICKET_EDGE Decode;                    // Edge decoder, see CricketBusEdge.h
+    } Sniff NOINIT;
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// SniffPut - Queue one record
+//
+// Inputs:      Record type
+//              Data byte
+//              Timestamp, Timer1 ticks
+//
+// Outputs:     None.
+//
+static void SniffPut(uint8_t Type,uint8_t Data,uint32_t Time) {
+    uint8_t NewIn = (Sniff.FIFO_In+1) & SNIFF_FIFO_WRAP;
+
+    if( NewIn == Sniff.FIFO_Out ) {
+        if( Sniff.Lost < 0xFF )
+            Sniff.Lost++;
+        return;
+        }
+
+    Sniff.FIFO[Sniff.FIFO_In].Type = Type;
+    Sniff.FIFO[Sniff.FIFO_In].Data = Data;
+    Sniff.FIFO[Sniff.FIFO_In].Time = Time;
+    Sniff.FIFO_In                  = NewIn;
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// SniffSend - Send one record out the serial port
+//
+// Inputs:      Record type
+//              Data byte
+//              Timestamp, Timer1 ticks
+//
+// Outputs:     None.
+//
+static void SniffSend(uint8_t Type,uint8_t Data,uint32_t Time) {
+
+    Time /= SNIFF_TICKS_US;
+
+    PutUARTByteW(Type);
+    PutUARTByteW(Data);
+    PutUARTByteW((Time >>  0) & 0xFF);
+    PutUARTByteW((Time >>  8) & 0xFF);
+    PutUARTByteW((Time >> 16) & 0xFF);
+    PutUARTByteW((Time >> 24) & 0xFF);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Timer1 overflow - Count the high half of the time
+//
+ISR(TIMER1_OVF_vect) { Sniff.Wraps++; }
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// SniffEdge - Process one edge on the bus
+//
+// Decoded as in CricketBusRx.c (see CricketBusEdge.h). The start bit also gets a full
+//   32-bit timestamp.
+//
+// Inputs:      Timer1 time of the edge
+//              Line level after the edge
+//
+// Outputs:     None.
+//
+static void SniffEdge(uint16_t Time,uint8_t Level) {
+    uint16_t Wraps;
+
+    if( !CricketEdge(&Sniff.Decode,Time,Level,SNIFF_BIT_TICKS,SNIFF_PRESTART_MIN) )
+        return;
+
+    //
+    // Full time of the start edge. If the timer wrapped but the overflow interrupt
+    //   hasn't run yet, a small capture value is after the wrap.
+    //
+    Wraps = Sniff.Wraps;
+    if( _BIT_ON(TIFR1,TOV1) && Time < 0x8000 )
+        Wraps++;
+    Sniff.Start = (((uint32_t) Wraps) << 16) | Time;
+
+    OCR1B = Time + SNIFF_END_TICKS;
+    TIFR1 = _PIN_MASK(OCF1B);
+    _SET_BIT(TIMSK1,OCIE1B);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Timer1 capture - One edge on the bus
+//
+// Look for the opposite edge next, per the line as it is now. If the line has already
+//   gone back, that edge came too soon to capture - use the timer.
+//
+ISR(TIMER1_CAPT_vect) {
+    uint16_t Time  = ICR1;
+    uint8_t  Level = _BIT_ON(TCCR1B,ICES1) ? 1 : 0;
+
+    if( SNIFF_LEVEL ) { _CLR_BIT(TCCR1B,ICES1); }
+    else              { _SET_BIT(TCCR1B,ICES1); }
+    TIFR1 = _PIN_MASK(ICF1);                    // Per datasheet, after changing ICES1
+
+    SniffEdge(Time,Level);
+    if( (SNIFF_LEVEL ? 1 : 0) != Level )
+        SniffEdge(TCNT1,!Level);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Timer1 compare B - Middle of the stop bit, byte is done
+//
+ISR(TIMER1_COMPB_vect) {
+    uint8_t  Type = SNIFF_BYTE;
+    uint16_t Wire;
+
+    _CLR_BIT(TIMSK1,OCIE1B);
+
+    Wire = CricketEdgeDone(&Sniff.Decode,OCR1B);
+
+    if( CRICKET_WIRE_FRAMING(Wire) )
+        Type |= SNIFF_FRAMING;
+    if( CRICKET_WIRE_COMMAND(Wire) )
+        Type |= SNIFF_COMMAND;
+
+    SniffPut(Type,CRICKET_WIRE_BYTE(Wire),Sniff.Start);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketSniffer.c - Passive cricket bus sniffer
+//
+// Inputs:      None. (Embedded program - no command line options)
+//
+// Outputs:     None. (Never returns)
+//
+int main(void) {
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    //
+    // Initialize things
+    //
+    memset(&Sniff,0,sizeof(Sniff));
+
+    UARTInit();
+
+    _CLR_BIT(_DDR (SNIFF_PORT),SNIFF_PIN);          // Input, no pullup: listen only
+    _CLR_BIT(_PORT(SNIFF_PORT),SNIFF_PIN);
+
+    Sniff.Decode.Phase = CRICKET_EDGE_IDLE;
+    Sniff.Decode.Level = SNIFF_LEVEL ? 1 : 0;
+
+    TCCR1A = 0;                                     // Normal mode, no pin outputs
+    TCCR1B = (1 << ICNC1) | (1 << CS11);            // Noise canceler, clk/8
+    if( Sniff.Decode.Level == 0 )
+        _SET_BIT(TCCR1B,ICES1);                     // Line low: rising edge next
+    TIFR1  = (1 << ICF1) | (1 << TOV1) | (1 << OCF1B);
+    TIMSK1 = (1 << ICIE1) | (1 << TOIE1);
+
+    sei();
+
+    SniffSend(SNIFF_RESET,SNIFF_FORMAT,0);
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    //
+    // Send records as they come in
+    //
+    while(1) {
+        SNIFF_RECORD Record;
+        uint8_t      Lost;
+
+        cli();
+        Lost       = Sniff.Lost;
+        Sniff.Lost = 0;
+        sei();
+
+        if( Lost ) {
+            uint32_t Now;
+
+            cli();
+            Now = (((uint32_t) Sniff.Wraps) << 16) | TCNT1;
+            sei();
+            SniffSend(SNIFF_LOST,Lost,Now);
+            }
+
+        if( Sniff.FIFO_In == Sniff.FIFO_Out )
+            continue;
+
+        cli();
+        Record         = Sniff.FIFO[Sniff.FIFO_Out];
+        Sniff.FIFO_Out = (Sniff.FIFO_Out+1) & SNIFF_FIFO_WRAP;
+        sei();
+
+        SniffSend(Record.Type,Record.Data,Record.Time);
+        }
+    }
@@ -0,0 +1,378 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      HostBus.c
+//
+//  SYNOPSIS
+//
+//      HostReset();                        // Resets the bus devices too
+//
+//      CricketLEDDec(1234,1);
+//      HostWait(10);
+//
+//      HostLED[1].Mode    == HOST_LED_NUMBER
+//      HostLED[1].Number  == 1234
+//      HostMotor[2].Speed, HostRelay.Mask  // Motor and relay boards
+//
+//      HostBus.Frames, HostBus.Errors      // Bus statistics
+//      HostBus.MaxErrNS                    // Worst bit edge timing error, in nS
+//      HostBus.Edges[]                     // Recent line transitions, time stamped
+//
+//  DESCRIPTION
+//
+//      Emulated cricket bus devices. See HostBus.h
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+
+#include "HostBus.h"
+#include "CricketBus.h"
+#include "CricketMotor.h"
+#include "CricketRelay.h"
+#include "PortMacros.h"
+
+#define BIT_CYCLES      (F_CPU/100000UL)                    // 10 uS
+#define PRESTART_CYCLES (BIT_CYCLES*(CRICKET_PRESTART_US/CRICKET_BIT_US))
+#define TOL_CYCLES      ((F_CPU/1000000UL)*HOST_BUS_TOL_NS/1000)
+#define CYCLES_NS(_c_)  ((uint32_t) ((_c_)*1000000000ULL/F_CPU))
+
+#define BYTE_BITS       11                                  // Start, 8 data, command, stop
+#define MAX_EDGES       16                                  // Per byte, more is an error
+
+typedef enum {
+    BUS_IDLE = 0,                           // Line high, waiting for a pre-start
+    BUS_PRESTART,                           // Line low, pre-start
+    BUS_BYTE,                               // Start bit seen, receiving the byte
+    } BUS_STATE;
+
+HOST_LED    HostLED[HOST_BUS_LEDS];
+HOST_MOTOR  HostMotor[CRICKET_MOTORS];
+HOST_RELAY  HostRelay;
+HOST_BUS    HostBus;
+
+static struct {
+    BUS_STATE   State;
+    uint64_t    LowAt;                      // Last falling edge
+    uint64_t    PreAt;                      // Pre-start edge
+    uint64_t    StartAt;                    // Start bit edge
+    uint8_t     Edge_Count;                 // Edges within the byte
+    HOST_EDGE   Edges[MAX_EDGES];
+    bool        Bad;                        // Byte has a timing error
+
+    uint8_t     Frame[8];                   // Frame so far
+    uint8_t     Frame_Len;
+    uint8_t     Frame_Need;                 // Length, once the device ID is in
+    uint64_t    Frame_At;
+    } Bus;
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Error - Count a dropped byte
+//
+static void Error(const char *Why) {
+
+    HostBus.Errors++;
+    HostBus.LastError = Why;
+    Bus.Frame_Len     = 0;                  // Devices resync on the next command byte
+    Bus.Frame_Need    = 0;
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// LEDFrame - An LED display frame arrived
+//
+// Inputs:      Frame: device, command + ID, data
+//
+// Outputs:     None.
+//
+static void LEDFrame(const uint8_t *Frame) {
+    uint8_t Command = Frame[1] & 0xE0;
+    uint8_t ID      = Frame[1] & 0x1F;
+    uint8_t Index;
+
+    for( Index = 1; Index < HOST_BUS_LEDS; Index++ ) {
+        HOST_LED *LED = &HostLED[Index];
+
+        if( ID != 0 && ID != Index )
+            continue;
+
+        switch( Command ) {
+
+            case CRICKET_LED_NUMBER:
+            case CRICKET_LED_HEX:
+                LED->Mode   = Command == CRICKET_LED_HEX ? HOST_LED_HEX : HOST_LED_NUMBER;
+                LED->Number = (Frame[2] << 8) | Frame[3];
+                break;
+
+            case CRICKET_LED_PAT:
+                LED->Mode = HOST_LED_PAT;
+                memcpy(LED->Pat,&Frame[2],sizeof(LED->Pat));
+                break;
+
+            case CRICKET_LED_BRIGHT:
+                LED->Bright = Frame[3];
+                break;
+            }
+
+        LED->Frames++;
+        }
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// FrameByte - Add a byte to the frame, and pass the frame on when complete
+//
+// Inputs:      Byte
+//              TRUE if command byte
+//
+// Outputs:     None.
+//
+static void FrameByte(uint8_t Byte,bool Command) {
+
+    if( Command ) {
+        Bus.Frame_Len  = 0;
+        Bus.Frame_Need = 0;
+        Bus.Frame_At   = Bus.PreAt;
+
+        switch( Byte ) {
+            case CRICKET_BUS_LED:   Bus.Frame_Need = 2; break;  // Length once cmd is in
+            case CRICKET_BUS_MOTOR: Bus.Frame_Need = CRICKET_MOTOR_FRAME; break;
+            case CRICKET_BUS_RELAY: Bus.Frame_Need = CRICKET_RELAY_FRAME; break;
+            default:                HostBus.Unknown++; return;
+            }
+        }
+    else if( Bus.Frame_Need == 0 )
+        return;                                         // Not ours, or no frame started
+
+    Bus.Frame[Bus.Frame_Len++] = Byte;
+
+    if( Bus.Frame_Len == 2 && Bus.Frame[0] == CRICKET_BUS_LED )
+        Bus.Frame_Need = 2 + ((Byte & 0xE0) == CRICKET_LED_PAT ? 4 : 2);
+
+    if( Bus.Frame_Len < Bus.Frame_Need )
+        return;
+
+    switch( Bus.Frame[0] ) {
+
+        case CRICKET_BUS_LED:
+            LEDFrame(Bus.Frame);
+            break;
+
+        case CRICKET_BUS_MOTOR: {
+            uint8_t Number = Bus.Frame[1] - CRICKET_MOTOR_SPEED;
+
+            if( Number < CRICKET_MOTORS ) {
+                HostMotor[Number].Speed = (int8_t) Bus.Frame[2];
+                HostMotor[Number].Frames++;
+                }
+            break;
+            }
+
+        case CRICKET_BUS_RELAY:
+            if( Bus.Frame[1] == CRICKET_RELAY_SET ) {
+                HostRelay.Mask = Bus.Frame[2];
+                HostRelay.Frames++;
+                }
+            break;
+        }
+
+    HostBus.Frames++;
+    HostBus.FrameStart = Bus.Frame_At;
+    HostBus.FrameEnd   = Bus.StartAt + BYTE_BITS*BIT_CYCLES;
+    Bus.Frame_Len      = 0;
+    Bus.Frame_Need     = 0;
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Sample - Return the line level in the middle of a bit cell
+//
+// Inputs:      Bit cell, 0 (start bit) to 10 (stop bit)
+//
+// Outputs:     Line level
+//
+static uint8_t Sample(uint8_t Cell) {
+    uint64_t At    = Bus.StartAt + Cell*BIT_CYCLES + BIT_CYCLES/2;
+    uint8_t  Level = 1;                                 // Start bit
+    uint8_t  Index;
+
+    for( Index = 0; Index < Bus.Edge_Count && Bus.Edges[Index].At <= At; Index++ )
+        Level = Bus.Edges[Index].Level;
+
+    return(Level);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// EndByte - The stop bit is over: decode the byte
+//
+static void EndByte(void) {
+    uint16_t Byte = 0;
+    uint8_t  Cell;
+    bool     Command;
+
+    Bus.State = BUS_IDLE;
+
+    if( Bus.Bad )
+        return;
+
+    for( Cell = 8; Cell >= 1; Cell-- )
+        Byte = (Byte << 1) | Sample(Cell);
+
+    Command = Sample(9) == 0;
+
+    if( Sample(10) == 0 ) {
+        Error("Low stop bit");
+        return;
+        }
+
+    HostBus.Log[HostBus.Log_Count & (HOST_BUS_LOG-1)] = (HOST_BYTE) { Byte, Command, Bus.PreAt };
+    HostBus.Log_Count++;
+    HostBus.Bytes++;
+
+    FrameByte(Byte,Command);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// HostBusSync - Time has passed with no change
+//
+// Inputs:      CPU cycle
+//
+// Outputs:     None.
+//
+void HostBusSync(uint64_t At) {
+
+    if( Bus.State == BUS_BYTE && At + TOL_CYCLES >= Bus.StartAt + BYTE_BITS*BIT_CYCLES )
+        EndByte();
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// HostBusEdge - The bus line changed
+//
+// Inputs:      CPU cycle
+//              New line level
+//
+// Outputs:     None.
+//
+void HostBusEdge(uint64_t At,uint8_t Level) {
+
+    HostBus.Edges[HostBus.Edge_Count & (HOST_BUS_EDGES-1)] = (HOST_EDGE) { At, Level };
+    HostBus.Edge_Count++;
+
+    HostBusSync(At);                                    // Finish the last byte, if over
+
+    if( Level == 0 )
+        Bus.LowAt = At;
+    else HostBus.LowCycles += At - Bus.LowAt;
+
+
+    switch( Bus.State ) {
+
+        case BUS_IDLE:
+            if( Level == 0 ) {
+                Bus.State = BUS_PRESTART;
+                Bus.PreAt = At;
+                }
+            break;
+
+        case BUS_PRESTART:
+            if( At - Bus.PreAt + TOL_CYCLES < PRESTART_CYCLES ) {
+                Error("Short pre-start");
+                Bus.State = BUS_IDLE;
+                break;
+                }
+            Bus.State      = BUS_BYTE;
+            Bus.StartAt    = At;
+            Bus.Edge_Count = 0;
+            Bus.Bad        = false;
+            break;
+
+        case BUS_BYTE: {
+            uint64_t Offset = At - Bus.StartAt;
+            uint64_t Cell   = (Offset + BIT_CYCLES/2)/BIT_CYCLES;
+            uint64_t Err    = Offset > Cell*BIT_CYCLES ? Offset - Cell*BIT_CYCLES : Cell*BIT_CYCLES - Offset;
+
+            if( Bus.Bad )
+                break;
+
+            if( CYCLES_NS(Err) > HostBus.MaxErrNS )
+                HostBus.MaxErrNS = CYCLES_NS(Err);
+
+            if( Err > TOL_CYCLES || Cell == 0 ) {
+                Error("Bit edge out of tolerance");
+                Bus.Bad = true;
+                break;
+                }
+
+            if( Bus.Edge_Count == MAX_EDGES ) {
+                Error("Too many edges");
+                Bus.Bad = true;
+                break;
+                }
+
+            Bus.Edges[Bus.Edge_Count++] = (HOST_EDGE) { At, Level };
+            break;
+            }
+        }
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// HostBusReset - Reset the bus devices and statistics
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void HostBusReset(void) {
+
+    memset(HostLED  ,0,sizeof(HostLED));
+    memset(HostMotor,0,sizeof(HostMotor));
+    memset(&HostRelay,0,sizeof(HostRelay));
+    memset(&HostBus ,0,sizeof(HostBus));
+    memset(&Bus     ,0,sizeof(Bus));
+    }
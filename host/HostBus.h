@@ -0,0 +1,194 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      HostBus.h - Emulated cricket bus devices
+//
+//  SYNOPSIS
+//
+//      HostReset();                        // Resets the bus devices too
+//
+//      CricketLEDDec(1234,1);
+//      HostWait(10);
+//
+//      HostLED[1].Mode    == HOST_LED_NUMBER
+//      HostLED[1].Number  == 1234
+//      HostMotor[2].Speed, HostRelay.Mask  // Motor and relay boards
+//
+//      HostBus.Frames, HostBus.Errors      // Bus statistics
+//      HostBus.MaxErrNS                    // Worst bit edge timing error, in nS
+//      HostBus.Edges[]                     // Recent line transitions, time stamped
+//
+//  DESCRIPTION
+//
+//      Emulated cricket bus devices for host builds: LED displays, motor boards and a
+//        relay board, listening to the bus line of the simulation in HostSim.c.
+//
+//      Each line transition is logged with its time stamp (in CPU cycles), then decoded
+//        the way a device would: a pre-start low of at least CRICKET_PRESTART_US, then
+//        the start bit, 8 data bits (LSB first), the command bit and the stop bit, each
+//        sampled in the middle of its cell. Every edge inside a byte must fall within
+//        HOST_BUS_TOL_NS of a cell boundary (counted from the start bit edge) or the
+//        byte is counted as an error and dropped, as is one with a low stop bit.
+//
+//      Bytes with the command bit (low) start a frame; the device ID byte says which
+//        device it's for and how long it is. Complete frames update the device state
+//        below, which is what a test looks at.
+//
+//      LED display ID 0 is all displays, so it updates every entry in HostLED[].
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef HOSTBUS_H
+#define HOSTBUS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "CricketMotor.h"
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// User configurable options
+//
+#ifndef HOST_BUS_TOL_NS
+#define HOST_BUS_TOL_NS     2000            // Bit edge tolerance, per device
+#endif
+
+#ifndef HOST_BUS_LEDS
+#define HOST_BUS_LEDS       4               // LED displays 1 - 3 (0 is all of them)
+#endif
+
+//
+// The edge and byte logs must be a power of two long, since the code uses a mask
+//   for wraparound.
+//
+#ifndef HOST_BUS_EDGES
+#define HOST_BUS_EDGES      (1 << 8)
+#endif
+
+#ifndef HOST_BUS_LOG
+#define HOST_BUS_LOG        (1 << 8)
+#endif
+
+//
+// End of user configurable options
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+typedef enum {
+    HOST_LED_BLANK = 0,                     // Nothing received yet
+    HOST_LED_NUMBER,                        // Showing Number in decimal
+    HOST_LED_HEX,                           // Showing Number in hex
+    HOST_LED_PAT,                           // Showing Pat[]
+    } HOST_LED_MODE;
+
+typedef struct {
+    HOST_LED_MODE   Mode;
+    uint16_t        Number;
+    uint8_t         Pat[4];
+    uint8_t         Bright;
+    uint32_t        Frames;                 // Frames received
+    } HOST_LED;
+
+typedef struct {
+    int8_t          Speed;
+    uint32_t        Frames;
+    } HOST_MOTOR;
+
+typedef struct {
+    uint8_t         Mask;
+    uint32_t        Frames;
+    } HOST_RELAY;
+
+typedef struct {
+    uint64_t        At;                     // CPU cycle
+    uint8_t         Level;
+    } HOST_EDGE;
+
+typedef struct {
+    uint8_t         Byte;
+    bool            Command;
+    uint64_t        At;                     // CPU cycle of the pre-start edge
+    } HOST_BYTE;
+
+typedef struct {
+    uint32_t        Bytes;                  // Bytes decoded
+    uint32_t        Frames;                 // Complete frames, any device
+    uint32_t        Unknown;                // Frames for devices not emulated
+    uint32_t        Errors;                 // Bytes dropped for timing or framing
+    uint32_t        MaxErrNS;               // Worst bit edge error seen
+    const char     *LastError;
+    uint64_t        FrameStart;             // Last complete frame, pre-start to stop bit
+    uint64_t        FrameEnd;
+    uint64_t        LowCycles;              // Total time the line was low
+
+    uint32_t        Edge_Count;             // Edges[Edge_Count & (HOST_BUS_EDGES-1)] is next
+    HOST_EDGE       Edges[HOST_BUS_EDGES];
+    uint32_t        Log_Count;              // Same for Log[]
+    HOST_BYTE       Log[HOST_BUS_LOG];
+    } HOST_BUS;
+
+extern HOST_LED     HostLED[HOST_BUS_LEDS];
+extern HOST_MOTOR   HostMotor[CRICKET_MOTORS];
+extern HOST_RELAY   HostRelay;
+extern HOST_BUS     HostBus;
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// HostBusReset - Reset the bus devices and statistics
+//
+// Called by HostReset().
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void HostBusReset(void);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// HostBusEdge - The bus line changed
+// HostBusSync - Time has passed with no change
+//
+// A byte isn't complete until its stop bit is over, which there's no edge to mark, so
+//   the simulation calls HostBusSync() to finish it off when time moves on.
+//
+// Inputs:      CPU cycle
+//              [HostBusEdge] New line level
+//
+// Outputs:     None.
+//
+void HostBusEdge(uint64_t At,uint8_t Level);
+void HostBusSync(uint64_t At);
+
+#endif  // HOSTBUS_H - entire file
@@ -0,0 +1,961 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      HostSim.c
+//
+//  SYNOPSIS
+//
+//      See HostSim.h
+//
+//  DESCRIPTION
+//
+//      See HostSim.h
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+
+#include <avr/io.h>
+
+#include "HostSim.h"
+#include "HostBus.h"
+#include "CricketBus.h"
+#include "PortMacros.h"
+
+#define SREG_I              0x80
+
+#define _HOST_REG(_r_,_x_)  _JOIN(_r_,_x_)              // Expands _x_ first
+#define HOST_BUS_PORT       _HOST_REG(HOST_PORT,CRICKET_BUS_PORT)
+#define HOST_BUS_DDR        _HOST_REG(HOST_DDR,CRICKET_BUS_PORT)
+#define HOST_BUS_PIN        _HOST_REG(HOST_PIN,CRICKET_BUS_PORT)
+
+//
+// Pin change group of the bus port, as on the ATmega328P
+//
+#define HOST_PCINT_B        0
+#define HOST_PCINT_C        1
+#define HOST_PCINT_D        2
+#define HOST_BUS_PCINT      _HOST_REG(HOST_PCINT_,CRICKET_BUS_PORT)
+#define HOST_BUS_PCMSK      (HOST_PCMSK0 + HOST_BUS_PCINT)
+
+#define HOST_DRIVE_WRAP     (HOST_LINE_DRIVES-1)        // Wraparound mask for Drives[]
+
+#define NEVER               UINT64_MAX
+
+//
+// Interrupt handlers, defined (or not) by ISR() in the code under test
+//
+#define HOST_VECT(_v_)      extern void HostVect_##_v_(void) __attribute__((weak));
+
+HOST_VECT(TIMER1_COMPA) HOST_VECT(TIMER1_COMPB) HOST_VECT(TIMER1_OVF)
+HOST_VECT(TIMER0_COMPA) HOST_VECT(TIMER0_COMPB) HOST_VECT(TIMER0_OVF)
+HOST_VECT(USART_RX)     HOST_VECT(USART_UDRE)   HOST_VECT(USART_TX)
+HOST_VECT(PCINT0)       HOST_VECT(PCINT1)       HOST_VECT(PCINT2)
+
+//
+// Interrupt sources, in priority order
+//
+typedef struct {
+    const char *Name;
+    uint8_t     FlagReg;                    // Flag register and bit
+    uint8_t     FlagBit;
+    uint8_t     MaskReg;                    // Enable register and bit
+    uint8_t     MaskBit;
+    bool        Clear;                      // TRUE if taking the interrupt clears the flag
+    } VECTOR;
+
+static const uint8_t LatchRegs[] = { HOST_TIFR0, HOST_TIFR1, HOST_TIFR2, HOST_PCIFR,
+                                     HOST_EIFR,  HOST_TCCR1C, HOST_UDR0 };
+
+uint8_t HostReg[0x100] __attribute__((aligned(2)));
+
+static struct {
+    uint64_t    Cycles;                     // Virtual CPU clock
+    uint64_t    HookAt;                     // When the code last touched the simulation
+    uint16_t    Latch[0x100];               // Write-detect images, per avr/io.h
+    uint8_t     Line;                       // Bus line, as last seen
+    uint8_t     Pull;                       // 0 if a device is pulling the line low
+    uint8_t     OC1A;                       // Timer1 compare output pins
+    uint8_t     OC1B;
+
+    uint64_t    Limit;                      // HostRun time limit
+    bool        Limited;
+    jmp_buf     Jump;
+
+    uint32_t    Interrupts;
+    uint32_t    Sleeps;
+    uint64_t    SleepCycles;
+
+    bool        TxBusy;                     // Shifter busy
+    bool        TxFull;                     // Data register full
+    uint8_t     TxShift;
+    uint8_t     TxData;
+    uint64_t    TxDone;                     // When the shifter finishes
+    uint8_t     RxData;
+    uint64_t    RxNext;                     // When the next input char arrives
+    char        In[HOST_UART_IN];
+    uint16_t    In_Len;
+    uint16_t    In_Pos;
+    char        Out[HOST_UART_OUT+1];
+    uint32_t    Out_Len;
+    bool        Echo;
+
+    HOST_EDGE   Drives[HOST_LINE_DRIVES];   // Device drives, in time order
+    uint16_t    Drive_In;
+    uint16_t    Drive_Out;
+    } Sim;
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Get16, Set16 - 16-bit register access
+//
+static uint16_t Get16(uint8_t Addr)            { return(HostReg[Addr] | (HostReg[Addr+1] << 8)); }
+static void     Set16(uint8_t Addr,uint16_t V) { HostReg[Addr] = V & 0xFF; HostReg[Addr+1] = V >> 8; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Fail - Report a condition the chip would go off the rails on, and quit
+//
+// Inputs:      What happened
+//
+// Outputs:     None. (Exits)
+//
+static void Fail(const char *What) {
+
+    fprintf(stderr,"HostSim: %s at %.3f mS\n",What,HostMS());
+    exit(2);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Line - Return the bus line level
+//
+// An input floats high (idle). An output is driven by the compare unit whenever a
+//   COM1x mode is set, else by the port. (On the chip the OCR driver's bus pin is the
+//   compare pin, which the host build doesn't insist on.) Either way, a device
+//   pulling the line low wins.
+//
+// Inputs:      None.
+//
+// Outputs:     Line level, 0 or 1
+//
+static uint8_t Line(void) {
+
+    if( !(HostReg[HOST_BUS_DDR] & _BV(CRICKET_BUS_PIN)) )
+        return(Sim.Pull);
+
+    if( HostReg[HOST_TCCR1A] & (_BV(COM1A1) | _BV(COM1A0)) )
+        return(Sim.OC1A & Sim.Pull);
+
+    if( HostReg[HOST_TCCR1A] & (_BV(COM1B1) | _BV(COM1B0)) )
+        return(Sim.OC1B & Sim.Pull);
+
+    return(HostReg[HOST_BUS_PORT] & _BV(CRICKET_BUS_PIN) ? Sim.Pull : 0);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CheckLine - Pass a change in the bus line to the bus devices
+//
+// The change also flags the bus pin's pin change interrupt, if its mask bit is set.
+//
+// Inputs:      When the change happened
+//
+// Outputs:     None.
+//
+static void CheckLine(uint64_t At) {
+    uint8_t Level = Line();
+
+    if( Level == Sim.Line )
+        return;
+
+    Sim.Line = Level;
+    HostBusEdge(At,Level);
+
+    if( HostReg[HOST_BUS_PCMSK] & _BV(CRICKET_BUS_PIN) )
+        HostReg[HOST_PCIFR] |= _BV(HOST_BUS_PCINT);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CompareOut - Apply a Timer1 compare output mode to its pin
+//
+// Inputs:      Pin
+//              COM1x1:0 mode
+//
+// Outputs:     None.
+//
+static void CompareOut(uint8_t *Pin,uint8_t Mode) {
+
+    switch( Mode ) {
+        case 1: *Pin ^= 1; break;                       // Toggle
+        case 2: *Pin  = 0; break;                       // Clear
+        case 3: *Pin  = 1; break;                       // Set
+        }
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// UARTCharCycles - Return CPU cycles per UART char (start, 8 data, stop)
+//
+static uint64_t UARTCharCycles(void) {
+    uint16_t UBRR = Get16(HOST_UBRR0) & 0x0FFF;
+
+    return(10ULL*(HostReg[HOST_UCSR0A] & _BV(U2X0) ? 8 : 16)*(UBRR+1));
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// UARTWrite - The code wrote UDR0
+//
+// Inputs:      Byte written
+//
+// Outputs:     None.
+//
+static void UARTWrite(uint8_t Byte) {
+
+    if( !(HostReg[HOST_UCSR0B] & _BV(TXEN0)) )
+        return;
+
+    if( !Sim.TxBusy ) {
+        Sim.TxShift = Byte;                             // Straight to the shifter
+        Sim.TxBusy  = true;
+        Sim.TxDone  = Sim.Cycles + UARTCharCycles();
+        HostReg[HOST_UCSR0A] &= ~_BV(TXC0);
+        }
+    else if( !Sim.TxFull ) {
+        Sim.TxData = Byte;
+        Sim.TxFull = true;
+        HostReg[HOST_UCSR0A] &= ~_BV(UDRE0);
+        }
+    else Fail("UDR0 written while full");
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Absorb - Take in what the code did since it last touched the simulation
+//
+// Writes to the write-detect registers are acted on, and a change in the bus line is
+//   passed on, timed at the last touch (when the code got the register it wrote).
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+static void Absorb(void) {
+    uint8_t Index;
+
+    for( Index = 0; Index < sizeof(LatchRegs); Index++ ) {
+        uint8_t  Addr  = LatchRegs[Index];
+        uint16_t Value = Sim.Latch[Addr];
+
+        if( Value >= 0x100 )
+            continue;                                   // Not written
+
+        switch( Addr ) {
+
+            case HOST_TCCR1C:
+                if( Value & _BV(FOC1A) )
+                    CompareOut(&Sim.OC1A,HostReg[HOST_TCCR1A] >> COM1A0 & 3);
+                if( Value & _BV(FOC1B) )
+                    CompareOut(&Sim.OC1B,HostReg[HOST_TCCR1A] >> COM1B0 & 3);
+                break;
+
+            case HOST_UDR0:
+                UARTWrite(Value);
+                break;
+
+            default:
+                HostReg[Addr] &= ~Value;                // Write one to clear
+                break;
+            }
+        }
+
+    CheckLine(Sim.HookAt);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Refill - Set up the write-detect images for the code's next access
+//
+static void Refill(void) {
+    uint8_t Index;
+
+    for( Index = 0; Index < sizeof(LatchRegs); Index++ ) {
+        uint8_t Addr = LatchRegs[Index];
+
+        Sim.Latch[Addr] = 0xFF00 | (Addr == HOST_UDR0 ? Sim.RxData : HostReg[Addr]);
+        }
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Timer state: count, period and prescaler, for whichever timer
+//
+typedef struct {
+    uint32_t    Count;
+    uint32_t    Period;                     // Counts per cycle of the counter
+    uint32_t    Prescale;                   // CPU cycles per count, zero if stopped
+    uint32_t    OCRA;
+    uint32_t    OCRB;
+    bool        CTC;                        // Clear on compare A
+    } TIMER;
+
+static uint32_t Prescale(uint8_t CS) {
+    static const uint16_t Div[8] = { 0, 1, 8, 64, 256, 1024, 0, 0 };
+
+    return(Div[CS & 7]);
+    }
+
+static void Timer0(TIMER *T) {
+    T->Count    = HostReg[HOST_TCNT0];
+    T->OCRA     = HostReg[HOST_OCR0A];
+    T->OCRB     = HostReg[HOST_OCR0B];
+    T->CTC      = (HostReg[HOST_TCCR0A] & 3) == 2;
+    T->Period   = T->CTC && T->Count <= T->OCRA ? T->OCRA+1 : 0x100;
+    T->Prescale = Prescale(HostReg[HOST_TCCR0B]);
+    }
+
+static void Timer1(TIMER *T) {
+    T->Count    = Get16(HOST_TCNT1);
+    T->OCRA     = Get16(HOST_OCR1A);
+    T->OCRB     = Get16(HOST_OCR1B);
+    T->CTC      = (HostReg[HOST_TCCR1B] & (_BV(WGM13) | _BV(WGM12))) == _BV(WGM12) &&
+                  (HostReg[HOST_TCCR1A] & 3) == 0;
+    T->Period   = T->CTC && T->Count <= T->OCRA ? T->OCRA+1 : 0x10000;
+    T->Prescale = Prescale(HostReg[HOST_TCCR1B]);
+    }
+
+//
+// Counts until the timer next reaches Value, 1 to Period (never, if out of range)
+//
+static uint32_t CountsTo(const TIMER *T,uint32_t Value) {
+    uint32_t Counts;
+
+    if( Value >= T->Period )
+        return(UINT32_MAX);
+
+    Counts = (Value + T->Period - T->Count) % T->Period;
+
+    return(Counts ? Counts : T->Period);
+    }
+
+//
+// Counts until the timer's next event: compare A, compare B, or overflow
+//
+static uint32_t NextCounts(const TIMER *T) {
+    uint32_t Counts = CountsTo(T,T->OCRA);
+    uint32_t B      = CountsTo(T,T->OCRB);
+
+    if( B < Counts )
+        Counts = B;
+
+    if( !T->CTC && T->Period - T->Count < Counts )
+        Counts = T->Period - T->Count;                  // Overflow, to zero
+
+    return(Counts);
+    }
+
+//
+// CPU cycle at which the timer has counted Counts more times
+//
+static uint64_t CountCycle(const TIMER *T,uint32_t Counts) {
+
+    if( T->Prescale == 0 || Counts == UINT32_MAX )
+        return(NEVER);
+
+    return((Sim.Cycles/T->Prescale + Counts)*T->Prescale);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// NextEvent - Return when the next timer, UART or line drive event happens
+//
+// Inputs:      None.
+//
+// Outputs:     CPU cycle of the next event, NEVER if none
+//
+static uint64_t NextEvent(void) {
+    TIMER    T;
+    uint64_t Next = NEVER;
+    uint64_t At;
+
+    Timer0(&T);
+    At = CountCycle(&T,NextCounts(&T));
+    if( At < Next ) Next = At;
+
+    Timer1(&T);
+    At = CountCycle(&T,NextCounts(&T));
+    if( At < Next ) Next = At;
+
+    if( Sim.TxBusy && Sim.TxDone < Next )
+        Next = Sim.TxDone;
+
+    if( Sim.In_Pos < Sim.In_Len && (HostReg[HOST_UCSR0B] & _BV(RXEN0)) && Sim.RxNext < Next )
+        Next = Sim.RxNext;
+
+    if( Sim.Drive_Out != Sim.Drive_In && Sim.Drives[Sim.Drive_Out].At < Next )
+        Next = Sim.Drives[Sim.Drive_Out].At;
+
+    return(Next);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// StepTimer - Advance a timer to a new time, and set flags for the events it hit
+//
+// The new time is never past the timer's next event, so only the last count can be one.
+//
+// Inputs:      Timer
+//              New CPU cycle
+//              Flag register, and overflow, compare A and compare B flag bits
+//
+// Outputs:     Event bits (1 << 0: overflow, 1: compare A, 2: compare B)
+//
+static uint8_t StepTimer(TIMER *T,uint64_t To,uint8_t FlagReg) {
+    uint32_t Counts;
+    uint8_t  Events = 0;
+
+    if( T->Prescale == 0 )
+        return(0);
+
+    Counts = To/T->Prescale - Sim.Cycles/T->Prescale;
+
+    if( Counts == 0 )
+        return(0);
+
+    if( Counts == CountsTo(T,T->OCRA) ) Events |= _BV(OCF1A);
+    if( Counts == CountsTo(T,T->OCRB) ) Events |= _BV(OCF1B);
+    if( !T->CTC && Counts == T->Period - T->Count ) Events |= _BV(TOV1);
+
+    T->Count = (T->Count + Counts) % T->Period;
+
+    HostReg[FlagReg] |= Events;
+
+    return(Events);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Step - Advance the clock to a time no later than the next event
+//
+// Inputs:      New CPU cycle
+//
+// Outputs:     None.
+//
+static void Step(uint64_t To) {
+    TIMER   T;
+    uint8_t Events;
+
+    Timer0(&T);
+    StepTimer(&T,To,HOST_TIFR0);
+    HostReg[HOST_TCNT0] = T.Count;
+
+    Timer1(&T);
+    Events = StepTimer(&T,To,HOST_TIFR1);
+    Set16(HOST_TCNT1,T.Count);
+
+    Sim.Cycles = To;
+
+    if( Events & _BV(OCF1A) ) CompareOut(&Sim.OC1A,HostReg[HOST_TCCR1A] >> COM1A0 & 3);
+    if( Events & _BV(OCF1B) ) CompareOut(&Sim.OC1B,HostReg[HOST_TCCR1A] >> COM1B0 & 3);
+
+    while( Sim.Drive_Out != Sim.Drive_In && Sim.Drives[Sim.Drive_Out].At <= To ) {
+        Sim.Pull      = Sim.Drives[Sim.Drive_Out].Level;
+        Sim.Drive_Out = (Sim.Drive_Out+1) & HOST_DRIVE_WRAP;
+        }
+    CheckLine(To);
+
+    //
+    // UART: shifter done, on to the next char (if any)
+    //
+    if( Sim.TxBusy && Sim.TxDone == To ) {
+        if( Sim.Out_Len < HOST_UART_OUT )
+            Sim.Out[Sim.Out_Len++] = Sim.TxShift;
+        if( Sim.Echo )
+            putchar(Sim.TxShift);
+
+        if( Sim.TxFull ) {
+            Sim.TxShift = Sim.TxData;
+            Sim.TxFull  = false;
+            Sim.TxDone += UARTCharCycles();
+            HostReg[HOST_UCSR0A] |= _BV(UDRE0);
+            }
+        else {
+            Sim.TxBusy = false;
+            HostReg[HOST_UCSR0A] |= _BV(TXC0);
+            }
+        }
+
+    if( Sim.In_Pos < Sim.In_Len && (HostReg[HOST_UCSR0B] & _BV(RXEN0)) && Sim.RxNext == To ) {
+        if( HostReg[HOST_UCSR0A] & _BV(RXC0) )
+            HostReg[HOST_UCSR0A] |= _BV(DOR0);          // Overrun, previous char lost
+        Sim.RxData  = Sim.In[Sim.In_Pos++];
+        Sim.RxNext += UARTCharCycles();
+        HostReg[HOST_UCSR0A] |= _BV(RXC0);
+        }
+
+    if( Sim.Limited && Sim.Cycles >= Sim.Limit )
+        longjmp(Sim.Jump,1);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Pending - Return the highest priority interrupt that's flagged and enabled
+//
+// Inputs:      TRUE to take it (clear its flag, if that's what the chip does)
+//
+// Outputs:     Handler, NULL if none
+//
+static void (*Pending(bool Take))(void) {
+    static const VECTOR Vectors[] = {
+        { "PCINT0",       HOST_PCIFR,  PCIF0, HOST_PCICR,  PCIE0,  true  },
+        { "PCINT1",       HOST_PCIFR,  PCIF1, HOST_PCICR,  PCIE1,  true  },
+        { "PCINT2",       HOST_PCIFR,  PCIF2, HOST_PCICR,  PCIE2,  true  },
+        { "TIMER1_COMPA", HOST_TIFR1,  OCF1A, HOST_TIMSK1, OCIE1A, true  },
+        { "TIMER1_COMPB", HOST_TIFR1,  OCF1B, HOST_TIMSK1, OCIE1B, true  },
+        { "TIMER1_OVF",   HOST_TIFR1,  TOV1,  HOST_TIMSK1, TOIE1,  true  },
+        { "TIMER0_COMPA", HOST_TIFR0,  OCF0A, HOST_TIMSK0, OCIE0A, true  },
+        { "TIMER0_COMPB", HOST_TIFR0,  OCF0B, HOST_TIMSK0, OCIE0B, true  },
+        { "TIMER0_OVF",   HOST_TIFR0,  TOV0,  HOST_TIMSK0, TOIE0,  true  },
+        { "USART_RX",     HOST_UCSR0A, RXC0,  HOST_UCSR0B, RXCIE0, true  },
+        { "USART_UDRE",   HOST_UCSR0A, UDRE0, HOST_UCSR0B, UDRIE0, false },
+        { "USART_TX",     HOST_UCSR0A, TXC0,  HOST_UCSR0B, TXCIE0, true  },
+        };
+    void  (*Fns[])(void) = { HostVect_PCINT0,       HostVect_PCINT1,       HostVect_PCINT2,
+                             HostVect_TIMER1_COMPA, HostVect_TIMER1_COMPB, HostVect_TIMER1_OVF,
+                             HostVect_TIMER0_COMPA, HostVect_TIMER0_COMPB, HostVect_TIMER0_OVF,
+                             HostVect_USART_RX,     HostVect_USART_UDRE,   HostVect_USART_TX };
+    uint8_t Index;
+
+    for( Index = 0; Index < NUMOF(Vectors); Index++ ) {
+        const VECTOR *V = &Vectors[Index];
+
+        if( !(HostReg[V->FlagReg] & _BV(V->FlagBit)) || !(HostReg[V->MaskReg] & _BV(V->MaskBit)) )
+            continue;
+
+        if( Fns[Index] == NULL ) {
+            char What[64];
+
+            sprintf(What,"%s interrupt enabled with no handler",V->Name);
+            Fail(What);
+            }
+
+        //
+        // Timer flags clear when the interrupt is taken. On the chip RXC clears when the
+        //   handler reads UDR0, which every Rx handler does, so it's cleared here too.
+        //
+        if( Take && V->Clear )
+            HostReg[V->FlagReg] &= ~_BV(V->FlagBit);
+
+        return(Fns[Index]);
+        }
+
+    return(NULL);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Dispatch - Take pending interrupts, if enabled
+//
+// Inputs:      None.
+//
+// Outputs:     TRUE if any were taken
+//
+static void Run(uint64_t Cycles);
+
+static bool Dispatch(void) {
+    void (*Fn)(void);
+    bool Taken = false;
+
+    while( (HostReg[HOST_SREG] & SREG_I) && (Fn = Pending(true)) != NULL ) {
+        HostReg[HOST_SREG] &= ~SREG_I;
+        Refill();
+        Run(HOST_ISR_CYCLES);
+        Sim.HookAt = Sim.Cycles;
+        Fn();
+        Absorb();
+        Sim.HookAt = Sim.Cycles;
+        HostReg[HOST_SREG] |= SREG_I;                   // RETI
+        Sim.Interrupts++;
+        Taken = true;
+        }
+
+    Refill();
+
+    return(Taken);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Run - The code runs for a number of CPU cycles
+//
+// Interrupts taken along the way add their own time, as on the chip.
+//
+// Inputs:      CPU cycles
+//
+// Outputs:     None.
+//
+static void Run(uint64_t Cycles) {
+
+    while(1) {
+        uint64_t Next;
+
+        Dispatch();
+
+        if( Cycles == 0 )
+            break;
+
+        Next = NextEvent();
+
+        if( Next > Sim.Cycles + Cycles )
+            Next = Sim.Cycles + Cycles;
+
+        if( Sim.Limited && Next > Sim.Limit )
+            Next = Sim.Limit;
+
+        Cycles -= Next - Sim.Cycles;
+        Step(Next);
+        }
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Hook - The code touched the simulation: catch up, and charge it some time
+//
+// Inputs:      CPU cycles to charge
+//
+// Outputs:     None.
+//
+static void Hook(uint32_t Cycles) {
+
+    Absorb();
+    Run(Cycles);
+    Sim.HookAt = Sim.Cycles;
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// HostIO      - Return a register, for the code to read or write
+// HostLatchIO - Return the write-detect image of a register
+//
+// Inputs:      Register address
+//
+// Outputs:     Where to read or write it
+//
+void *HostIO(uint8_t Addr) {
+
+    Hook(HOST_IO_CYCLES);
+
+    //
+    // Input pins: outputs read back, inputs (the bus line, too) read the line
+    //
+    if( Addr == HOST_PINB || Addr == HOST_PINC || Addr == HOST_PIND ) {
+        uint8_t DDR = HostReg[Addr+1];
+
+        HostReg[Addr] = (HostReg[Addr+2] & DDR) | ~DDR;
+
+        if( Addr == HOST_BUS_PIN ) {
+            HostReg[Addr] &= ~_BV(CRICKET_BUS_PIN);
+            HostReg[Addr] |= Line() << CRICKET_BUS_PIN;
+            }
+        }
+
+    return(&HostReg[Addr]);
+    }
+
+void *HostLatchIO(uint8_t Addr) {
+
+    Hook(HOST_IO_CYCLES);
+
+    return(&Sim.Latch[Addr]);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// HostCli - Disable interrupts
+// HostSei - Enable interrupts, taking any pending one after the next instruction
+//
+void HostCli(void) {
+
+    Hook(1);
+    HostReg[HOST_SREG] &= ~SREG_I;
+    }
+
+void HostSei(void) {
+
+    Hook(1);
+    HostReg[HOST_SREG] |= SREG_I;
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// HostDelay - Busy wait a number of CPU cycles
+//
+// Inputs:      CPU cycles (rounded to the nearest)
+//
+// Outputs:     None.
+//
+void HostDelay(double Cycles) {
+
+    Hook((uint64_t) (Cycles + 0.5));
+    HostBusSync(Sim.Cycles);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// HostSleep - Sleep until an interrupt
+//
+// As on the chip, this does nothing unless sleep is enabled, and an interrupt that's
+//   already pending wakes it right away.
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void HostSleep(void) {
+    uint64_t Start;
+
+    Hook(1);
+
+    if( !(HostReg[HOST_SMCR] & _BV(SE)) )
+        return;
+
+    Sim.Sleeps++;
+    Start = Sim.Cycles;
+
+    while( !(HostReg[HOST_SREG] & SREG_I) || Pending(false) == NULL ) {
+        uint64_t Next = NextEvent();
+
+        if( Sim.Limited && Next > Sim.Limit )
+            Next = Sim.Limit;
+
+        if( Next == NEVER )
+            Fail("asleep with no interrupt to wake up");
+
+        Step(Next);
+        }
+
+    Sim.SleepCycles += Sim.Cycles - Start;
+    Dispatch();
+    Sim.HookAt = Sim.Cycles;
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// __cyg_profile_func_enter - Charge each function call in the code under test
+// __cyg_profile_func_exit
+//
+// Called by -finstrument-functions code. This file is built without it.
+//
+void __cyg_profile_func_enter(void *Fn,void *Site) { Hook(HOST_CALL_CYCLES); }
+void __cyg_profile_func_exit (void *Fn,void *Site) {}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// HostReset - Power on
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void HostReset(void) {
+
+    memset(HostReg,0,sizeof(HostReg));
+    memset(&Sim,0,sizeof(Sim));
+
+    HostReg[HOST_UCSR0A] = _BV(UDRE0);
+    HostReg[HOST_UCSR0C] = _BV(UCSZ01) | _BV(UCSZ00);
+    Set16(HOST_SP,0x08FF);
+
+    Sim.Line = 1;
+    Sim.Pull = 1;
+    Refill();
+
+    HostBusReset();
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// HostCycles  - Return the virtual CPU clock, in cycles since HostReset
+// HostMS      - Return the virtual CPU clock, in mS since HostReset
+// HostStats   - Return simulation counts
+//
+uint64_t HostCycles(void) { return(Sim.Cycles); }
+double   HostMS(void)     { return(Sim.Cycles/HOST_CYCLES_MS); }
+
+void HostStats(uint32_t *Interrupts,uint32_t *Sleeps,uint64_t *SleepCycles) {
+
+    *Interrupts  = Sim.Interrupts;
+    *Sleeps      = Sim.Sleeps;
+    *SleepCycles = Sim.SleepCycles;
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// HostWait - Let virtual time pass, as in a delay
+// HostRun  - Run a function for at most a set virtual time
+//
+// HostRun leaves the function by longjmp() when the time is up, wherever it is (even
+//   in an interrupt handler), so interrupts are left however they were just then.
+//
+// Inputs:      [HostRun] Function to run
+//              Virtual time, in mS
+//
+// Outputs:     [HostRun] TRUE  if the function returned
+//                        FALSE if the time ran out first
+//
+void HostWait(double MS) { HostDelay(MS*HOST_CYCLES_MS); }
+
+bool HostRun(void (*Fn)(void),double MS) {
+
+    Sim.Limit   = Sim.Cycles + (uint64_t) (MS*HOST_CYCLES_MS + 0.5);
+    Sim.Limited = true;
+
+    if( setjmp(Sim.Jump) == 0 ) {
+        Fn();
+        Sim.Limited = false;
+        return(true);
+        }
+
+    Sim.Limited = false;
+    Sim.HookAt  = Sim.Cycles;
+    HostBusSync(Sim.Cycles);
+
+    return(false);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// HostUARTOutput - Return everything sent out the UART, as a string
+// HostUARTClear  - Forget the UART output so far
+// HostUARTInput  - Queue text for the UART receiver, one char per char time
+// HostUARTEcho   - Copy UART output to stdout as it's sent
+//
+const char *HostUARTOutput(void) {
+
+    Sim.Out[Sim.Out_Len] = 0;
+
+    return(Sim.Out);
+    }
+
+void HostUARTClear(void) { Sim.Out_Len = 0; }
+
+void HostUARTEcho(bool Echo) { Sim.Echo = Echo; }
+
+void HostUARTInput(const char *Text) {
+
+    if( Sim.In_Pos == Sim.In_Len ) {
+        Sim.In_Pos = Sim.In_Len = 0;
+        Sim.RxNext = Sim.Cycles + UARTCharCycles();
+        }
+
+    while( *Text && Sim.In_Len < HOST_UART_IN )
+        Sim.In[Sim.In_Len++] = *Text++;
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// HostLineDrive - A bus device drives the line, some time from now
+//
+// Inputs:      Time from now, in uS
+//              0 to pull the line low, 1 to let it go
+//
+// Outputs:     None.
+//
+void HostLineDrive(double US,uint8_t Level) {
+    uint16_t NewIn = (Sim.Drive_In+1) & HOST_DRIVE_WRAP;
+    uint64_t At    = Sim.Cycles + (uint64_t) (US*HOST_CYCLES_MS/1000.0 + 0.5);
+
+    if( NewIn == Sim.Drive_Out )
+        Fail("line drive queue full");
+
+    if( Sim.Drive_Out != Sim.Drive_In && At < Sim.Drives[(Sim.Drive_In-1) & HOST_DRIVE_WRAP].At )
+        Fail("line drives out of order");
+
+    Sim.Drives[Sim.Drive_In].At    = At;
+    Sim.Drives[Sim.Drive_In].Level = Level ? 1 : 0;
+    Sim.Drive_In = NewIn;
+    }
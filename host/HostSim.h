@@ -0,0 +1,230 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      HostSim.h - Virtual-time AVR simulation for host builds
+//
+//  SYNOPSIS
+//
+//      //////////////////////////////////////
+//      //
+//      // Host build: -I host ahead of lib, so that <avr/io.h> &c are the ones here.
+//      //   Library code is built with -finstrument-functions (see host/Makefile).
+//      //
+//      HostReset();                        // Power on: registers, clock, bus devices
+//
+//      CricketBusInit();
+//      sei();
+//      CricketLEDDec(1234,1);
+//
+//      HostWait(10);                       // Run 10 mS of virtual time
+//
+//      HostRun(DemoMain,5000);             // Run a program for 5 virtual seconds
+//
+//      uint64_t Cycles = HostCycles();     // Virtual CPU clock
+//      const char *Out = HostUARTOutput(); // Everything sent out the UART
+//      HostUARTInput("Hello\r");           // Feed the UART receiver
+//
+//  DESCRIPTION
+//
+//      Virtual-time simulation of the parts of an ATmega328P that the library uses,
+//        for building and testing it on a Linux host.
+//
+//      There's no instruction set simulator: the library is compiled for the host, and
+//        time is charged as it runs. Each I/O register access costs HOST_IO_CYCLES,
+//        each function call HOST_CALL_CYCLES and each interrupt HOST_ISR_CYCLES, and
+//        the delay functions cost what they say. Those are the points where the
+//        simulation catches up: counters advance, interrupt flags are set, and if
+//        interrupts are enabled the handlers (the ISR() functions) are called.
+//        A loop that polls RAM without any calls or register accesses would never
+//        see time pass, but the library doesn't have any.
+//
+//      Simulated:
+//
+//        - Timer0 and Timer1, normal and CTC modes, every prescaler, compare and
+//            overflow interrupts, and the Timer1 compare output pins.
+//
+//        - USART0 transmit (double buffered, at the programmed baud rate) and
+//            receive, with the data register empty, Tx complete and Rx interrupts.
+//
+//        - SREG, cli()/sei(), and sleep (which skips ahead to the next interrupt).
+//
+//        - The cricket bus line: whichever of PORTx, OC1A or OC1B drives it. Each
+//            edge goes to the emulated bus devices (see HostBus.h). A test can play
+//            a device driving the line too (HostLineDrive), and the pin change
+//            interrupt for the bus pin sees every edge.
+//
+//      Not simulated: Timer2, input capture, pin change interrupts on other pins,
+//        external interrupts, SPI, TWI, the ADC and the watchdog. Their registers
+//        read and write as memory.
+//
+//      HostRun() runs a function (a whole program's main(), say) for a set virtual
+//        time, then returns even if the function didn't.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef HOSTSIM_H
+#define HOSTSIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// User configurable options
+//
+#ifndef HOST_IO_CYCLES
+#define HOST_IO_CYCLES      2               // CPU cycles per I/O register access
+#endif
+
+#ifndef HOST_CALL_CYCLES
+#define HOST_CALL_CYCLES    8               // CPU cycles per function call
+#endif
+
+#ifndef HOST_ISR_CYCLES
+#define HOST_ISR_CYCLES     10              // CPU cycles to enter and leave an interrupt
+#endif
+
+#ifndef HOST_UART_OUT
+#define HOST_UART_OUT       (1 << 16)       // UART output kept for HostUARTOutput()
+#endif
+
+#ifndef HOST_UART_IN
+#define HOST_UART_IN        256             // UART input waiting to be received
+#endif
+
+//
+// The line drive queue must be a power of two long, since the code uses a mask for
+//   wraparound.
+//
+#ifndef HOST_LINE_DRIVES
+#define HOST_LINE_DRIVES    (1 << 8)        // Device drives waiting to happen
+#endif
+
+//
+// End of user configurable options
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#define HOST_CYCLES_MS      (F_CPU/1000.0)  // Virtual CPU cycles per mS
+
+extern uint8_t HostReg[0x100];              // Register file, by data space address
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// HostReset - Power on
+//
+// Registers go to their reset values, the clock to zero, and the bus devices are reset.
+//   Library state isn't touched, so tests that need a fresh library run each in a
+//   process of its own (see HostTest.c).
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void HostReset(void);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// HostCycles  - Return the virtual CPU clock, in cycles since HostReset
+// HostMS      - Return the virtual CPU clock, in mS since HostReset
+// HostStats   - Return simulation counts
+//
+// Inputs:      [HostStats] Where to put interrupts taken, sleeps, and cycles spent asleep
+//
+// Outputs:     As above
+//
+uint64_t HostCycles(void);
+double   HostMS(void);
+void     HostStats(uint32_t *Interrupts,uint32_t *Sleeps,uint64_t *SleepCycles);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// HostWait - Let virtual time pass, as in a delay
+// HostRun  - Run a function for at most a set virtual time
+//
+// Inputs:      [HostRun] Function to run
+//              Virtual time, in mS
+//
+// Outputs:     [HostRun] TRUE  if the function returned
+//                        FALSE if the time ran out first
+//
+void HostWait(double MS);
+bool HostRun(void (*Fn)(void),double MS);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// HostUARTOutput - Return everything sent out the UART, as a string
+// HostUARTClear  - Forget the UART output so far
+// HostUARTInput  - Queue text for the UART receiver, one char per char time
+// HostUARTEcho   - Copy UART output to stdout as it's sent
+//
+// Inputs:      [HostUARTInput] Text to receive
+//              [HostUARTEcho]  TRUE to echo
+//
+// Outputs:     [HostUARTOutput] UART output since reset (or the last HostUARTClear)
+//
+const char *HostUARTOutput(void);
+void        HostUARTClear(void);
+void        HostUARTInput(const char *Text);
+void        HostUARTEcho(bool Echo);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// HostLineDrive - A bus device drives the line, some time from now
+//
+// The line is wired: a device pulling it low wins, and when nothing drives it (the
+//   pin is an input) it's pulled up. Queue the drives in time order.
+//
+// Inputs:      Time from now, in uS
+//              0 to pull the line low, 1 to let it go
+//
+// Outputs:     None.
+//
+void HostLineDrive(double US,uint8_t Level);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// For the register and library shims in host/avr and host/util. Not for tests.
+//
+void *HostIO(uint8_t Addr);
+void *HostLatchIO(uint8_t Addr);
+void  HostCli(void);
+void  HostSei(void);
+void  HostDelay(double Cycles);
+void  HostSleep(void);
+
+#endif  // HOSTSIM_H - entire file
@@ -0,0 +1,1223 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      HostTest.c - Host tests for the library
+//
+//  SYNOPSIS
+//
+//      make -C host test                   // Every test, on each bus driver
+//      make -C host DRIVER=2 run           // Just the OCR driver
+//
+//      drv1/HostTest                       // All tests
+//      drv1/HostTest LEDDec Demo           // Just these
+//      drv1/HostTest -v Demo               // Echo UART output to stdout
+//
+//  DESCRIPTION
+//
+//      Unit tests and benchmarks for the library, run on the host against the
+//        simulation in HostSim.c and the emulated bus devices in HostBus.c.
+//
+//      Each test runs in a process of its own (fork), so that it starts with fresh
+//        library state as well as a freshly reset simulation.
+//
+//      The demo (CricketLEDTest.c, main() renamed DemoMain) runs for 10 virtual seconds,
+//        with its display and UART output checked against what it should be doing.
+//
+//      The benchmark sends 1000 pattern frames and reports virtual time (what the
+//        chip would take) against host time.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+#include "HostSim.h"
+#include "HostBus.h"
+
+#include "UART.h"
+#include "Serial.h"
+#include "CricketBus.h"
+#include "CricketBusRx.h"
+#include "CricketLED.h"
+#include "CricketMotor.h"
+#include "CricketRelay.h"
+#include "CricketNumber.h"
+#include "CricketSync.h"
+#include "CricketSched.h"
+#include "CricketRamp.h"
+#include "CricketComp.h"
+#include "CricketAnim.h"
+#include "CricketMarquee.h"
+#include "CricketFade.h"
+#include "CricketDither.h"
+#include "CricketCanvas.h"
+#include "CricketScript.h"
+#include "CricketTask.h"
+#include "PortMacros.h"
+
+#if CRICKET_BUS_DRIVER == CRICKET_DRIVER_TIMER || CRICKET_BUS_DRIVER == CRICKET_DRIVER_OCR
+#include "CricketDeadline.h"
+#endif
+
+#define CYCLES_US           (F_CPU/1000000UL)
+#define BYTE_CYCLES         (CRICKET_BYTE_US*CYCLES_US)
+
+//
+// Worst bit edge error, and gap between the bytes of a frame, allowed by the tests.
+//   The queued drivers send back to back, within a handful of cycles. Host builds of
+//   the bit-bang driver get its C path, which drifts by the port write per bit and
+//   spends a little time between bytes.
+//
+#if CRICKET_BUS_DRIVER == CRICKET_DRIVER_BITBANG
+#define EDGE_NS             HOST_BUS_TOL_NS
+#define GAP_US              5
+#else
+#define EDGE_NS             250
+#define GAP_US              0
+#endif
+
+int DemoMain(void);
+
+static int  Fails;
+static bool Verbose;
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CHECK - Note a failed condition, and carry on
+//
+#define CHECK(_c_)  Check(_c_,#_c_,__LINE__)
+
+static void Check(bool OK,const char *What,int Line) {
+
+    if( OK )
+        return;
+
+    printf("    line %d: %s (at %.3f mS)\n",Line,What,HostMS());
+    Fails++;
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Start - Power on, and init the way an application would
+// Drain - Wait until the bus is done sending
+//
+static void Start(void) {
+
+    UARTInit();
+    CricketBusInit();
+    sei();
+    }
+
+static void Drain(void) {
+
+    while( CricketBusBusy() )
+        HostWait(0.1);
+
+    HostWait(0.5);                                      // Past the last stop bit
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// LED display tests
+//
+static void TestLEDDec(void) {
+
+    Start();
+    CricketLEDDec(1234,1);
+    Drain();
+
+    CHECK(HostLED[1].Mode   == HOST_LED_NUMBER);
+    CHECK(HostLED[1].Number == 1234);
+    CHECK(HostLED[1].Frames == 1);
+    CHECK(HostLED[2].Frames == 0);
+    CHECK(HostBus.Bytes     == 4);
+    CHECK(HostBus.Errors    == 0);
+    }
+
+static void TestLEDHex(void) {
+
+    Start();
+    CricketLEDHex(0xBEEF,0);
+    Drain();
+
+    CHECK(HostLED[1].Mode   == HOST_LED_HEX);
+    CHECK(HostLED[1].Number == 0xBEEF);
+    CHECK(HostLED[2].Mode   == HOST_LED_HEX);
+    CHECK(HostLED[2].Number == 0xBEEF);
+    CHECK(HostBus.Errors    == 0);
+    }
+
+static void TestLEDPat(void) {
+    static const uint8_t Pat[4] = { 0x01, 0x80, 0x55, 0xAA };
+
+    Start();
+    CricketLEDPat(Pat[0],Pat[1],Pat[2],Pat[3],2);
+    Drain();
+
+    CHECK(HostLED[2].Mode == HOST_LED_PAT);
+    CHECK(memcmp(HostLED[2].Pat,Pat,4) == 0);
+    CHECK(HostLED[1].Mode == HOST_LED_BLANK);
+    CHECK(HostBus.Bytes   == 6);
+    CHECK(HostBus.Errors  == 0);
+    }
+
+static void TestLEDBright(void) {
+
+    Start();
+    CricketLEDBright(5,1);
+    CricketLEDBright(2,2);
+    Drain();
+
+    CHECK(HostLED[1].Bright == 5);
+    CHECK(HostLED[2].Bright == 2);
+    CHECK(HostLED[1].Mode   == HOST_LED_BLANK);
+    CHECK(HostBus.Errors    == 0);
+    }
+
+static void TestLEDText(void) {
+    uint8_t Segs[4] = { 0 };
+
+    Start();
+    CricketLEDText("12.5",0x08,1);
+    Drain();
+
+    CricketFontText("12.5",Segs,sizeof(Segs));
+    Segs[3] |= 0x80;
+
+    CHECK(HostLED[1].Mode == HOST_LED_PAT);
+    CHECK(memcmp(HostLED[1].Pat,Segs,4) == 0);
+    CHECK(HostLED[1].Pat[1] & 0x80);
+    CHECK(HostBus.Errors  == 0);
+    }
+
+//
+// A repeat of what a display already shows isn't sent again, unless refreshed
+//
+static void TestLEDShadow(void) {
+
+    Start();
+    CricketLEDDec(42,1);
+    CricketLEDDec(42,1);
+    CricketLEDBright(3,1);
+    CricketLEDBright(3,1);
+    Drain();
+
+    CHECK(HostLED[1].Frames == 2);
+
+    CricketLEDRefresh(1);
+    Drain();
+
+    CHECK(HostLED[1].Frames == 4);
+    CHECK(HostLED[1].Number == 42);
+    CHECK(HostLED[1].Bright == 3);
+    CHECK(HostBus.Errors    == 0);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Bus tests
+//
+// A pattern frame is six bytes at spec timing, back to back.
+//
+static void TestBusTiming(void) {
+    uint64_t Length;
+
+    Start();
+    CricketLEDPat(1,2,3,4,1);
+    Drain();
+
+    Length = HostBus.FrameEnd - HostBus.FrameStart;
+
+    CHECK(HostBus.Frames == 1);
+    CHECK(HostBus.Errors == 0);
+    CHECK(HostBus.MaxErrNS <= EDGE_NS);
+    CHECK(Length >= 6*BYTE_CYCLES - CYCLES_US);
+    CHECK(Length <= 6*BYTE_CYCLES + (2 + 6*GAP_US)*CYCLES_US);
+
+    if( Verbose )
+        printf("    frame %.2f uS, worst edge %u nS\n",(double) Length/CYCLES_US,HostBus.MaxErrNS);
+    }
+
+//
+// More frames than the FIFO holds: CricketBusPutW waits, and nothing is lost
+//
+static void TestBusFIFO(void) {
+    uint8_t Frame;
+    bool    InOrder = true;
+
+    Start();
+
+    for( Frame = 0; Frame < 20; Frame++ )
+        CricketLEDPat(Frame,0,0,Frame,1);
+
+    Drain();
+
+    for( Frame = 0; Frame < 20; Frame++ ) {
+        const HOST_BYTE *Byte = &HostBus.Log[(Frame*6 + 2) & (HOST_BUS_LOG-1)];
+
+        if( Byte->Byte != Frame || Byte->Command )
+            InOrder = false;
+        }
+
+    CHECK(HostLED[1].Frames == 20);
+    CHECK(HostLED[1].Pat[0] == 19);
+    CHECK(HostBus.Bytes     == 20*6);
+    CHECK(InOrder);
+    CHECK(HostBus.Errors    == 0);
+    }
+
+static void TestMotorRelay(void) {
+
+    Start();
+    CricketMotorSet(2,-50);
+    CricketMotorSet(0,100);
+    CricketRelaySet(0xA5);
+
+    while( CricketMotorPending() || CricketRelayPending() ) {
+        CricketMotorService();
+        CricketRelayService();
+        HostWait(0.1);
+        }
+
+    Drain();
+
+    CHECK(HostMotor[2].Speed  == -50);
+    CHECK(HostMotor[0].Speed  == 100);
+    CHECK(HostMotor[1].Frames == 0);
+    CHECK(HostRelay.Mask      == 0xA5);
+    CHECK(HostBus.Unknown     == 0);
+    CHECK(HostBus.Errors      == 0);
+    }
+
+
+//
+// Motor and relay frames still go out while a display loop keeps the bus FIFO full:
+//   CricketBusPutW leaves them room
+//
+static void TestOutboxLoad(void) {
+    uint8_t Frame;
+    uint8_t SetAt  = 20;
+    uint8_t SentAt = 0;
+
+    Start();
+
+    for( Frame = 0; Frame < 200; Frame++ ) {
+        CricketLEDPat(Frame,Frame,Frame,Frame,1);
+
+        if( Frame == SetAt ) {
+            CricketMotorSet(3,42);
+            CricketRelaySet(0xA5);
+            }
+
+        CricketMotorService();
+        CricketRelayService();
+
+        if( SentAt == 0 && Frame >= SetAt && !CricketMotorPending() && !CricketRelayPending() )
+            SentAt = Frame;
+        }
+
+    Drain();
+
+    CHECK(SentAt != 0);
+    CHECK(SentAt - SetAt <= 2);                     // Motor, then relay once it's out
+    CHECK(HostMotor[3].Speed == 42);
+    CHECK(HostRelay.Mask     == 0xA5);
+    CHECK(HostLED[1].Frames  == 200);
+    CHECK(HostBus.Errors     == 0);
+
+    if( Verbose )
+        printf("    sent %u display frames after the set\n",SentAt - SetAt);
+    }
+
+
+//
+// The outboxes still send after the 16 bit bus counts have run past 32K bytes
+//
+static void TestOutboxWrap(void) {
+    uint16_t Frame;
+    uint16_t Tries;
+
+    Start();
+
+    for( Frame = 0; Frame < 8250; Frame++ )            // 33000 bytes
+        CricketLEDHex(Frame,1);
+
+    Drain();
+    CricketMotorSet(1,-20);
+    CricketRelaySet(0xA5);
+
+    for( Tries = 0; Tries < 1000 && (CricketMotorPending() || CricketRelayPending()); Tries++ ) {
+        CricketMotorService();
+        CricketRelayService();
+        HostWait(0.1);
+        }
+
+    Drain();
+
+    CHECK(!CricketMotorPending());
+    CHECK(!CricketRelayPending());
+    CHECK(HostMotor[1].Speed == -20);
+    CHECK(HostRelay.Mask     == 0xA5);
+    CHECK(HostBus.Errors     == 0);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Scheduler test
+//
+// With the display and bulk queues kept full, an urgent frame waits only for the
+//   display backlog already in the bus FIFO. Bulk frames go once the display is done.
+//
+static void TestSchedUrgent(void) {
+    static const uint8_t Relay[] = { CRICKET_BUS_RELAY, CRICKET_RELAY_SET, 0xA5 };
+    uint8_t  Frame[] = { CRICKET_BUS_LED, CRICKET_LED_PAT+1, 0, 0, 0, 0 };
+    uint64_t PutAt  = 0;
+    uint64_t SentAt = 0;
+    uint8_t  Tick;
+    uint8_t  Bulk;
+    double   US;
+
+    Start();
+    CricketSchedInit();
+
+    for( Tick = 0; Tick < 20; Tick++ ) {
+        double TickEnd = HostMS() + CRICKET_TICK_MS;
+
+        CricketSchedTick();
+
+        while( CricketSchedQueued(CRICKET_SCHED_DISPLAY) < CRICKET_SCHED_DEPTH ) {
+            Frame[2]++;
+            CricketSchedPut(CRICKET_SCHED_DISPLAY,CRICKET_SCHED_NOKEY,Frame,sizeof(Frame));
+            }
+
+        if( Tick == 0 ) {
+            uint8_t Slow[] = { CRICKET_BUS_LED, CRICKET_LED_PAT+2, 0, 0, 0, 0 };
+
+            for( Bulk = 0; Bulk < CRICKET_SCHED_DEPTH; Bulk++ ) {
+                Slow[2] = Bulk;
+                CHECK(CricketSchedPut(CRICKET_SCHED_BULK,CRICKET_SCHED_NOKEY,Slow,sizeof(Slow)));
+                }
+            }
+
+        if( Tick == 10 ) {
+            PutAt = HostCycles();
+            CHECK(CricketSchedPut(CRICKET_SCHED_URGENT,CRICKET_SCHED_NOKEY,Relay,sizeof(Relay)));
+            }
+
+        while( HostMS() < TickEnd ) {
+            CricketSchedService();
+            if( PutAt && !SentAt && HostRelay.Frames )
+                SentAt = HostCycles();
+            HostWait(0.02);
+            }
+        }
+
+    US = (double) (SentAt - PutAt)/CYCLES_US;
+
+    CHECK(SentAt != 0);
+    CHECK(US <= CRICKET_FRAME_US(CRICKET_SCHED_BACKLOG + 1 + sizeof(Relay)) + 40);
+    CHECK(HostRelay.Mask     == 0xA5);
+    CHECK(HostLED[1].Frames  >= 20);
+    CHECK(HostLED[2].Frames  == 0);                 // Display first, always
+
+    for( Tick = 0; Tick < 20; Tick++ ) {
+        CricketSchedTick();
+        HostWait(CRICKET_TICK_MS);
+        }
+    Drain();
+
+    CHECK(CricketSchedQueued(CRICKET_SCHED_DISPLAY) == 0);
+    CHECK(CricketSchedQueued(CRICKET_SCHED_BULK)    == 0);
+    CHECK(HostLED[2].Frames  == CRICKET_SCHED_DEPTH);
+    CHECK(HostLED[2].Pat[0]  == CRICKET_SCHED_DEPTH-1);
+    CHECK(HostBus.Errors     == 0);
+
+    if( Verbose )
+        printf("    urgent frame out %.0f uS after the put\n",US);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Motor ramp test
+//
+// A trapezoid ramp to 100 at 200 units/sec takes half a second, and gets there
+//   steadily.
+//
+static void TestRamp(void) {
+    int8_t  Last = 0;
+    bool    Steady = true;
+    uint8_t Tick;
+
+    Start();
+    CricketRampProfile(0,200,0);
+    CricketRampTo(0,100);
+
+    for( Tick = 0; Tick < 60; Tick++ ) {
+        int8_t Speed;
+
+        CricketRampTick();
+        CricketMotorService();
+        HostWait(CRICKET_TICK_MS);
+
+        Speed = CricketRampSpeed(0);
+        if( Speed < Last || Speed > Last + 3 )
+            Steady = false;
+        Last = Speed;
+
+        if( Tick == 24 )
+            CHECK(Speed >= 48 && Speed <= 52);
+        }
+
+    while( CricketMotorPending() ) {
+        CricketMotorService();
+        HostWait(0.1);
+        }
+    Drain();
+
+    CHECK(Steady);
+    CHECK(CricketRampDone(0));
+    CHECK(HostMotor[0].Speed == 100);
+    CHECK(HostBus.Errors     == 0);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// UART tests
+//
+// Output goes out at the baud rate, input comes in through the Rx interrupt.
+//
+static void TestUART(void) {
+    uint64_t Begin;
+    double   US;
+
+    Start();
+    Begin = HostCycles();
+    PrintString("Hello, world\r\n");
+
+    while( strlen(HostUARTOutput()) < 14 && HostMS() < 100 )
+        HostWait(0.01);
+
+    US = (double) (HostCycles() - Begin)/CYCLES_US;
+
+    CHECK(strcmp(HostUARTOutput(),"Hello, world\r\n") == 0);
+    CHECK(US > 14*10*1e6/BAUD*0.98);
+    CHECK(US < 14*10*1e6/BAUD*1.02);
+
+    HostUARTInput("ok");
+    HostWait(2);
+
+    CHECK(GetUARTByte() == 'o');
+    CHECK(GetUARTByte() == 'k');
+    CHECK(GetUARTByte() == 0);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Task scheduler test
+//
+// A 10 mS task runs 100 times a second, and the CPU sleeps the rest of the time.
+//
+static uint32_t TaskCount;
+
+static void CountTask(void) { TaskCount++; }
+
+static void TestTask(void) {
+    uint32_t Interrupts;
+    uint32_t Sleeps;
+    uint64_t SleepCycles;
+
+    Start();
+    CricketTaskInit();
+    CricketTaskEvery(CountTask,10);
+
+    CHECK(HostRun(CricketTaskRun,1000) == false);
+
+    HostStats(&Interrupts,&Sleeps,&SleepCycles);
+
+    CHECK(TaskCount >= 99 && TaskCount <= 101);
+    CHECK(CricketTaskMS() >= 999 && CricketTaskMS() <= 1001);
+    CHECK(Sleeps >= 1000);
+    CHECK(SleepCycles > HostCycles()*9/10);
+
+    if( Verbose )
+        printf("    %u runs, %u interrupts, asleep %.1f%%\n",TaskCount,Interrupts,
+               100.0*SleepCycles/HostCycles());
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Deadline test
+//
+// Frames start when they're told to, and the report says how late they were: the
+//   OCR driver's edges are hardware timed, the timer driver's are late by its
+//   interrupt latency.
+//
+#if CRICKET_BUS_DRIVER == CRICKET_DRIVER_OCR
+#define LATE_US             0
+#else
+#define LATE_US             5
+#endif
+
+#ifdef CRICKETDEADLINE_H
+static void TestDeadline(void) {
+    uint32_t Deadline[3];
+    uint32_t When;
+    int32_t  LateUS;
+    int64_t  Offset;
+    uint8_t  Frame;
+
+    Start();
+    CricketDeadlineInit();
+
+    //
+    // CPU clock at deadline clock zero. The register file has TCNT1 as of right now.
+    //
+    When        = CricketDeadlineNow();
+    When       += (uint16_t) (HostReg[HOST_TCNT1] | HostReg[HOST_TCNT1+1] << 8) - (uint16_t) When;
+    Offset      = (int64_t) HostCycles() - When;
+    Deadline[0] = When + CRICKET_DEADLINE_US(5000);
+    Deadline[1] = Deadline[0] + CRICKET_DEADLINE_US(100000);
+    Deadline[2] = ((Deadline[1] + CRICKET_DEADLINE_US(10000)) | 0xFFFF) + 1 + 500;
+
+    CHECK(CricketDeadlinePat(Deadline[0],1,2,3,4,1));
+    CHECK(CricketDeadlinePat(Deadline[1],5,6,7,8,1));
+    CHECK(CricketDeadlinePat(Deadline[2],9,9,9,9,1));  // Kick is before the Timer1 wrap
+
+    HostWait(7);
+    CHECK(HostLED[1].Pat[0] == 1);
+    CHECK(HostBus.Log_Count == 6);
+
+    HostWait(110);
+    CHECK(HostLED[1].Pat[0] == 5);
+
+    HostWait(20);
+    CHECK(HostLED[1].Pat[0] == 9);
+    CHECK(HostBus.Errors == 0);
+
+    for( Frame = 0; Frame < 3; Frame++ ) {
+        int64_t Start = HostBus.Log[Frame*6].At + CRICKET_PRESTART_US*CYCLES_US;
+        int64_t Error = Start - (Deadline[Frame] + Offset);
+
+        CHECK(CricketDeadlineReport(&When,&LateUS));
+        CHECK(When == Deadline[Frame]);
+        CHECK(LateUS >= 0 && LateUS <= LATE_US);
+        CHECK(Error >= 0 && Error < (LATE_US+1)*(int64_t) CYCLES_US);
+        CHECK(Error/(int64_t) CYCLES_US == LateUS);
+
+        if( Verbose )
+            printf("    frame %u: on the line %+.2f uS from deadline, reported %+d uS\n",
+                   Frame,(double) Error/CYCLES_US,LateUS);
+        }
+    }
+#endif
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Receive test
+//
+// Reply - Play a device sending one byte on the line
+//
+// Inputs:      Time from now to start the pre-start, in uS
+//              Byte
+//              TRUE to set the command bit (line low)
+//
+// Outputs:     Time from now the stop bit ends, in uS
+//
+static double Reply(double US,uint8_t Byte,bool Command) {
+    uint16_t Wire  = 0x0401 | (Byte << 1) | (Command ? 0 : 0x0200);    // 1 == line high
+    uint8_t  Level = 0;
+    uint8_t  Cell;
+
+    HostLineDrive(US,0);
+    US += CRICKET_PRESTART_US;
+
+    for( Cell = 0; Cell < 11; Cell++ ) {
+        if( ((Wire >> Cell) & 1) != Level ) {
+            Level = !Level;
+            HostLineDrive(US,Level);
+            }
+        US += CRICKET_BIT_US;
+        }
+
+    return(US);
+    }
+
+//
+// Send, listen to a device's replies on the same line, time out, and send again
+//
+static void TestRxLoopback(void) {
+    static const uint8_t Bytes[] = { 0x5A, 0x42, 0xFF, 0x00 };
+    uint32_t Sent;
+    uint8_t  Status;
+    uint8_t  Byte;
+    uint8_t  Index;
+    double   US = 50;
+
+    Start();
+    CricketBusRxInit();
+    CricketLEDDec(1234,1);
+    Drain();
+
+    Sent = HostBus.Log_Count;
+    CHECK(CricketBusListen(1000));
+    CHECK(CricketBusListening());
+
+    for( Index = 0; Index < NUMOF(Bytes); Index++ )
+        US = Reply(US,Bytes[Index],Index == 1) + 20;
+
+    HostWait(US/1000 + 0.8);                            // Less than the timeout after
+    CHECK(CricketBusListening());
+    HostWait(0.4);
+    CHECK(!CricketBusListening());
+
+    for( Index = 0; Index < NUMOF(Bytes); Index++ ) {
+        Status = CricketBusGet(&Byte);
+        CHECK(Status == (Index == 1 ? CRICKET_RX_BYTE | CRICKET_RX_COMMAND : CRICKET_RX_BYTE));
+        CHECK(Byte   == Bytes[Index]);
+        CHECK(HostBus.Log[Sent+Index].Byte    == Bytes[Index]);
+        CHECK(HostBus.Log[Sent+Index].Command == (Index == 1));
+        }
+    CHECK(CricketBusGet(&Byte) == CRICKET_RX_TIMEOUT);
+    CHECK(CricketBusGet(&Byte) == 0);
+    CHECK(HostBus.Errors == 0);
+
+    CricketLEDDec(5678,1);                              // Line is back to transmit
+    Drain();
+
+    CHECK(HostLED[1].Number == 5678);
+    CHECK(HostLED[1].Frames == 2);
+    CHECK(HostBus.Errors    == 0);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Display module tests
+//
+static void TestNumber(void) {
+    uint8_t Segs[4];
+
+    Start();
+    CHECK(CricketNumber(-1234567,3,0,1,2));             // "-1234.567" over two displays
+    Drain();
+
+    CHECK(HostLED[1].Pat[0] == CRICKET_SEG('-'));
+    CHECK(HostLED[1].Pat[3] == CRICKET_SEG('3'));
+    CHECK(HostLED[2].Pat[0] == (CRICKET_SEG('4') | CRICKET_SEG_DP));
+    CHECK(HostLED[2].Pat[3] == CRICKET_SEG('7'));
+
+    CHECK(CricketNumberSegs(5,2,CRICKET_NUM_ZEROS,Segs,4));
+    CHECK(Segs[0] == CRICKET_SEG('0'));
+    CHECK(Segs[1] == (CRICKET_SEG('0') | CRICKET_SEG_DP));
+    CHECK(Segs[3] == CRICKET_SEG('5'));
+
+    //
+    // Doesn't fit: too many digits, or no room for a digit before the point
+    //
+    CHECK(!CricketNumberSegs(31416,4,0,Segs,4));
+    CHECK(!CricketNumberSegs(0,4,0,Segs,4));
+    CHECK(!CricketNumberSegs(0,255,0,Segs,4));
+    CHECK(Segs[0] == CRICKET_SEG('-'));
+    CHECK(Segs[3] == CRICKET_SEG('-'));
+    }
+
+
+//
+// Two displays change in one burst. Then a staged display that's already showing its
+//   pattern sends nothing, and adds no skew.
+//
+static void TestSync(void) {
+    uint16_t Skew;
+
+    Start();
+    CricketSyncPat(1,2,3,4,1);
+    CricketSyncPat(5,6,7,8,2);
+    Skew = CricketSyncCommit();
+    Drain();
+
+    CHECK(HostLED[1].Pat[0] == 1);
+    CHECK(HostLED[2].Pat[0] == 5);
+    CHECK(Skew == CRICKET_FRAME_US(CRICKET_SYNC_FRAME));
+    CHECK(HostBus.Log[CRICKET_SYNC_FRAME].At - HostBus.Log[0].At <=
+          (Skew + CRICKET_SYNC_FRAME*GAP_US)*CYCLES_US);
+
+    CricketSyncPat(1,2,3,4,1);
+    CricketSyncPat(9,9,9,9,2);
+    CHECK(CricketSyncCommit() == 0);
+    CHECK(CricketSyncSkew()   == 0);
+    Drain();
+
+    CHECK(HostLED[1].Frames == 1);
+    CHECK(HostLED[2].Frames == 2);
+    CHECK(HostLED[2].Pat[0] == 9);
+    CHECK(HostBus.Errors    == 0);
+    }
+
+
+//
+// Run a module's tick function, one tick at a time
+//
+static void Ticks(void (*Tick)(void),uint16_t Count) {
+
+    while( Count-- ) {
+        Tick();
+        HostWait(CRICKET_TICK_MS);
+        }
+    }
+
+//
+// Layers merge, the blink takes out its segments in the off half, and an alert
+//   replaces it all until it times out
+//
+static void TestComp(void) {
+    const uint8_t Five = CricketCompSegment(5);
+
+    Start();
+    CricketCompDec(1025,1);
+    CricketCompDots(0x02,1);
+    CricketCompBlink(0,0,0,0xFF,1);
+
+    Ticks(CricketCompTick,1);                           // Starts in the off half
+    Drain();
+    CHECK(HostLED[1].Pat[0] == CricketCompSegment(1));
+    CHECK(HostLED[1].Pat[1] == (CricketCompSegment(0) | CRICKET_SEG_DP));
+    CHECK(HostLED[1].Pat[3] == 0);
+
+    Ticks(CricketCompTick,CRICKET_COMP_BLINK_MS/CRICKET_TICK_MS);
+    Drain();
+    CHECK(HostLED[1].Pat[3] == Five);
+    CHECK(HostLED[1].Frames == 2);                      // Only when it changes
+
+    CricketCompAlert(0x49,0x49,0x49,0x49,3,1);
+    Ticks(CricketCompTick,1);
+    Drain();
+    CHECK(HostLED[1].Pat[0] == 0x49 || HostLED[1].Pat[0] == 0);
+
+    Ticks(CricketCompTick,2);
+    Drain();
+    CHECK(HostLED[1].Pat[0] == CricketCompSegment(1));
+    CHECK(HostBus.Errors    == 0);
+    }
+
+//
+// A keyframe, then a delta shown twice, then the end
+//
+static void TestAnim(void) {
+    static const uint8_t Anim[] PROGMEM = {
+        CRICKET_ANIM_KEY | CRICKET_ANIM_DURATION, 2, 0x01, 0x02, 0x04, 0x08,
+        CRICKET_ANIM_REPEAT | 0x01, 0xFF,
+        CRICKET_ANIM_END };
+
+    Start();
+    CricketAnimPlay(Anim,false,1);
+
+    Ticks(CricketAnimTick,1);
+    Drain();
+    CHECK(HostLED[1].Pat[0] == 0x01);
+    CHECK(HostLED[1].Pat[3] == 0x08);
+
+    Ticks(CricketAnimTick,2);
+    Drain();
+    CHECK(HostLED[1].Pat[0] == 0xFE);
+    CHECK(HostLED[1].Pat[1] == 0x02);
+
+    Ticks(CricketAnimTick,2);
+    Drain();
+    CHECK(HostLED[1].Pat[0] == 0x01);
+    CHECK(CricketAnimBusy(1));
+
+    Ticks(CricketAnimTick,2);
+    CHECK(!CricketAnimBusy(1));
+    CHECK(HostLED[1].Frames == 3);
+    CHECK(HostBus.Errors    == 0);
+    }
+
+//
+// Text comes in at the right of the strip, and scrolls all the way off
+//
+static void TestMarquee(void) {
+    uint8_t Segs[5] = { 0 };
+
+    CricketFontText("ABCDE",Segs,sizeof(Segs));
+
+    Start();
+    CricketMarqueeText("ABCDE",CRICKET_TICK_MS,false);
+
+    Ticks(CricketMarqueeTick,sizeof(Segs));
+    Drain();
+    CHECK(HostLED[1].Pat[3] == Segs[0]);
+    CHECK(memcmp(HostLED[2].Pat,&Segs[1],4) == 0);
+
+    Ticks(CricketMarqueeTick,CRICKET_MARQUEE_DIGITS);
+    Drain();
+    CHECK(HostLED[1].Pat[3] == 0);
+    CHECK(HostLED[2].Pat[3] == 0);
+    CHECK(CricketMarqueeBusy());
+
+    Ticks(CricketMarqueeTick,1);
+    CHECK(!CricketMarqueeBusy());
+    CHECK(HostBus.Errors == 0);
+    }
+
+//
+// Two fades at once, each through every level in order, ending on time
+//
+static void TestFade(void) {
+    uint8_t Last[3] = { 0, 0, 7 };
+    bool    Steady  = true;
+    uint8_t Tick;
+
+    Start();
+    CricketFade(0,7,500,1);
+    CricketFadeTo(0,300,2);
+
+    for( Tick = 0; Tick < 50; Tick++ ) {
+        Ticks(CricketFadeTick,1);
+
+        if( HostLED[1].Bright < Last[1] || HostLED[1].Bright > Last[1] + 1 ||
+            HostLED[2].Bright > Last[2] || HostLED[2].Bright + 1 < Last[2] )
+            Steady = false;
+        Last[1] = HostLED[1].Bright;
+        Last[2] = HostLED[2].Bright;
+
+        if( Tick == 30 )
+            CHECK(!CricketFadeBusy(2));
+        }
+
+    CHECK(Steady);
+    CHECK(!CricketFadeBusy(1));
+    CHECK(HostLED[1].Bright == 7);
+    CHECK(HostLED[2].Bright == 0);
+    CHECK(HostLED[1].Frames == CRICKET_FADE_LEVELS);
+    CHECK(HostBus.Errors    == 0);
+    }
+
+//
+// Each digit is lit in as many of every CRICKET_DITHER_FULL frames as its level
+//
+static void TestDither(void) {
+    static const uint8_t Levels[4] = { 8, 4, 0, 8 };
+    uint8_t Lit[4] = { 0 };
+    uint8_t Frame;
+    uint8_t Digit;
+
+    Start();
+    CricketDitherPat(1,2,3,4,1);
+    CricketDitherLevels(Levels[0],Levels[1],Levels[2],Levels[3],1);
+
+    while( HostLED[1].Frames < 1 + CRICKET_DITHER_FULL && HostMS() < 100 ) {
+        CricketDitherService();
+        HostWait(0.05);
+        }
+
+    for( Frame = 1; Frame <= CRICKET_DITHER_FULL; Frame++ ) {
+        for( Digit = 0; Digit < 4; Digit++ ) {
+            if( HostBus.Log[Frame*CRICKET_DITHER_FRAME + 2 + Digit].Byte )
+                Lit[Digit]++;
+            }
+        }
+
+    for( Digit = 0; Digit < 4; Digit++ )
+        CHECK(Lit[Digit] == Levels[Digit]);
+
+    CricketDitherStop(1);
+    Drain();
+
+    CHECK(!CricketDitherBusy(1));
+    CHECK(HostLED[1].Pat[1] == 2 && HostLED[1].Pat[2] == 3);
+    CHECK(HostBus.Errors == 0);
+    }
+
+//
+// A flush sends just the panels that changed
+//
+static void TestCanvas(void) {
+    uint8_t Segs[4] = { 0 };
+
+    Start();
+    CricketCanvasMap(0,CRICKET_CANVAS_BUS,1);
+    CricketCanvasMap(1,CRICKET_CANVAS_BUS,2);
+    CricketCanvasText(0,4,"TEMP");
+    CricketCanvasFlush();
+    Drain();
+
+    CricketFontText("TEMP",Segs,sizeof(Segs));
+    CHECK(memcmp(HostLED[1].Pat,Segs,4) == 0);
+    CHECK(HostLED[2].Frames == 1);
+
+    CHECK(CricketCanvasNumber(4,4,-123,1,0));
+    CricketCanvasFlush();
+    CricketCanvasFlush();
+    Drain();
+
+    CHECK(HostLED[1].Frames == 1);
+    CHECK(HostLED[2].Frames == 2);
+    CHECK(HostLED[2].Pat[0] == CRICKET_SEG('-'));
+    CHECK(HostLED[2].Pat[2] == (CRICKET_SEG('2') | CRICKET_SEG_DP));
+    CHECK(HostBus.Errors    == 0);
+    }
+
+//
+// Counting in a loop, with waits
+//
+static void TestScript(void) {
+    static const uint8_t Script[] PROGMEM = {
+        CRICKET_S_BRIGHT(1,3),
+        CRICKET_S_SET(41),
+        CRICKET_S_REPEAT(3),
+            CRICKET_S_ADD(1),
+            CRICKET_S_SHOWDEC(1),
+            CRICKET_S_WAIT(50),
+        CRICKET_S_NEXT,
+        CRICKET_S_PAT(2,1,2,3,4),
+        CRICKET_S_END };
+
+    Start();
+    CricketScriptRun(Script,CRICKET_SCRIPT_PROGMEM);
+
+    Ticks(CricketScriptTick,1);
+    Drain();
+    CHECK(HostLED[1].Number == 42);
+    CHECK(HostLED[1].Bright == 3);
+
+    Ticks(CricketScriptTick,5);
+    Drain();
+    CHECK(HostLED[1].Number == 43);
+    CHECK(CricketScriptBusy());
+
+    Ticks(CricketScriptTick,10);
+    Drain();
+    CHECK(!CricketScriptBusy());
+    CHECK(HostLED[1].Number == 44);
+    CHECK(HostLED[1].Frames == 4);
+    CHECK(HostLED[2].Pat[3] == 4);
+    CHECK(HostBus.Errors    == 0);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Demo test
+//
+// 64 decimal numbers from 1025, 100 mS apart, a second's pause, then hex: at 10 S it's
+//   well into the hex run.
+//
+static void TestDemo(void) {
+    const char *Out;
+
+    CHECK(HostRun((void (*)(void)) DemoMain,10000) == false);
+
+    Out = HostUARTOutput();
+
+    CHECK(strncmp(Out,"Reset CricketBusTest\r\n",22) == 0);
+    CHECK(strstr(Out,"Display dec 1025\r\n") != NULL);
+    CHECK(strstr(Out,"Display dec 1088\r\n") != NULL);
+    CHECK(strstr(Out,"Display dec 1089\r\n") == NULL);
+    CHECK(strstr(Out,"Display hex 1089\r\n") != NULL);
+
+    CHECK(HostLED[1].Mode   == HOST_LED_HEX);
+    CHECK(HostLED[2].Mode   == HOST_LED_HEX);
+    CHECK(HostLED[1].Number >  1089 && HostLED[1].Number < 1089+30);
+    CHECK(HostLED[1].Bright == 4);
+    CHECK(HostLED[1].Frames >= 64+1);
+    CHECK(HostBus.Errors    == 0);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Benchmark
+//
+static void TestBench(void) {
+    struct timespec Begin;
+    struct timespec End;
+    uint16_t Frame;
+    double   HostS;
+    double   SimS;
+
+    Start();
+    clock_gettime(CLOCK_MONOTONIC,&Begin);
+
+    for( Frame = 0; Frame < 1000; Frame++ )
+        CricketLEDPat(Frame,Frame >> 8,~Frame,Frame ^ 0x55,1);
+    Drain();
+
+    clock_gettime(CLOCK_MONOTONIC,&End);
+
+    HostS = (End.tv_sec - Begin.tv_sec) + (End.tv_nsec - Begin.tv_nsec)/1e9;
+    SimS  = HostMS()/1000;
+
+    CHECK(HostLED[1].Frames == 1000);
+    CHECK(HostBus.Errors    == 0);
+
+    printf("    1000 frames: %.3f S virtual, %.3f S host (%.0fx), bus %.1f%% busy\n",
+           SimS,HostS,SimS/HostS,100.0*HostBus.LowCycles/HostCycles());
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Test list
+//
+typedef struct {
+    const char *Name;
+    void      (*Fn)(void);
+    } TEST;
+
+static const TEST Tests[] = {
+    { "LEDDec",     TestLEDDec      },
+    { "LEDHex",     TestLEDHex      },
+    { "LEDPat",     TestLEDPat      },
+    { "LEDBright",  TestLEDBright   },
+    { "LEDText",    TestLEDText     },
+    { "LEDShadow",  TestLEDShadow   },
+    { "BusTiming",  TestBusTiming   },
+    { "BusFIFO",    TestBusFIFO     },
+    { "MotorRelay", TestMotorRelay  },
+    { "OutboxWrap", TestOutboxWrap  },
+    { "OutboxLoad", TestOutboxLoad  },
+    { "SchedUrgent",TestSchedUrgent },
+    { "Ramp",       TestRamp        },
+    { "RxLoopback", TestRxLoopback  },
+    { "Number",     TestNumber      },
+    { "Sync",       TestSync        },
+    { "Comp",       TestComp        },
+    { "Anim",       TestAnim        },
+    { "Marquee",    TestMarquee     },
+    { "Fade",       TestFade        },
+    { "Dither",     TestDither      },
+    { "Canvas",     TestCanvas      },
+    { "Script",     TestScript      },
+    { "UART",       TestUART        },
+    { "Task",       TestTask        },
+#ifdef CRICKETDEADLINE_H
+    { "Deadline",   TestDeadline    },
+#endif
+    { "Demo",       TestDemo        },
+    { "Bench",      TestBench       },
+    };
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// RunTest - Run one test in a process of its own
+//
+// Inputs:      Test
+//
+// Outputs:     TRUE if it passed
+//
+static bool RunTest(const TEST *Test) {
+    pid_t Child;
+    int   Status;
+
+    printf("%-12s\n",Test->Name);
+    fflush(stdout);
+
+    Child = fork();
+
+    if( Child == 0 ) {
+        HostReset();
+        HostUARTEcho(Verbose);
+        Test->Fn();
+        if( HostBus.Errors )
+            printf("    %u bus errors, last: %s\n",HostBus.Errors,HostBus.LastError);
+        fflush(stdout);
+        _exit(Fails ? 1 : 0);
+        }
+
+    if( Child < 0 || waitpid(Child,&Status,0) != Child )
+        return(false);
+
+    return(WIFEXITED(Status) && WEXITSTATUS(Status) == 0);
+    }
+
+
+int main(int argc,char *argv[]) {
+    int     Arg    = 1;
+    int     Failed = 0;
+    int     Run    = 0;
+    uint8_t Index;
+
+    if( Arg < argc && strcmp(argv[Arg],"-v") == 0 ) {
+        Verbose = true;
+        Arg++;
+        }
+
+    printf("Host tests, bus driver %d\n",CRICKET_BUS_DRIVER);
+
+    for( Index = 0; Index < NUMOF(Tests); Index++ ) {
+        int Name;
+
+        for( Name = Arg; Name < argc && strcmp(argv[Name],Tests[Index].Name) != 0; Name++ );
+
+        if( Arg < argc && Name == argc )
+            continue;                                   // Not asked for
+
+        Run++;
+        if( !RunTest(&Tests[Index]) ) {
+            printf("    FAILED\n");
+            Failed++;
+            }
+        }
+
+    printf("%d of %d tests passed\n",Run-Failed,Run);
+
+    return(Failed ? 1 : 0);
+    }
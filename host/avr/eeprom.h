@@ -0,0 +1,60 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      avr/eeprom.h - Host (Linux) build EEPROM access
+//
+//  SYNOPSIS
+//
+//      static uint8_t Script[] EEMEM = { ... };
+//
+//      uint8_t Byte = eeprom_read_byte(&Script[Index]);
+//
+//  DESCRIPTION
+//
+//      Host build stand-in for <avr/eeprom.h>. EEMEM data is ordinary RAM on the host,
+//        so the reads and writes are plain ones.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef HOST_AVR_EEPROM_H
+#define HOST_AVR_EEPROM_H
+
+#include <stdint.h>
+
+#define EEMEM
+
+#define eeprom_read_byte(_a_)           (*(const uint8_t  *) (_a_))
+#define eeprom_read_word(_a_)           (*(const uint16_t *) (_a_))
+#define eeprom_write_byte(_a_,_v_)      (*(uint8_t  *) (_a_) = (_v_))
+#define eeprom_update_byte(_a_,_v_)     (*(uint8_t  *) (_a_) = (_v_))
+#define eeprom_write_word(_a_,_v_)      (*(uint16_t *) (_a_) = (_v_))
+#define eeprom_update_word(_a_,_v_)     (*(uint16_t *) (_a_) = (_v_))
+#define eeprom_busy_wait()
+
+#endif  // HOST_AVR_EEPROM_H - entire file
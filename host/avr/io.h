@@ -0,0 +1,575 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      avr/io.h - Host (Linux) build register definitions
+//
+//  SYNOPSIS
+//
+//      #include <avr/io.h>                 // Host build only: -I host ahead of the AVR headers
+//
+//      PORTD |= _BV(PORTD7);               // As on the chip
+//
+//  DESCRIPTION
+//
+//      Host build stand-in for <avr/io.h>, ATmega328P registers only.
+//
+//      Defining HOST_ATMEGA1284P or HOST_ATMEGA2560 adds that chip's USART1 and power
+//        reduction registers, so that the USART bus driver compiles (make check). USART1
+//        isn't simulated, so that build is for compiling only.
+//
+//      Each register name is an access through the simulator (see HostSim.h), which
+//        charges the access some virtual CPU time, runs any interrupt that came due
+//        and brings counters and pins up to date before the code sees them.
+//
+//      Registers that act on a write (interrupt flags, TCCR1C force bits, UDR0) are
+//        16 bits wide here, holding 0xFF00 plus the register value until the code
+//        writes one, so that the simulator can tell a write from a read. That only
+//        matters to code that reads or writes the whole register, which works as on
+//        the chip; RMW (|=) on an interrupt flag register is the one thing that
+//        doesn't, and is a bug on the chip too.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef HOST_AVR_IO_H
+#define HOST_AVR_IO_H
+
+#include <stdint.h>
+
+#include "HostSim.h"
+
+#if defined(HOST_ATMEGA1284P)
+#define _AVR_IOM1284P_H_    1
+#elif defined(HOST_ATMEGA2560)
+#define _AVR_IOM2560_H_     1
+#else
+#define _AVR_IOM328P_H_     1
+#endif
+
+#define _BV(_bit_)          (1 << (_bit_))
+
+#define _HOST_SFR8(_a_)     (*(volatile uint8_t  *) HostIO(_a_))
+#define _HOST_SFR16(_a_)    (*(volatile uint16_t *) HostIO(_a_))
+#define _HOST_LATCH(_a_)    (*(volatile uint16_t *) HostLatchIO(_a_))
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Register addresses (data space, as on the chip)
+//
+#define HOST_PINB          0x23
+#define HOST_DDRB          0x24
+#define HOST_PORTB         0x25
+#define HOST_PINC          0x26
+#define HOST_DDRC          0x27
+#define HOST_PORTC         0x28
+#define HOST_PIND          0x29
+#define HOST_DDRD          0x2A
+#define HOST_PORTD         0x2B
+#define HOST_TIFR0         0x35
+#define HOST_TIFR1         0x36
+#define HOST_TIFR2         0x37
+#define HOST_PCIFR         0x3B
+#define HOST_EIFR          0x3C
+#define HOST_EIMSK         0x3D
+#define HOST_GPIOR0        0x3E
+#define HOST_EECR          0x3F
+#define HOST_EEDR          0x40
+#define HOST_EEAR          0x41
+#define HOST_GTCCR         0x43
+#define HOST_TCCR0A        0x44
+#define HOST_TCCR0B        0x45
+#define HOST_TCNT0         0x46
+#define HOST_OCR0A         0x47
+#define HOST_OCR0B         0x48
+#define HOST_GPIOR1        0x4A
+#define HOST_GPIOR2        0x4B
+#define HOST_SPCR          0x4C
+#define HOST_SPSR          0x4D
+#define HOST_SPDR          0x4E
+#define HOST_ACSR          0x50
+#define HOST_SMCR          0x53
+#define HOST_MCUSR         0x54
+#define HOST_MCUCR         0x55
+#define HOST_SPMCSR        0x57
+#define HOST_SP            0x5D
+#define HOST_SPL           0x5D
+#define HOST_SPH           0x5E
+#define HOST_SREG          0x5F
+#define HOST_WDTCSR        0x60
+#define HOST_CLKPR         0x61
+#define HOST_PRR           0x64
+#define HOST_OSCCAL        0x66
+#define HOST_PCICR         0x68
+#define HOST_EICRA         0x69
+#define HOST_PCMSK0        0x6B
+#define HOST_PCMSK1        0x6C
+#define HOST_PCMSK2        0x6D
+#define HOST_TIMSK0        0x6E
+#define HOST_TIMSK1        0x6F
+#define HOST_TIMSK2        0x70
+#define HOST_ADC           0x78
+#define HOST_ADCL          0x78
+#define HOST_ADCH          0x79
+#define HOST_ADCSRA        0x7A
+#define HOST_ADCSRB        0x7B
+#define HOST_ADMUX         0x7C
+#define HOST_DIDR0         0x7E
+#define HOST_DIDR1         0x7F
+#define HOST_TCCR1A        0x80
+#define HOST_TCCR1B        0x81
+#define HOST_TCCR1C        0x82
+#define HOST_TCNT1         0x84
+#define HOST_TCNT1L        0x84
+#define HOST_TCNT1H        0x85
+#define HOST_ICR1          0x86
+#define HOST_ICR1L         0x86
+#define HOST_ICR1H         0x87
+#define HOST_OCR1A         0x88
+#define HOST_OCR1AL        0x88
+#define HOST_OCR1AH        0x89
+#define HOST_OCR1B         0x8A
+#define HOST_OCR1BL        0x8A
+#define HOST_OCR1BH        0x8B
+#define HOST_TCCR2A        0xB0
+#define HOST_TCCR2B        0xB1
+#define HOST_TCNT2         0xB2
+#define HOST_OCR2A         0xB3
+#define HOST_OCR2B         0xB4
+#define HOST_ASSR          0xB6
+#define HOST_TWBR          0xB8
+#define HOST_TWSR          0xB9
+#define HOST_TWAR          0xBA
+#define HOST_TWDR          0xBB
+#define HOST_TWCR          0xBC
+#define HOST_UCSR0A        0xC0
+#define HOST_UCSR0B        0xC1
+#define HOST_UCSR0C        0xC2
+#define HOST_UBRR0         0xC4
+#define HOST_UBRR0L        0xC4
+#define HOST_UBRR0H        0xC5
+#define HOST_UDR0          0xC6
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Registers
+//
+#define PINB            _HOST_SFR8(HOST_PINB)
+#define DDRB            _HOST_SFR8(HOST_DDRB)
+#define PORTB           _HOST_SFR8(HOST_PORTB)
+#define PINC            _HOST_SFR8(HOST_PINC)
+#define DDRC            _HOST_SFR8(HOST_DDRC)
+#define PORTC           _HOST_SFR8(HOST_PORTC)
+#define PIND            _HOST_SFR8(HOST_PIND)
+#define DDRD            _HOST_SFR8(HOST_DDRD)
+#define PORTD           _HOST_SFR8(HOST_PORTD)
+#define TIFR0           _HOST_LATCH(HOST_TIFR0)
+#define TIFR1           _HOST_LATCH(HOST_TIFR1)
+#define TIFR2           _HOST_LATCH(HOST_TIFR2)
+#define PCIFR           _HOST_LATCH(HOST_PCIFR)
+#define EIFR            _HOST_LATCH(HOST_EIFR)
+#define EIMSK           _HOST_SFR8(HOST_EIMSK)
+#define GPIOR0          _HOST_SFR8(HOST_GPIOR0)
+#define EECR            _HOST_SFR8(HOST_EECR)
+#define EEDR            _HOST_SFR8(HOST_EEDR)
+#define EEAR            _HOST_SFR16(HOST_EEAR)
+#define GTCCR           _HOST_SFR8(HOST_GTCCR)
+#define TCCR0A          _HOST_SFR8(HOST_TCCR0A)
+#define TCCR0B          _HOST_SFR8(HOST_TCCR0B)
+#define TCNT0           _HOST_SFR8(HOST_TCNT0)
+#define OCR0A           _HOST_SFR8(HOST_OCR0A)
+#define OCR0B           _HOST_SFR8(HOST_OCR0B)
+#define GPIOR1          _HOST_SFR8(HOST_GPIOR1)
+#define GPIOR2          _HOST_SFR8(HOST_GPIOR2)
+#define SPCR            _HOST_SFR8(HOST_SPCR)
+#define SPSR            _HOST_SFR8(HOST_SPSR)
+#define SPDR            _HOST_SFR8(HOST_SPDR)
+#define ACSR            _HOST_SFR8(HOST_ACSR)
+#define SMCR            _HOST_SFR8(HOST_SMCR)
+#define MCUSR           _HOST_SFR8(HOST_MCUSR)
+#define MCUCR           _HOST_SFR8(HOST_MCUCR)
+#define SPMCSR          _HOST_SFR8(HOST_SPMCSR)
+#define SP              _HOST_SFR16(HOST_SP)
+#define SPL             _HOST_SFR8(HOST_SPL)
+#define SPH             _HOST_SFR8(HOST_SPH)
+#define SREG            _HOST_SFR8(HOST_SREG)
+#define WDTCSR          _HOST_SFR8(HOST_WDTCSR)
+#define CLKPR           _HOST_SFR8(HOST_CLKPR)
+#define PRR             _HOST_SFR8(HOST_PRR)
+#define OSCCAL          _HOST_SFR8(HOST_OSCCAL)
+#define PCICR           _HOST_SFR8(HOST_PCICR)
+#define EICRA           _HOST_SFR8(HOST_EICRA)
+#define PCMSK0          _HOST_SFR8(HOST_PCMSK0)
+#define PCMSK1          _HOST_SFR8(HOST_PCMSK1)
+#define PCMSK2          _HOST_SFR8(HOST_PCMSK2)
+#define TIMSK0          _HOST_SFR8(HOST_TIMSK0)
+#define TIMSK1          _HOST_SFR8(HOST_TIMSK1)
+#define TIMSK2          _HOST_SFR8(HOST_TIMSK2)
+#define ADC             _HOST_SFR16(HOST_ADC)
+#define ADCL            _HOST_SFR8(HOST_ADCL)
+#define ADCH            _HOST_SFR8(HOST_ADCH)
+#define ADCSRA          _HOST_SFR8(HOST_ADCSRA)
+#define ADCSRB          _HOST_SFR8(HOST_ADCSRB)
+#define ADMUX           _HOST_SFR8(HOST_ADMUX)
+#define DIDR0           _HOST_SFR8(HOST_DIDR0)
+#define DIDR1           _HOST_SFR8(HOST_DIDR1)
+#define TCCR1A          _HOST_SFR8(HOST_TCCR1A)
+#define TCCR1B          _HOST_SFR8(HOST_TCCR1B)
+#define TCCR1C          _HOST_LATCH(HOST_TCCR1C)
+#define TCNT1           _HOST_SFR16(HOST_TCNT1)
+#define TCNT1L          _HOST_SFR8(HOST_TCNT1L)
+#define TCNT1H          _HOST_SFR8(HOST_TCNT1H)
+#define ICR1            _HOST_SFR16(HOST_ICR1)
+#define ICR1L           _HOST_SFR8(HOST_ICR1L)
+#define ICR1H           _HOST_SFR8(HOST_ICR1H)
+#define OCR1A           _HOST_SFR16(HOST_OCR1A)
+#define OCR1AL          _HOST_SFR8(HOST_OCR1AL)
+#define OCR1AH          _HOST_SFR8(HOST_OCR1AH)
+#define OCR1B           _HOST_SFR16(HOST_OCR1B)
+#define OCR1BL          _HOST_SFR8(HOST_OCR1BL)
+#define OCR1BH          _HOST_SFR8(HOST_OCR1BH)
+#define TCCR2A          _HOST_SFR8(HOST_TCCR2A)
+#define TCCR2B          _HOST_SFR8(HOST_TCCR2B)
+#define TCNT2           _HOST_SFR8(HOST_TCNT2)
+#define OCR2A           _HOST_SFR8(HOST_OCR2A)
+#define OCR2B           _HOST_SFR8(HOST_OCR2B)
+#define ASSR            _HOST_SFR8(HOST_ASSR)
+#define TWBR            _HOST_SFR8(HOST_TWBR)
+#define TWSR            _HOST_SFR8(HOST_TWSR)
+#define TWAR            _HOST_SFR8(HOST_TWAR)
+#define TWDR            _HOST_SFR8(HOST_TWDR)
+#define TWCR            _HOST_SFR8(HOST_TWCR)
+#define UCSR0A          _HOST_SFR8(HOST_UCSR0A)
+#define UCSR0B          _HOST_SFR8(HOST_UCSR0B)
+#define UCSR0C          _HOST_SFR8(HOST_UCSR0C)
+#define UBRR0           _HOST_SFR16(HOST_UBRR0)
+#define UBRR0L          _HOST_SFR8(HOST_UBRR0L)
+#define UBRR0H          _HOST_SFR8(HOST_UBRR0H)
+#define UDR0            _HOST_LATCH(HOST_UDR0)
+
+#if defined(HOST_ATMEGA1284P) || defined(HOST_ATMEGA2560)
+//
+// USART1 and the second power reduction register, compile only
+//
+#define HOST_PRR1          0x65
+#define HOST_UCSR1A        0xC8
+#define HOST_UCSR1B        0xC9
+#define HOST_UCSR1C        0xCA
+#define HOST_UBRR1         0xCC
+#define HOST_UDR1          0xCE
+
+#define PRR0            PRR
+#define PRR1            _HOST_SFR8(HOST_PRR1)
+#define UCSR1A          _HOST_SFR8(HOST_UCSR1A)
+#define UCSR1B          _HOST_SFR8(HOST_UCSR1B)
+#define UCSR1C          _HOST_SFR8(HOST_UCSR1C)
+#define UBRR1           _HOST_SFR16(HOST_UBRR1)
+#define UDR1            _HOST_LATCH(HOST_UDR1)
+
+#define TXC1            6
+#define TXEN1           3
+#define UDRIE1          5
+#define TXCIE1          6
+#define UDORD1          2
+#define UMSEL10         6
+#define UMSEL11         7
+#if defined(HOST_ATMEGA1284P)
+#define PRUSART1        4                  // In PRR0
+#else
+#define PRUSART1        0                  // In PRR1
+#endif
+
+#define USART1_UDRE_vect        HostVect_USART1_UDRE
+#define USART1_TX_vect          HostVect_USART1_TX
+#endif
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Register bits
+//
+#define PINB0 0
+#define DDB0  0
+#define PORTB0 0
+#define PB0   0
+#define PINB1 1
+#define DDB1  1
+#define PORTB1 1
+#define PB1   1
+#define PINB2 2
+#define DDB2  2
+#define PORTB2 2
+#define PB2   2
+#define PINB3 3
+#define DDB3  3
+#define PORTB3 3
+#define PB3   3
+#define PINB4 4
+#define DDB4  4
+#define PORTB4 4
+#define PB4   4
+#define PINB5 5
+#define DDB5  5
+#define PORTB5 5
+#define PB5   5
+#define PINB6 6
+#define DDB6  6
+#define PORTB6 6
+#define PB6   6
+#define PINB7 7
+#define DDB7  7
+#define PORTB7 7
+#define PB7   7
+#define PINC0 0
+#define DDC0  0
+#define PORTC0 0
+#define PC0   0
+#define PINC1 1
+#define DDC1  1
+#define PORTC1 1
+#define PC1   1
+#define PINC2 2
+#define DDC2  2
+#define PORTC2 2
+#define PC2   2
+#define PINC3 3
+#define DDC3  3
+#define PORTC3 3
+#define PC3   3
+#define PINC4 4
+#define DDC4  4
+#define PORTC4 4
+#define PC4   4
+#define PINC5 5
+#define DDC5  5
+#define PORTC5 5
+#define PC5   5
+#define PINC6 6
+#define DDC6  6
+#define PORTC6 6
+#define PC6   6
+#define PINC7 7
+#define DDC7  7
+#define PORTC7 7
+#define PC7   7
+#define PIND0 0
+#define DDD0  0
+#define PORTD0 0
+#define PD0   0
+#define PIND1 1
+#define DDD1  1
+#define PORTD1 1
+#define PD1   1
+#define PIND2 2
+#define DDD2  2
+#define PORTD2 2
+#define PD2   2
+#define PIND3 3
+#define DDD3  3
+#define PORTD3 3
+#define PD3   3
+#define PIND4 4
+#define DDD4  4
+#define PORTD4 4
+#define PD4   4
+#define PIND5 5
+#define DDD5  5
+#define PORTD5 5
+#define PD5   5
+#define PIND6 6
+#define DDD6  6
+#define PORTD6 6
+#define PD6   6
+#define PIND7 7
+#define DDD7  7
+#define PORTD7 7
+#define PD7   7
+
+#define TOV0            0
+#define OCF0A           1
+#define OCF0B           2
+
+#define TOV1            0
+#define OCF1A           1
+#define OCF1B           2
+#define ICF1            5
+
+#define TOV2            0
+#define OCF2A           1
+#define OCF2B           2
+
+#define TOIE0           0
+#define OCIE0A          1
+#define OCIE0B          2
+
+#define TOIE1           0
+#define OCIE1A          1
+#define OCIE1B          2
+#define ICIE1           5
+
+#define TOIE2           0
+#define OCIE2A          1
+#define OCIE2B          2
+
+#define WGM00           0
+#define WGM01           1
+#define COM0B0          4
+#define COM0B1          5
+#define COM0A0          6
+#define COM0A1          7
+
+#define CS00            0
+#define CS01            1
+#define CS02            2
+#define WGM02           3
+#define FOC0B           6
+#define FOC0A           7
+
+#define WGM10           0
+#define WGM11           1
+#define COM1B0          4
+#define COM1B1          5
+#define COM1A0          6
+#define COM1A1          7
+
+#define CS10            0
+#define CS11            1
+#define CS12            2
+#define WGM12           3
+#define WGM13           4
+#define ICES1           6
+#define ICNC1           7
+
+#define FOC1B           6
+#define FOC1A           7
+
+#define MPCM0           0
+#define U2X0            1
+#define UPE0            2
+#define DOR0            3
+#define FE0             4
+#define UDRE0           5
+#define TXC0            6
+#define RXC0            7
+
+#define TXB80           0
+#define RXB80           1
+#define UCSZ02          2
+#define TXEN0           3
+#define RXEN0           4
+#define UDRIE0          5
+#define TXCIE0          6
+#define RXCIE0          7
+
+#define UCPOL0          0
+#define UCSZ00          1
+#define UCSZ01          2
+#define USBS0           3
+#define UPM00           4
+#define UPM01           5
+#define UMSEL00         6
+#define UMSEL01         7
+
+#define PRADC           0
+#define PRUSART0        1
+#define PRSPI           2
+#define PRTIM1          3
+#define PRTIM0          5
+#define PRTIM2          6
+#define PRTWI           7
+
+#define PCIE0           0
+#define PCIE1           1
+#define PCIE2           2
+
+#define PCIF0           0
+#define PCIF1           1
+#define PCIF2           2
+
+#define INT0            0
+#define INT1            1
+
+#define INTF0           0
+#define INTF1           1
+
+#define SE              0
+#define SM0             1
+#define SM1             2
+#define SM2             3
+
+#define PORF            0
+#define EXTRF           1
+#define BORF            2
+#define WDRF            3
+
+#define WDP0            0
+#define WDP1            1
+#define WDP2            2
+#define WDE             3
+#define WDCE            4
+#define WDP3            5
+#define WDIE            6
+#define WDIF            7
+
+#define EERE            0
+#define EEPE            1
+#define EEMPE           2
+#define EERIE           3
+#define EEPM0           4
+#define EEPM1           5
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Interrupt vectors, in priority order. ISR() defines a function by this name, which
+//   the simulator calls (see HostSim.c).
+//
+#define INT0_vect               HostVect_INT0
+#define INT1_vect               HostVect_INT1
+#define PCINT0_vect             HostVect_PCINT0
+#define PCINT1_vect             HostVect_PCINT1
+#define PCINT2_vect             HostVect_PCINT2
+#define WDT_vect                HostVect_WDT
+#define TIMER2_COMPA_vect       HostVect_TIMER2_COMPA
+#define TIMER2_COMPB_vect       HostVect_TIMER2_COMPB
+#define TIMER2_OVF_vect         HostVect_TIMER2_OVF
+#define TIMER1_CAPT_vect        HostVect_TIMER1_CAPT
+#define TIMER1_COMPA_vect       HostVect_TIMER1_COMPA
+#define TIMER1_COMPB_vect       HostVect_TIMER1_COMPB
+#define TIMER1_OVF_vect         HostVect_TIMER1_OVF
+#define TIMER0_COMPA_vect       HostVect_TIMER0_COMPA
+#define TIMER0_COMPB_vect       HostVect_TIMER0_COMPB
+#define TIMER0_OVF_vect         HostVect_TIMER0_OVF
+#define SPI_STC_vect            HostVect_SPI_STC
+#define USART_RX_vect           HostVect_USART_RX
+#define USART_UDRE_vect         HostVect_USART_UDRE
+#define USART_TX_vect           HostVect_USART_TX
+#define ADC_vect                HostVect_ADC
+#define EE_READY_vect           HostVect_EE_READY
+#define ANALOG_COMP_vect        HostVect_ANALOG_COMP
+#define TWI_vect                HostVect_TWI
+#define SPM_READY_vect          HostVect_SPM_READY
+
+#endif  // HOST_AVR_IO_H - entire file
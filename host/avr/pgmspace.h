@@ -0,0 +1,64 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      avr/pgmspace.h - Host (Linux) build program memory access
+//
+//  SYNOPSIS
+//
+//      static const uint8_t Table[] PROGMEM = { ... };
+//
+//      uint8_t Byte = pgm_read_byte(&Table[Index]);
+//
+//  DESCRIPTION
+//
+//      Host build stand-in for <avr/pgmspace.h>. There's only the one address space,
+//        so PROGMEM data is ordinary const data and the reads are plain reads.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef HOST_AVR_PGMSPACE_H
+#define HOST_AVR_PGMSPACE_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+#define PGM_P               const char *
+#define PSTR(_s_)           (_s_)
+
+#define pgm_read_byte(_a_)  (*(const uint8_t  *) (_a_))
+#define pgm_read_word(_a_)  (*(const uint16_t *) (_a_))
+#define pgm_read_dword(_a_) (*(const uint32_t *) (_a_))
+#define pgm_read_ptr(_a_)   (*(void * const *)   (_a_))
+
+#define memcpy_P            memcpy
+#define strlen_P            strlen
+#define strcpy_P            strcpy
+
+#endif  // HOST_AVR_PGMSPACE_H - entire file
@@ -0,0 +1,55 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      util/delay.h - Host (Linux) build delays
+//
+//  SYNOPSIS
+//
+//      _delay_us(10);                      // 160 virtual CPU cycles at 16 MHz
+//      _delay_ms(100);
+//
+//  DESCRIPTION
+//
+//      Host build stand-in for <util/delay.h>. A delay runs the virtual clock ahead by
+//        that many CPU cycles. As with the real delay loops, interrupts (if enabled)
+//        can run during the delay and make it that much longer.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef HOST_UTIL_DELAY_H
+#define HOST_UTIL_DELAY_H
+
+#include "HostSim.h"
+
+#define HOST_NO_CHARGE  __attribute__((no_instrument_function))  // Delay charges its own time
+
+static inline HOST_NO_CHARGE void _delay_us(double US) { HostDelay(US*(F_CPU/1000000.0)); }
+static inline HOST_NO_CHARGE void _delay_ms(double MS) { HostDelay(MS*(F_CPU/1000.0)); }
+
+#endif  // HOST_UTIL_DELAY_H - entire file
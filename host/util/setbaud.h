@@ -0,0 +1,80 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      util/setbaud.h - Host (Linux) build baud rate calculation
+//
+//  SYNOPSIS
+//
+//      #define BAUD 19200
+//      #include <util/setbaud.h>
+//
+//      UBRR0H = UBRRH_VALUE;
+//      UBRR0L = UBRRL_VALUE;
+//
+//  DESCRIPTION
+//
+//      Host build stand-in for <util/setbaud.h>, same results as the avr-libc one: the
+//        nearest divisor at 16x, or at 8x (USE_2X) if 16x is off by more than BAUD_TOL
+//        percent.
+//
+//      Like the original, this may be included more than once (and inside a function).
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef F_CPU
+#   error "util/setbaud.h: F_CPU must be defined"
+#endif
+
+#ifndef BAUD
+#   error "util/setbaud.h: BAUD must be defined"
+#endif
+
+#ifndef BAUD_TOL
+#define BAUD_TOL        2
+#endif
+
+#undef UBRR_VALUE
+#undef UBRRL_VALUE
+#undef UBRRH_VALUE
+#undef USE_2X
+
+#define _HOST_UBRR16    (((F_CPU) + 8UL*(BAUD))/(16UL*(BAUD)) - 1UL)
+#define _HOST_UBRR8     (((F_CPU) + 4UL*(BAUD))/(8UL*(BAUD)) - 1UL)
+
+#if 100*(F_CPU) > (16*(_HOST_UBRR16+1))*(100*(BAUD) + (BAUD)*(BAUD_TOL)) ||   \
+    100*(F_CPU) < (16*(_HOST_UBRR16+1))*(100*(BAUD) - (BAUD)*(BAUD_TOL))
+#   define USE_2X       1
+#   define UBRR_VALUE   _HOST_UBRR8
+#else
+#   define USE_2X       0
+#   define UBRR_VALUE   _HOST_UBRR16
+#endif
+
+#define UBRRL_VALUE     (UBRR_VALUE & 0xFF)
+#define UBRRH_VALUE     (UBRR_VALUE >> 8)
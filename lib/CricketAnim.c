@@ -0,0 +1,225 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      CricketAnim.c
+//
+//  SYNOPSIS
+//
+//      #include "MyAnim.h"                 // From tools/CricketAnimEncode
+//
+//      CricketAnimPlay(MyAnim,true,ID);    // Start MyAnim on display ID, looping
+//      CricketAnimStop(ID);
+//
+//      if( CricketAnimBusy(ID) ) ...       // TRUE while playing
+//
+//      CricketAnimTick();                  // Called every CRICKET_TICK_MS
+//
+//  DESCRIPTION
+//
+//      Delta-compressed segment animation player. See CricketAnim.h
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#include <avr/pgmspace.h>
+
+#include "CricketAnim.h"
+#include "PortMacros.h"
+
+typedef struct {
+    const uint8_t *Start;                   // First record, for looping
+    const uint8_t *Next;                    // Next record
+    const uint8_t *Delta;                   // XOR bytes of a repeating delta
+    uint8_t     Mask;                       //   ...and which digits they go with
+    uint8_t     Repeats;                    //   ...and times left to apply it
+    uint8_t     Frame[4];                   // Current frame
+    uint8_t     Duration;                   // Ticks per frame
+    uint8_t     Ticks;                      // Ticks left on current frame
+    bool        Loop;
+    bool        Playing;
+    } ANIM_PLAYER;
+
+static ANIM_PLAYER Player[CRICKET_LED_IDS];
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketAnimPlay - Start playing an animation on one display
+// CricketAnimStop - Stop playing (the display keeps the current frame)
+//
+// Inputs:      [CricketAnimPlay] Animation, in PROGMEM
+//              [CricketAnimPlay] TRUE to loop forever
+//              Device ID (0, 1 or 2)
+//
+// Outputs:     None.
+//
+void CricketAnimPlay(const uint8_t *Anim,bool Loop,uint8_t ID) {
+    ANIM_PLAYER *P;
+
+    if( ID >= CRICKET_LED_IDS )
+        return;
+
+    P = &Player[ID];
+
+    P->Start    = Anim;
+    P->Next     = Anim;
+    P->Repeats  = 0;
+    P->Duration = 1;
+    P->Ticks    = 0;                        // First frame on the next tick
+    P->Loop     = Loop;
+    P->Playing  = true;
+    }
+
+void CricketAnimStop(uint8_t ID) {
+
+    if( ID < CRICKET_LED_IDS )
+        Player[ID].Playing = false;
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketAnimBusy - Return TRUE if an animation is playing on a display
+//
+// Inputs:      Device ID (0, 1 or 2)
+//
+// Outputs:     TRUE  if playing
+//              FALSE if stopped or done
+//
+bool CricketAnimBusy(uint8_t ID) {
+
+    if( ID >= CRICKET_LED_IDS )
+        return(false);
+
+    return(Player[ID].Playing);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// ApplyDelta - XOR the changed digits into the current frame
+//
+// Inputs:      Player
+//
+// Outputs:     None.
+//
+static void ApplyDelta(ANIM_PLAYER *P) {
+    const uint8_t *Delta = P->Delta;
+    uint8_t        Digit;
+
+    for( Digit = 0; Digit < 4; Digit++ ) {
+        if( _BIT_ON(P->Mask,Digit) )
+            P->Frame[Digit] ^= pgm_read_byte(Delta++);
+        }
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// NextFrame - Decode the next frame of an animation
+//
+// Inputs:      Player
+//
+// Outputs:     TRUE  if there's a new frame
+//              FALSE if the animation has ended
+//
+static bool NextFrame(ANIM_PLAYER *P) {
+    uint8_t Control;
+    uint8_t Digit;
+
+    if( P->Repeats ) {
+        P->Repeats--;
+        ApplyDelta(P);
+        return(true);
+        }
+
+    Control = pgm_read_byte(P->Next++);
+
+    if( Control == CRICKET_ANIM_END ) {
+        if( !P->Loop )
+            return(false);
+        P->Next = P->Start;
+        Control = pgm_read_byte(P->Next++);
+        }
+
+    if( Control & CRICKET_ANIM_DURATION )
+        P->Duration = pgm_read_byte(P->Next++);
+
+    if( Control & CRICKET_ANIM_KEY ) {
+        for( Digit = 0; Digit < 4; Digit++ )
+            P->Frame[Digit] = pgm_read_byte(P->Next++);
+        return(true);
+        }
+
+    P->Mask    = Control & CRICKET_ANIM_MASK;
+    P->Delta   = P->Next;
+    P->Repeats = (Control & CRICKET_ANIM_REPEATS)/CRICKET_ANIM_REPEAT;
+
+    for( Digit = 0; Digit < 4; Digit++ ) {
+        if( _BIT_ON(P->Mask,Digit) )
+            P->Next++;
+        }
+
+    ApplyDelta(P);
+    return(true);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketAnimTick - Advance every playing animation by one tick
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void CricketAnimTick(void) {
+    uint8_t ID;
+
+    for( ID = 0; ID < CRICKET_LED_IDS; ID++ ) {
+        ANIM_PLAYER *P = &Player[ID];
+
+        if( !P->Playing )
+            continue;
+
+        if( P->Ticks && --P->Ticks )
+            continue;
+
+        if( !NextFrame(P) ) {
+            P->Playing = false;
+            continue;
+            }
+
+        P->Ticks = P->Duration;
+        CricketLEDPat(P->Frame[0],P->Frame[1],P->Frame[2],P->Frame[3],ID);
+        }
+    }
@@ -0,0 +1,130 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      CricketAnim.h - Delta-compressed segment animation player
+//
+//  SYNOPSIS
+//
+//      #include "MyAnim.h"                 // From tools/CricketAnimEncode
+//
+//      CricketAnimPlay(MyAnim,true,ID);    // Start MyAnim on display ID, looping
+//      CricketAnimStop(ID);
+//
+//      if( CricketAnimBusy(ID) ) ...       // TRUE while playing
+//
+//      CricketAnimTick();                  // Called every CRICKET_TICK_MS
+//
+//  DESCRIPTION
+//
+//      Streaming player for delta-compressed segment animations.
+//
+//      Animations are made from a frame list by the host tool tools/CricketAnimEncode.c.
+//        Each frame is either a keyframe (all 4 digits), or the XOR of the digits that
+//        changed since the last frame, with a run-length repeat count, so most frames
+//        take 2 or 3 bytes of flash instead of 4 plus a duration.
+//
+//      The player reads the stream straight out of flash. Only the current frame and a
+//        few pointers are kept in RAM, per display. Each new frame goes out as a pattern
+//        frame via CricketLEDPat().
+//
+//      Animation format, a byte stream in PROGMEM. Each record starts with a control
+//        byte:
+//
+//          K R R D M M M M
+//          | | | | +-+-+-+---  Delta: digits that change (bit 0 == leftmost digit)
+//          | | | +-----------  A duration byte follows (ticks, 1-255)
+//          | +-+-------------  Delta: show this delta 1-4 times (repeat count - 1)
+//          +-----------------  Keyframe: 4 pattern bytes follow (after any duration)
+//
+//        then, in order: the duration byte (if D), then for a keyframe the 4 pattern
+//        bytes, or for a delta one XOR byte per digit set in M. The duration carries
+//        over from frame to frame until changed. A control byte of 0x00 ends the
+//        animation. The first record must be a keyframe with a duration.
+//
+//      A repeated delta is applied again each time, so a 2-frame blink is one record
+//        with a repeat count. A frame that's the same as the last (M == 0) needs D.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CRICKETANIM_H
+#define CRICKETANIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "CricketLED.h"
+
+#define CRICKET_ANIM_END        0x00        // Control byte: end of animation
+#define CRICKET_ANIM_KEY        0x80        // Control byte: keyframe
+#define CRICKET_ANIM_REPEAT     0x20        // Control byte: repeat count, 1 unit
+#define CRICKET_ANIM_REPEATS    0x60        // Control byte: repeat count mask
+#define CRICKET_ANIM_DURATION   0x10        // Control byte: duration byte follows
+#define CRICKET_ANIM_MASK       0x0F        // Control byte: digits changed
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketAnimPlay - Start playing an animation on one display
+// CricketAnimStop - Stop playing (the display keeps the current frame)
+//
+// Inputs:      [CricketAnimPlay] Animation, in PROGMEM
+//              [CricketAnimPlay] TRUE to loop forever
+//              Device ID (0, 1 or 2)
+//
+// Outputs:     None.
+//
+void CricketAnimPlay(const uint8_t *Anim,bool Loop,uint8_t ID);
+void CricketAnimStop(uint8_t ID);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketAnimBusy - Return TRUE if an animation is playing on a display
+//
+// Inputs:      Device ID (0, 1 or 2)
+//
+// Outputs:     TRUE  if playing
+//              FALSE if stopped or done
+//
+bool CricketAnimBusy(uint8_t ID);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketAnimTick - Advance every playing animation by one tick
+//
+// Call once every CRICKET_TICK_MS, from the main loop.
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void CricketAnimTick(void);
+
+#endif  // CRICKETANIM_H - entire file
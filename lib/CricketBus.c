@@ -67,6 +67,8 @@
 //////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////
 
+#include <string.h>
+
 #include <avr/interrupt.h>
 #include <util/delay.h>
 
@@ -76,6 +78,146 @@
 #define CRICKET_HIGH    _SET_BIT(_PORT(CRICKET_BUS_PORT),CRICKET_BUS_PIN);  // Bus high
 #define CRICKET_LOW     _CLR_BIT(_PORT(CRICKET_BUS_PORT),CRICKET_BUS_PIN);  // Bus low
 
+#if CRICKET_BUS_DRIVER == CRICKET_DRIVER_LINUX
+#   error "CricketBus.c: for the Linux driver, build CricketBusLinux.c instead"
+#elif CRICKET_BUS_DRIVER > CRICKET_DRIVER_USART
+#   error "CricketBus.h: Unknown CRICKET_BUS_DRIVER"
+#endif
+
+#define CRICKET_FIFO_WRAP   (CRICKET_FIFO_SIZE-1)   // Wraparound mask for FIFO
+
+//
+// Timer1 runs at the CPU clock, so bus times convert directly to timer ticks
+//
+#define CRICKET_PRESTART_TICKS      CRICKET_US_TICKS(CRICKET_PRESTART_US)
+#define CRICKET_BIT_TICKS           CRICKET_US_TICKS(CRICKET_BIT_US)
+#define CRICKET_KICK_TICKS          CRICKET_US_TICKS(CRICKET_BIT_US)  // Delay to start Tx
+
+//
+// Timer1 compare channel registers, per CRICKET_BUS_OC
+//
+#define _OCR1(_x_)          _JOIN(OCR1,_x_)
+#define _OCIE1(_x_)         _JOIN(OCIE1,_x_)
+#define _OCF1(_x_)          _JOIN(OCF1,_x_)
+#define _FOC1(_x_)          _JOIN(FOC1,_x_)
+#define _COM1(_x_,_b_)      _JOIN3(COM1,_x_,_b_)
+#define _T1VECT(_x_)        _JOIN3(TIMER1_COMP,_x_,_vect)
+
+#define CRICKET_OCR         _OCR1(CRICKET_BUS_OC)
+#define CRICKET_OCIE        _OCIE1(CRICKET_BUS_OC)
+#define CRICKET_OCF         _OCF1(CRICKET_BUS_OC)
+#define CRICKET_FOC         _FOC1(CRICKET_BUS_OC)
+#define CRICKET_COM0        _COM1(CRICKET_BUS_OC,0)
+#define CRICKET_COM1        _COM1(CRICKET_BUS_OC,1)
+#define CRICKET_VECT        _T1VECT(CRICKET_BUS_OC)
+
+//
+// OCR driver: level the hardware drives onto the pin at the next compare match
+//
+#define CRICKET_NEXT_HIGH   { TCCR1A = _PIN_MASK(CRICKET_COM1) | _PIN_MASK(CRICKET_COM0); }
+#define CRICKET_NEXT_LOW    { TCCR1A = _PIN_MASK(CRICKET_COM1); }
+
+//
+// USART driver: USART1 in master SPI mode, at exactly one bus bit per clock. The bus
+//   line is TXD1, and XCK1 (unused) must be an output for master mode.
+//
+#if CRICKET_BUS_DRIVER == CRICKET_DRIVER_USART
+#   if defined(_AVR_IOM1284P_H_)
+#       define CRICKET_XCK_PORT     D
+#       define CRICKET_XCK_PIN      4
+#       define CRICKET_USART_PRR    PRR0        // PRUSART1 is in PRR0
+#   elif defined(_AVR_IOM2560_H_)
+#       define CRICKET_XCK_PORT     D
+#       define CRICKET_XCK_PIN      5
+#       define CRICKET_USART_PRR    PRR1        // PRUSART1 is in PRR1
+#   else
+#       error "CricketBus.h: CRICKET_DRIVER_USART needs USART1 (ATmega1284P or ATmega2560)"
+#   endif
+#endif
+
+#define CRICKET_UBRR        ((F_CPU/(2UL*1000000UL/CRICKET_BIT_US))-1)
+
+//
+// Per-driver interrupt control for CricketBusPut
+//
+#if CRICKET_BUS_DRIVER == CRICKET_DRIVER_USART
+#   define CRICKET_INT_OFF  _CLR_BIT(UCSR1B,UDRIE1)
+#   define CRICKET_INT_ON   _SET_BIT(UCSR1B,UDRIE1)
+#   define CRICKET_START    {                                                           \
+        Bus.Active = true;                                                              \
+        Bus.Phase  = 0;                                                                 \
+        UBRR1      = 0;                         /* Per datasheet, MSPIM enable */       \
+        _SET_BIT(UCSR1B,TXEN1);                                                         \
+        UBRR1      = CRICKET_UBRR;                                                      \
+        }
+#else
+#   define CRICKET_INT_OFF  _CLR_BIT(TIMSK1,CRICKET_OCIE)
+#   define CRICKET_INT_ON   _SET_BIT(TIMSK1,CRICKET_OCIE)
+#   define CRICKET_START    {                                                           \
+        CRICKET_OCR = TCNT1 + CRICKET_KICK_TICKS;                                       \
+        TIFR1       = _PIN_MASK(CRICKET_OCF);   /* Clear any stale match */             \
+        }
+#endif
+
+enum {
+    HOLD_NONE = 0,                      // Transmitter runs as usual
+    HOLD_HELD,                          // CricketBusHold: idle, interrupt off
+    HOLD_ARMED,                         // CricketBusStartAt: kick programmed, waiting
+    };                                  //   for the first start bit
+
+enum {
+    PHASE_NEXT = 0,                     // End of byte (or idle kick), start next
+    PHASE_PRESTART,                     // Pre-start low just began
+    PHASE_BITS,                         // Sending start, data, command and stop bits
+    };
+
+//
+// Wire image of one byte. Bytes are encoded by CricketBusPut, so the FIFO holds
+//   exactly what the interrupt handler shifts out, LSB first.
+//
+// Timer and OCR drivers, after the pre-start:
+//
+//      bit 0       Start bit (high)
+//      bit 1-8     Data, LSB first
+//      bit 9       Command bit (low for command)
+//      bit 10      Stop bit (high)
+//
+// USART driver, bits 8-23 of the 24 bit stream (bits 0-7 are pre-start, all low):
+//
+//      bit 0-1     Pre-start, continued (low)
+//      bit 2       Start bit (high)
+//      bit 3-10    Data, LSB first
+//      bit 11      Command bit (low for command)
+//      bit 12-15   Stop bits (high)
+//
+#if CRICKET_BUS_DRIVER == CRICKET_DRIVER_USART
+#define CRICKET_WIRE(_Byte_,_Command_)  ( 0xF004 | (((uint16_t) (_Byte_)) << 3) |           \
+                                          ((_Command_) ? 0 : 0x0800) )
+#else
+#define CRICKET_WIRE(_Byte_,_Command_)  ( 0x0401 | (((uint16_t) (_Byte_)) << 1) |           \
+                                          ((_Command_) ? 0 : 0x0200) )
+#endif
+
+static struct {
+    uint16_t    FIFO[CRICKET_FIFO_SIZE];    // Wire images, per above
+
+    uint8_t     FIFO_In;                // FIFO input  pointer
+    uint8_t     FIFO_Out;               // FIFO output pointer
+
+    uint16_t    Wire;                   // Remaining bits of byte being sent
+    bool        Active;                 // TRUE if a byte is on the wire
+    uint8_t     Phase;                  // OCR/USART: what the next interrupt means
+    uint8_t     Level;                  // OCR driver: current line level
+    bool        Done;                   // OCR/USART: byte ends at the next interrupt
+
+    uint16_t    Posted;                 // Bytes accepted by CricketBusPut
+    uint16_t    Sent;                   // Bytes completely sent
+
+    uint8_t     Hold;                   // HOLD_xxx, for CricketBusStartAt
+    bool        Stamped;                // TRUE if StartTime is new
+    uint16_t    StartTime;              // Timer1 time of the armed start bit
+    } Bus NOINIT;
+
 //////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////
 //
@@ -90,12 +232,110 @@
 //
 void CricketBusInit(void) {
     
-    _SET_BIT(_DDR(CRICKET_BUS_PORT),CRICKET_BUS_PIN);   // Bus line is an output
+    memset(&Bus,0,sizeof(Bus));
 
     CRICKET_HIGH;                                       // Set high until first data
+
+#if CRICKET_BUS_DRIVER == CRICKET_DRIVER_TIMER || CRICKET_BUS_DRIVER == CRICKET_DRIVER_OCR
+    //
+    // Timer1 free running at the CPU clock. Each compare match moves the compare
+    //   register ahead by the length of the next bus state.
+    //
+    TCCR1A = 0;                                         // Normal mode, no pin outputs
+    TCCR1B = (1 << CS10);                               // Clk/1
+    _CLR_BIT(TIMSK1,CRICKET_OCIE);                      // Idle until first data
+#endif
+
+#if CRICKET_BUS_DRIVER == CRICKET_DRIVER_OCR
+    //
+    // Hand the pin to the compare unit, and force it high to match the port.
+    //
+    CRICKET_NEXT_HIGH;
+    TCCR1C = _PIN_MASK(CRICKET_FOC);
+    Bus.Level = 1;
+#endif
+
+#if CRICKET_BUS_DRIVER == CRICKET_DRIVER_USART
+    //
+    // Master SPI, LSB first. The transmitter is only enabled while there's data, so
+    //   the port holds the line high (idle) in between.
+    //
+    _CLR_BIT(CRICKET_USART_PRR,PRUSART1);               // Power up USART1
+    _SET_BIT(_DDR(CRICKET_XCK_PORT),CRICKET_XCK_PIN);   // XCK1 output: master mode
+    UBRR1  = 0;
+    UCSR1C = _PIN_MASK(UMSEL11) | _PIN_MASK(UMSEL10) | _PIN_MASK(UDORD1);
+    UCSR1B = 0;
+#endif
+
+    //
+    // Drive the line last, once the port (or compare unit) is set high, so that it
+    //   doesn't glitch low on the way.
+    //
+    _SET_BIT(_DDR(CRICKET_BUS_PORT),CRICKET_BUS_PIN);   // Bus line is an output
     }
 
 
+#if CRICKET_BUS_DRIVER == CRICKET_DRIVER_BITBANG
+
+//
+// Bit timing for the bit-bang driver, computed from F_CPU at compile time.
+//
+// Every bit cell (and each tenth of the pre-start) is exactly CRICKET_BIT_CYCLES long:
+//   a 4 cycle slot that sets the line, then a delay loop for the remainder. The only
+//   error is rounding the cell to a whole number of cycles, which is zero for any
+//   clock that's a multiple of 100 KHz (8, 12, 16 and 20 MHz included).
+//
+#define CRICKET_SLOT_CYCLES 4                                   // Set-the-line code
+#define CRICKET_WAIT_CYCLES (CRICKET_BIT_CYCLES-CRICKET_SLOT_CYCLES)
+#define CRICKET_WAIT_LOOPS  (CRICKET_WAIT_CYCLES/3)             // 3 cycles per loop
+#define CRICKET_WAIT_NOPS   (CRICKET_WAIT_CYCLES%3)
+
+//
+// Worst case bit error, in nS (rounded cycle count vs. 10 uS)
+//
+#define CRICKET_BIT_ERROR   (CRICKET_BIT_CYCLES*100000UL > F_CPU ?                          \
+                                CRICKET_BIT_CYCLES*100000UL - F_CPU :                       \
+                                F_CPU - CRICKET_BIT_CYCLES*100000UL)
+#define CRICKET_BIT_ERR_NS  ((CRICKET_BIT_ERROR*10000UL)/F_CPU)
+
+#if CRICKET_WAIT_LOOPS < 1 || CRICKET_WAIT_LOOPS > 255
+#   error "CricketBus.c: F_CPU out of range for bit-bang driver"
+#elif CRICKET_BIT_ERR_NS == 0
+#   pragma message "CricketBus: bit-bang timing is cycle exact (0 nS error per bit)"
+#elif CRICKET_BIT_ERR_NS < 25
+#   pragma message "CricketBus: bit-bang timing error is under 25 nS per bit"
+#elif CRICKET_BIT_ERR_NS < 100
+#   warning "CricketBus: bit-bang timing error is 25-100 nS per bit, use a 100 KHz multiple F_CPU"
+#else
+#   warning "CricketBus: bit-bang timing error is over 100 nS per bit, use a 100 KHz multiple F_CPU"
+#endif
+
+//
+// Assembler snippets for one bit cell. Each puts a level on the line in the 4th cycle
+//   of the slot (whichever branch is taken), then waits out the rest of the cell.
+//
+#define CRICKET_ASM_WAIT                                                                \
+    "ldi  %[Count],%[Loops]"    "\n\t"                                                  \
+    "1: dec %[Count]"           "\n\t"                                                  \
+    "brne 1b"                   "\n\t"                                                  \
+    ".rept %[Nops]"             "\n\t"                                                  \
+    "nop"                       "\n\t"                                                  \
+    ".endr"                     "\n\t"
+
+#define CRICKET_ASM_LEVEL(_Reg_)                                                        \
+    "nop"                       "\n\t"                                                  \
+    "nop"                       "\n\t"                                                  \
+    "mov  %[Temp],%[" _Reg_ "]" "\n\t"                                                  \
+    "out  %[Port],%[Temp]"      "\n\t"                                                  \
+    CRICKET_ASM_WAIT
+
+#define CRICKET_ASM_DATA(_Bit_)                                                         \
+    "mov  %[Temp],%[Low]"       "\n\t"                                                  \
+    "sbrc %[Byte]," #_Bit_      "\n\t"                                                  \
+    "mov  %[Temp],%[High]"      "\n\t"                                                  \
+    "out  %[Port],%[Temp]"      "\n\t"                                                  \
+    CRICKET_ASM_WAIT
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////////
 //
@@ -106,37 +346,74 @@ void CricketBusInit(void) {
 // Inputs:      Byte to send
 //              TRUE if this is a command byte
 //
-// Outputs:     None.
+// Outputs:     TRUE (always)
 //
-void CricketBusPut(uint8_t Byte,bool Command) {
+bool CricketBusPut(uint8_t Byte,bool Command) {
 
     //
     // The Cricket bus requires some specific timing, and the arduino interrupt latency
     //   cannot be guaranteed.
     //
-    // Just bit-bang it and hope for the best
+    // Just bit-bang it with interrupts off. On the AVR the whole byte is one unrolled
+    //   block of assembler with constant-time branches, so each cell is exactly
+    //   CRICKET_BIT_CYCLES long on any clock - no need to retune for 8MHz, 16MHz &c.
     //
-    // Most Arduinos (nano, &c) run at 16MHz clock speed. The loop and if-statement
-    //   below take up most of a microsecond, so the BIT_DELAY time is shortened
-    //   from 10uS (per the cricket bus spec) to 9uS to compensate. This then shows
-    //   each individual bit for almost exactly 10 uS.
-    //
-    // When running at a significantly slower clock speed, adjust the delay time as 
-    //   appropriate; for example, when running at 8MHz the loop will take twice
-    //   as long, so the delay should be 8uS instead of 9uS.
-    //
-    // When running at a significantly higher speed, such as 80MHz (an STM32, for
-    //   example), the loop time will be negligible. In that case you should use
-    //   the bus spec 10uS delay time.
+    // Other processors (such as an 80 MHz STM32) get the plain C version, where the
+    //   loop overhead is negligible compared to the bus spec 10uS delay time.
     //
+#if defined(__AVR__)
+    uint8_t High;
+    uint8_t Low;
+    uint8_t Cmd;
+    uint8_t Temp;
+    uint8_t Count;
+
     cli();                                          // Disable interrupts
 
-#define BIT_DELAY   9                               // Bit delay time, in uS. See comment above
+    High = _PORT(CRICKET_BUS_PORT) |  _PIN_MASK(CRICKET_BUS_PIN);
+    Low  = _PORT(CRICKET_BUS_PORT) & ~_PIN_MASK(CRICKET_BUS_PIN);
+    Cmd  = Command ? Low : High;
+
+    __asm__ __volatile__ (
+        CRICKET_ASM_LEVEL("Low")                    // Pre-start, 10 cells low
+        ".rept 9"                   "\n\t"
+        "nop"                       "\n\t"
+        "nop"                       "\n\t"
+        "nop"                       "\n\t"
+        "nop"                       "\n\t"
+        CRICKET_ASM_WAIT
+        ".endr"                     "\n\t"
+        CRICKET_ASM_LEVEL("High")                   // Start bit
+        CRICKET_ASM_DATA(0)                         // Data, lowest bit first
+        CRICKET_ASM_DATA(1)
+        CRICKET_ASM_DATA(2)
+        CRICKET_ASM_DATA(3)
+        CRICKET_ASM_DATA(4)
+        CRICKET_ASM_DATA(5)
+        CRICKET_ASM_DATA(6)
+        CRICKET_ASM_DATA(7)
+        CRICKET_ASM_LEVEL("Cmd")                    // Command bit
+        CRICKET_ASM_LEVEL("High")                   // Stop bit
+        : [Temp]  "=&r" (Temp),
+          [Count] "=&d" (Count)
+        : [Port]  "I"   (_SFR_IO_ADDR(_PORT(CRICKET_BUS_PORT))),
+          [Byte]  "r"   (Byte),
+          [High]  "r"   (High),
+          [Low]   "r"   (Low),
+          [Cmd]   "r"   (Cmd),
+          [Loops] "n"   (CRICKET_WAIT_LOOPS),
+          [Nops]  "n"   (CRICKET_WAIT_NOPS)
+        );
+
+    sei();                                          // Enable interrupts
+
+#else
+    cli();                                          // Disable interrupts
 
     CRICKET_LOW;
-    _delay_us(100);     // Pre-start
+    _delay_us(CRICKET_PRESTART_US);                 // Pre-start
     CRICKET_HIGH;
-    _delay_us(10);      // Start bit
+    _delay_us(CRICKET_BIT_US);                      // Start bit
 
     //
     // Send the byte data, lowest bit first
@@ -145,14 +422,494 @@ void CricketBusPut(uint8_t Byte,bool Command) {
         if( Byte & 0x01 ) { CRICKET_HIGH; }
         else              { CRICKET_LOW;  }
         Byte >>= 1;
-        _delay_us(BIT_DELAY);
+        _delay_us(CRICKET_BIT_US);
         }
 
     if( Command ) { CRICKET_LOW;  }
     else          { CRICKET_HIGH; }
-    _delay_us(10);      // Command bit
+    _delay_us(CRICKET_BIT_US);                      // Command bit
     CRICKET_HIGH;
+    _delay_us(CRICKET_BIT_US);                      // Stop bit
 
     sei();                                          // Enable interrupts
+#endif
+
+    Bus.Posted++;
+    Bus.Sent++;
+
+    return(true);
+    }
+
+#else
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketBusPut - Send one byte and command bit out the cricket bus
+//
+// Send a byte out the bus. We encode the byte, stuff it into the FIFO and enable
+//   interrupts - at some point the interrupt handler will get to it and send it out
+//   for us.
+//
+// Same code for all queued drivers, only the interrupt handlers differ.
+//
+// Inputs:      Byte to send
+//              TRUE if this is a command byte
+//
+// Outputs:     TRUE  if byte was queued OK,
+//              FALSE if FIFO full
+//
+bool CricketBusPut(uint8_t Byte,bool Command) {
+    uint8_t NewIn;
+    bool    Success = false;
+    bool    Empty;
+#if CRICKET_BUS_ISR_PUT
+    uint8_t SaveSREG = SREG;
+
+    cli();                                      // Other interrupts put too
+#else
+    CRICKET_INT_OFF;                            // Disable bus interrupts
+#endif
+
+    Empty = Bus.FIFO_In == Bus.FIFO_Out;
+
+    //
+    // If there's room in the buffer, add the new byte
+    //
+    NewIn = (Bus.FIFO_In+1) & CRICKET_FIFO_WRAP;
+
+    if( NewIn != Bus.FIFO_Out ) {
+        Bus.FIFO[Bus.FIFO_In] = CRICKET_WIRE(Byte,Command);
+        Bus.FIFO_In           = NewIn;
+        Bus.Posted++;
+        Success = true;
+        }
+
+    //
+    // If the transmitter is idle, get it going. If held, the interrupt stays off
+    //   until CricketBusStartAt, and once that's armed the kick is already set.
+    //
+    // Only the first byte into an idle bus kicks: bytes put before the kick goes off
+    //   mustn't push it back, or a fast enough caller would never see it go.
+    //
+    if( Bus.Hold != HOLD_HELD ) {
+        if( Empty && !Bus.Active && Bus.Hold == HOLD_NONE )
+            CRICKET_START;
+
+        CRICKET_INT_ON;                         // Enable bus interrupts
+        }
+
+#if CRICKET_BUS_ISR_PUT
+    SREG = SaveSREG;
+#endif
+
+    return(Success);
+    }
+
+#endif
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketBusBusy   - Return TRUE if bus is busy sending output
+// CricketBusQueued - Return number of bytes not yet completely sent
+// CricketBusRoom   - Return number of free FIFO slots
+//
+// Inputs:      None.
+//
+// Outputs:     As above
+//
+bool CricketBusBusy(void) { return( Bus.Active || Bus.FIFO_In != Bus.FIFO_Out ); }
+
+uint8_t CricketBusQueued(void) { return( (uint8_t) (CricketBusPosted() - CricketBusSent()) ); }
+
+uint8_t CricketBusRoom(void) { 
+    return( (Bus.FIFO_Out - Bus.FIFO_In - 1) & CRICKET_FIFO_WRAP ); 
+    }
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketBusPosted - Return running count of bytes accepted by CricketBusPut
+// CricketBusSent   - Return running count of bytes completely sent
+//
+// Inputs:      None.
+//
+// Outputs:     As above
+//
+uint16_t CricketBusPosted(void) { 
+    uint8_t     SaveSREG = SREG;
+    uint16_t    Posted;
+
+    cli();                                      // Count is updated by the ISR
+    Posted = Bus.Posted;
+    SREG = SaveSREG;
+
+    return(Posted);
+    }
+
+uint16_t CricketBusSent(void) { 
+    uint8_t     SaveSREG = SREG;
+    uint16_t    Sent;
+
+    cli();                                      // Count is updated by the ISR
+    Sent = Bus.Sent;
+    SREG = SaveSREG;
+
+    return(Sent);
+    }
+
+#if CRICKET_BUS_DRIVER == CRICKET_DRIVER_TIMER || CRICKET_BUS_DRIVER == CRICKET_DRIVER_OCR
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketBusHold - Hold the transmitter idle, so that bytes put wait in the FIFO
+//
+// Inputs:      None.
+//
+// Outputs:     TRUE  if held
+//              FALSE if the bus is busy (can't hold)
+//
+bool CricketBusHold(void) {
+    uint8_t SaveSREG = SREG;
+    bool    Held;
+
+    cli();
+    if( !Bus.Active && Bus.FIFO_In == Bus.FIFO_Out && Bus.Hold == HOLD_NONE )
+        Bus.Hold = HOLD_HELD;
+    Held = Bus.Hold == HOLD_HELD;
+    SREG = SaveSREG;
+
+    return(Held);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketBusStartAt - Release a hold, with the first start bit at a given time
+//
+// The idle kick is programmed CRICKET_START_LEAD counts (one pre-start, plus the OCR
+//   driver's kick delay) ahead, so that the start bit of the first byte goes out at
+//   the given time. If that's too close, sending starts right away.
+//
+// Timer1 wraps every 65536 counts, so the time is given as counts from a Timer1 time
+//   before the call. The kick must be no more than 65535 counts after that.
+//
+// The time the start bit actually went out is saved for CricketBusStarted().
+//
+// Inputs:      Timer1 time from before the call
+//              Counts from then to the first start bit (0 == right away)
+//
+// Outputs:     None.
+//
+void CricketBusStartAt(uint16_t Now,uint32_t Ahead) {
+    uint16_t Kick = Now + (uint16_t) (Ahead - CRICKET_START_LEAD);
+
+    if( Bus.Hold != HOLD_HELD )
+        return;
+
+    CRICKET_INT_OFF;
+
+    Bus.Stamped = false;
+
+    if( Bus.FIFO_In == Bus.FIFO_Out ) {
+        Bus.Hold = HOLD_NONE;                   // Nothing to send
+        return;
+        }
+
+    Bus.Hold = HOLD_ARMED;
+
+    //
+    // Go now if the kick is already past, or too close to program
+    //
+    if( Ahead < CRICKET_START_LEAD ||
+        (uint32_t) (uint16_t) (TCNT1 - Now) + CRICKET_KICK_TICKS >= Ahead - CRICKET_START_LEAD ) {
+        CRICKET_START;
+        }
+    else {
+        CRICKET_OCR = Kick;
+        TIFR1       = _PIN_MASK(CRICKET_OCF);   // Clear any stale match
+        }
+
+    CRICKET_INT_ON;
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketBusStarted - Return the time of the start bit from CricketBusStartAt
+//
+// Inputs:      Where to put the Timer1 time of the start bit
+//
+// Outputs:     TRUE  if the start bit has gone out (*When is set, once)
+//              FALSE if not yet
+//
+bool CricketBusStarted(uint16_t *When) {
+    uint8_t SaveSREG = SREG;
+    bool    Started  = false;
+
+    cli();
+    if( Bus.Stamped ) {
+        *When       = Bus.StartTime;
+        Bus.Stamped = false;
+        Started     = true;
+        }
+    SREG = SaveSREG;
+
+    return(Started);
+    }
+
+#endif
+
+#if CRICKET_BUS_DRIVER == CRICKET_DRIVER_TIMER
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// TIMER1_COMPx_vect - Clock out the next bus state
+//
+// Called at each bit boundary. Sets the line to the next wire bit, or at the end of a
+//   byte pulls the next byte from the FIFO and starts its pre-start. If no more, turn
+//   off interrupt.
+//
+// Inputs:      None. (ISR)
+//
+// Outputs:     None.
+//
+ISR(CRICKET_VECT) {
+
+    //
+    // Mid-byte: put the next bit on the wire
+    //
+    if( Bus.Wire ) {
+        if( Bus.Wire & 0x01 ) { CRICKET_HIGH; }
+        else                  { CRICKET_LOW;  }
+        if( Bus.Hold == HOLD_ARMED ) {
+            Bus.StartTime = TCNT1;
+            Bus.Stamped   = true;
+            Bus.Hold      = HOLD_NONE;
+            }
+        Bus.Wire >>= 1;
+        CRICKET_OCR += CRICKET_BIT_TICKS;
+        }
+
+    //
+    // End of byte (or idle kick): start the next one, if any.
+    //
+    else {
+        if( Bus.Active ) {
+            Bus.Active = false;
+            Bus.Sent++;
+            }
+
+        if( Bus.FIFO_In != Bus.FIFO_Out ) {
+            CRICKET_LOW;                                // Pre-start
+            CRICKET_OCR += CRICKET_PRESTART_TICKS;
+            Bus.Wire     = Bus.FIFO[Bus.FIFO_Out];
+            Bus.FIFO_Out = (Bus.FIFO_Out+1) & CRICKET_FIFO_WRAP;
+            Bus.Active   = true;
+            }
+
+        //
+        // Else turn off interrupts, for now. Line stays high (idle).
+        //
+        else _CLR_BIT(TIMSK1,CRICKET_OCIE);
+        }
+    }
+
+#elif CRICKET_BUS_DRIVER == CRICKET_DRIVER_OCR
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// TIMER1_COMPx_vect - Program the next bus edge
+//
+// The compare unit has just changed the pin (or left it alone) at the programmed time.
+//   Work out when the line next needs to change level, and program the compare unit to
+//   do that. Runs of equal bits take a single interrupt, and the edge timing does not
+//   depend on interrupt latency as long as we get here within one bit time.
+//
+// Inputs:      None. (ISR)
+//
+// Outputs:     None.
+//
+ISR(CRICKET_VECT) {
+
+    //
+    // If the previous byte's stop bit ended at this match, count it as sent.
+    //
+    if( Bus.Done ) {
+        Bus.Done = false;
+        Bus.Sent++;
+        }
+
+    switch( Bus.Phase ) {
+
+        //
+        // Pre-start low began at this match: next edge is the start bit.
+        //
+        case PHASE_PRESTART:
+            CRICKET_NEXT_HIGH;
+            CRICKET_OCR += CRICKET_PRESTART_TICKS;
+            Bus.Level    = 1;
+            Bus.Phase    = PHASE_BITS;
+            if( Bus.Hold == HOLD_ARMED ) {
+                Bus.StartTime = CRICKET_OCR;    // Hardware makes the edge exactly then
+                Bus.Stamped   = true;
+                Bus.Hold      = HOLD_NONE;
+                }
+            break;
+
+        //
+        // A new bit cell began at this match. Skip ahead over cells with the same
+        //   level to find the next edge. The stop bit leaves the line high, so if
+        //   no edge remains the byte is done at the end of the run, and the next
+        //   byte's pre-start (if any) can start right there.
+        //
+        case PHASE_BITS: {
+            uint16_t Run = CRICKET_BIT_TICKS;
+
+            Bus.Wire >>= 1;
+            while( Bus.Wire && (Bus.Wire & 0x01) == Bus.Level ) {
+                Bus.Wire >>= 1;
+                Run      += CRICKET_BIT_TICKS;
+                }
+
+            CRICKET_OCR += Run;
+
+            if( Bus.Wire ) {
+                Bus.Level = Bus.Wire & 0x01;
+                if( Bus.Level ) { CRICKET_NEXT_HIGH; }
+                else            { CRICKET_NEXT_LOW;  }
+                break;
+                }
+
+            Bus.Done = true;
+
+            if( Bus.FIFO_In != Bus.FIFO_Out ) {
+                CRICKET_NEXT_LOW;                       // Next pre-start
+                Bus.Wire     = Bus.FIFO[Bus.FIFO_Out];
+                Bus.FIFO_Out = (Bus.FIFO_Out+1) & CRICKET_FIFO_WRAP;
+                Bus.Level    = 0;
+                Bus.Phase    = PHASE_PRESTART;
+                }
+            else {
+                CRICKET_NEXT_HIGH;                      // No change, line is idle
+                Bus.Phase = PHASE_NEXT;
+                }
+            break;
+            }
+
+        //
+        // Idle kick, or the FIFO ran dry: start the next byte, if any. Else turn
+        //   off interrupts, for now. Line stays high (idle).
+        //
+        default:
+            if( Bus.FIFO_In != Bus.FIFO_Out ) {
+                CRICKET_NEXT_LOW;                       // Pre-start
+                CRICKET_OCR += CRICKET_KICK_TICKS;
+                Bus.Wire     = Bus.FIFO[Bus.FIFO_Out];
+                Bus.FIFO_Out = (Bus.FIFO_Out+1) & CRICKET_FIFO_WRAP;
+                Bus.Active   = true;
+                Bus.Level    = 0;
+                Bus.Phase    = PHASE_PRESTART;
+                }
+            else {
+                Bus.Active = false;
+                _CLR_BIT(TIMSK1,CRICKET_OCIE);
+                }
+            break;
+        }
+    }
+
+#elif CRICKET_BUS_DRIVER == CRICKET_DRIVER_USART
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// USART1_UDRE_vect - Queue up the next 8 bus bits
+//
+// Each bus byte is three SPI bytes: one of pre-start, then the two bytes of the wire
+//   image from the FIFO. The USART double buffers, so the stream is continuous as long
+//   as we get here within 8 bit times. If no more, turn off interrupt and let the
+//   Tx complete handler shut down the transmitter.
+//
+// Inputs:      None. (ISR)
+//
+// Outputs:     None.
+//
+ISR(USART1_UDRE_vect) {
+
+    switch( Bus.Phase ) {
+
+        case 0:
+            if( Bus.FIFO_In != Bus.FIFO_Out ) {
+                UDR1         = 0x00;                    // Pre-start, first 8 bits
+                Bus.Wire     = Bus.FIFO[Bus.FIFO_Out];
+                Bus.FIFO_Out = (Bus.FIFO_Out+1) & CRICKET_FIFO_WRAP;
+                Bus.Phase    = 1;
+                }
+            else {
+                _CLR_BIT(UCSR1B,UDRIE1);                // Disable buffer empty interrupt
+                _SET_BIT(UCSR1A,TXC1);                  // Clear stale Tx complete
+                _SET_BIT(UCSR1B,TXCIE1);                // Shut down when done
+                }
+            break;
+
+        //
+        // The pre-start byte moved to the shifter, so the previous bus byte is out.
+        //
+        case 1:
+            if( Bus.Done ) {
+                Bus.Done = false;
+                Bus.Sent++;
+                }
+            UDR1      = Bus.Wire & 0xFF;
+            Bus.Phase = 2;
+            break;
+
+        default:
+            UDR1      = Bus.Wire >> 8;
+            Bus.Done  = true;
+            Bus.Phase = 0;
+            break;
+        }
+    }
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// USART1_TX_vect - All bits shifted out, shut down the transmitter
+//
+// Turning off the transmitter hands the pin back to the port, which holds the line
+//   high until the next byte.
+//
+// Inputs:      None. (ISR)
+//
+// Outputs:     None.
+//
+ISR(USART1_TX_vect) {
+
+    _CLR_BIT(UCSR1B,TXCIE1);
+
+    //
+    // If more data arrived while we were finishing up, just keep going. A put that
+    //   landed with this interrupt pending re-enabled the buffer empty interrupt, which
+    //   comes first and may already have taken the byte, leaving the FIFO empty with
+    //   that byte on its way out: only shut down if the buffer empty side is idle too.
+    //
+    if( Bus.FIFO_In == Bus.FIFO_Out && !_BIT_ON(UCSR1B,UDRIE1) && Bus.Phase == 0 ) {
+        if( Bus.Done ) {
+            Bus.Done = false;
+            Bus.Sent++;
+            }
+
+        _CLR_BIT(UCSR1B,TXEN1);
+        Bus.Active = false;
+        }
     }
 
+#endif
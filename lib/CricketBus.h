@@ -25,9 +25,19 @@
 //      CricketBusPut(0x100,true);          // Send 0x100 as command to cricket bus
 //      CricketBusPut(0x203,false);         // Send 0x203 as data (ie - not command) to bus
 //
+//      bool Success = CricketBusPut(0x10,true);    // == FALSE if bus FIFO was full
+//      CricketBusPutW(0x10,true);                  // Block until queued
+//
+//      if( CricketBusBusy() ) ...                  // TRUE if still sending something
+//      uint8_t Queued = CricketBusQueued();        // Number of bytes not yet sent
+//
+//      uint16_t Ticket = CricketBusPosted();
+//      ...
+//      if( CricketBusDone(Ticket) ) ...            // TRUE when all up to Ticket are sent
+//
 //      //////////////////////////////////////
 //      //
-//      // Cricket LED specific calls
+//      // Cricket LED specific calls (#include "CricketLED.h")
 //      //
 //      In the calls below, ID can be zero (for "any"), or 1 or 2 to identify
 //        which of two LED displays are connected. See Crickey LED display documentation for
@@ -37,7 +47,9 @@
 //      CricketLEDHex(0x1025,ID)            // Display numeric "1025" on LED display
 //      CricketLEDBright(7,ID)              // Set brightness level to 7
 //
-//      CricketLEDPat(a,b,c,d,ID)           // Set segments based on pattern (see notes below)
+//      CricketLEDPat(a,b,c,d,ID)           // Set segments based on pattern (see CricketLED.h)
+//
+//      CricketLEDRefresh(ID)               // Resend display state, after a power glitch
 //
 //  DESCRIPTION
 //
@@ -49,6 +61,29 @@
 //        due to interrupt latency. It's also fairly fast, so transmission is done
 //        bit-bang with approprtiate wait states.
 //
+//      With CRICKET_BUS_DRIVER set to CRICKET_DRIVER_TIMER (the default), bytes are
+//        queued in a FIFO and clocked out by the Timer1 compare interrupt, so the
+//        CricketBusPut() and CricketLEDxxx() calls return right away. Timer1 is free
+//        running at the CPU clock and belongs to this module in that case.
+//
+//      With CRICKET_DRIVER_OCR, bytes are queued as above but the bus line is the
+//        Timer1 output compare pin (OC1A or OC1B). The timer hardware sets or clears
+//        the pin at precomputed compare values and the interrupt only programs the
+//        next edge, so edges are exact to the clock cycle even with the UART and other
+//        interrupts running.
+//
+//      With CRICKET_DRIVER_USART (ATmega1284P and ATmega2560 only), the spare USART1
+//        runs in master SPI mode at exactly 100 Kbit/s. Each byte is encoded once by
+//        CricketBusPut() and shifted out from the FIFO by the USART, a few instructions
+//        per 8 bus bits. The bus line is TXD1 (PD3), and XCK1 is driven as well.
+//
+//      With CRICKET_DRIVER_BITBANG, CricketBusPut() sends the byte before returning,
+//        with interrupts disabled, as in the original driver.
+//
+//      CRICKET_DRIVER_LINUX is for Linux gateways rather than the AVR: the same calls,
+//        with a real-time thread driving a GPIO line. It's CricketBusLinux.c in place
+//        of this file (see CricketBusLinux.h).
+//
 //////////////////////////////////////////////////////////////////////////////////////////
 //
 //  MIT LICENSE
@@ -79,6 +114,12 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#define CRICKET_DRIVER_BITBANG  0           // Blocking bit-bang, interrupts off
+#define CRICKET_DRIVER_TIMER    1           // Queued, Timer1 compare interrupt
+#define CRICKET_DRIVER_OCR      2           // Queued, Timer1 output compare pin
+#define CRICKET_DRIVER_USART    3           // Queued, USART1 master SPI shifter
+#define CRICKET_DRIVER_LINUX    4           // Queued, Linux GPIO line from a thread
+
 //////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////
 //
@@ -87,6 +128,60 @@
 #define CRICKET_BUS_PORT    D
 #define CRICKET_BUS_PIN     7
 
+#ifndef CRICKET_BUS_DRIVER
+#define CRICKET_BUS_DRIVER  CRICKET_DRIVER_TIMER
+#endif
+
+//
+// Timer1 compare channel (A or B) used by the timer and OCR drivers. With the OCR
+//   driver the port and pin above must be that channel's output pin:
+//
+//      ATmega328P      OC1A = B,1      OC1B = B,2
+//      ATmega1284P     OC1A = D,5      OC1B = D,4
+//      ATmega2560      OC1A = B,5      OC1B = B,6
+//
+#ifndef CRICKET_BUS_OC
+#define CRICKET_BUS_OC      A
+#endif
+
+//
+// With the USART driver the port and pin above must be TXD1 (D,3 on both chips).
+//
+
+//
+// The bus FIFO must be a power of two long, since the code uses a mask for wraparound.
+//
+#ifndef CRICKET_FIFO_SIZE
+#define CRICKET_FIFO_SIZE   (1 << 5)        // == 32 byte Tx FIFO (5 LED pattern frames)
+#endif
+
+//
+// FIFO bytes that CricketBusPutW leaves free. Motor and relay frames (CricketMotor.h,
+//   CricketRelay.h) go out with CricketBusPut once there's room for the whole frame,
+//   so this keeps a display loop that fills the FIFO from shutting them out. At least
+//   the longest such frame.
+//
+#ifndef CRICKET_FIFO_RESERVE
+#define CRICKET_FIFO_RESERVE 3
+#endif
+
+//
+// Set to 1 if CricketBusPut is called from an interrupt other than the bus one, as
+//   CricketDeadline.c does from the Timer1 overflow. CricketBusPut then shuts off all
+//   interrupts while it updates the FIFO, rather than just the bus interrupt.
+//
+#ifndef CRICKET_BUS_ISR_PUT
+#define CRICKET_BUS_ISR_PUT 1
+#endif
+
+//
+// Tick period for the modules that do things over time (CricketSched, &c). The
+//   application calls their xxxTick() functions once every CRICKET_TICK_MS.
+//
+#ifndef CRICKET_TICK_MS
+#define CRICKET_TICK_MS     10
+#endif
+
 //
 // End of user configurable options
 //
@@ -109,6 +204,25 @@
 #define CRICKET_LED_HEX     0x20            // Next two  bytes show number in hex
 #define CRICKET_LED_NUMBER  0x00            // Next two  bytes show number in decimal
 
+//
+// Bus timing, per the cricket bus spec. Each byte is a pre-start low, then a start bit,
+//   8 data bits (LSB first), the command bit and a stop bit, all high unless noted.
+//
+#define CRICKET_PRESTART_US 100             // Pre-start (line low)
+#define CRICKET_BIT_US      10              // Each bit cell
+#if CRICKET_BUS_DRIVER == CRICKET_DRIVER_USART
+#define CRICKET_STOP_BITS   4               // Pads each byte to 24 SPI bits
+#else
+#define CRICKET_STOP_BITS   1
+#endif
+#define CRICKET_BYTE_BITS   (10+CRICKET_STOP_BITS)  // Start + 8 data + command + stop
+#define CRICKET_BYTE_US     (CRICKET_PRESTART_US+CRICKET_BYTE_BITS*CRICKET_BIT_US)
+#define CRICKET_FRAME_US(_Len_) ((_Len_)*CRICKET_BYTE_US)  // Bus time for _Len_ bytes
+
+#define CRICKET_BIT_CYCLES  ((F_CPU+50000UL)/100000UL)  // CPU cycles per bit, rounded
+
+#define CRICKET_US_TICKS(_us_)  ((uint16_t) (((F_CPU/1000UL)*(_us_))/1000UL))  // Clk/1 counts
+
 //////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////
 //
@@ -128,97 +242,108 @@ void CricketBusInit(void);
 //
 // CricketBusPut - Send one byte and command bit out the cricket bus
 //
-// Send a byte out the serial port, and the command bit.
+// Send a byte out the serial port, and the command bit. With the timer driver the
+//   byte is placed in the FIFO and sent by the interrupt handler later on.
 //
 // Inputs:      Byte to send
 //              TRUE if this is a command byte
 //
-// Outputs:     None.
+// Outputs:     TRUE  if byte was queued (or sent) OK,
+//              FALSE if FIFO full
 //
-void CricketBusPut(uint8_t Byte,bool Command);
+bool CricketBusPut(uint8_t Byte,bool Command);
 
 ///////////////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////////
 //
-// CricketLEDDec - Display one 16-bit number in decimal
+// CricketBusPutW - Send one byte and command bit, wait for FIFO space
+//
+// Like CricketBusPut, but will block [if no FIFO space] until queued. Leaves
+//   CRICKET_FIFO_RESERVE bytes free, for CricketBusPut callers that check for room.
 //
-// Inputs:      Number to display
-//              Device ID (0 or 1)
+// Inputs:      Byte to send
+//              TRUE if this is a command byte
 //
 // Outputs:     None.
 //
-#define CricketLEDDec(_Number_,_ID_) {                                                      \
-    CricketBusPut(CRICKET_BUS_LED          ,true);                                          \
-    CricketBusPut(CRICKET_LED_NUMBER+(_ID_),false);                                         \
-    CricketBusPut(((_Number_) >> 8) & 0xFF ,false);                                         \
-    CricketBusPut(((_Number_) >> 0) & 0xFF ,false);                                         \
+#define CricketBusPutW(_Byte_,_Command_) {                                              \
+    uint8_t _PutW_ = (_Byte_);                  /* Evaluate once, not per try */        \
+    while( CricketBusRoom() <= CRICKET_FIFO_RESERVE ||                                  \
+           !CricketBusPut(_PutW_,_Command_) );                                          \
     }
 
 ///////////////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////////
 //
-// CricketLEDHex - Display one 16-bit number in hexadecimal
+// CricketBusBusy   - Return TRUE if bus is busy sending output
+// CricketBusQueued - Return number of bytes not yet completely sent
+// CricketBusRoom   - Return number of free FIFO slots
 //
-// Inputs:      Number to display
-//              Device ID (0 or 1)
+// Inputs:      None.
 //
-// Outputs:     None.
+// Outputs:     As above
 //
-#define CricketLEDHex(_Number_,_ID_) {                                                      \
-    CricketBusPut(CRICKET_BUS_LED          ,true);                                          \
-    CricketBusPut(CRICKET_LED_HEX+(_ID_)   ,false);                                         \
-    CricketBusPut(((_Number_) >> 8) & 0xFF ,false);                                         \
-    CricketBusPut(((_Number_) >> 0) & 0xFF ,false);                                         \
-    }
+bool    CricketBusBusy  (void);
+uint8_t CricketBusQueued(void);
+uint8_t CricketBusRoom  (void);
 
 ///////////////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////////
 //
-// CricketLEDBright - Set the display brightness level (1-7)
+// CricketBusPosted - Return running count of bytes accepted by CricketBusPut
+// CricketBusSent   - Return running count of bytes completely sent
+// CricketBusDone   - Return TRUE if all bytes up to a CricketBusPosted() ticket are sent
 //
-// Inputs:      Brightness level 1-7
-//              [Optional] Device ID (0 or 1)
+// The counts wrap at 16 bits. CricketBusDone() doesn't compare them directly, since a
+//   ticket over 32K bytes old would then read as not yet sent: it checks that the bytes
+//   posted since the ticket cover everything still queued, which holds for any ticket
+//   once its bytes are gone.
 //
-// Outputs:     None.
+// Inputs:      [CricketBusDone] Ticket from CricketBusPosted()
 //
-#define CricketLEDBright(_Level_,_ID_) {                                                    \
-    CricketBusPut(CRICKET_BUS_LED          ,true);                                          \
-    CricketBusPut(CRICKET_LED_BRIGHT+(_ID_),false);                                         \
-    CricketBusPut(                        0,false);                                         \
-    CricketBusPut(         (_Level_) & 0x07,false);                                         \
-    }
+// Outputs:     As above
+//
+uint16_t CricketBusPosted(void);
+uint16_t CricketBusSent  (void);
+
+#define CricketBusDone(_Ticket_)    ((uint16_t)(CricketBusPosted()-(_Ticket_)) >= CricketBusQueued())
 
+#if CRICKET_BUS_DRIVER == CRICKET_DRIVER_TIMER || CRICKET_BUS_DRIVER == CRICKET_DRIVER_OCR
 ///////////////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////////
 //
-// CricketLEDPat - Set the display based on a pattern
+// CricketBusHold    - Hold the transmitter idle, so that bytes put wait in the FIFO
+// CricketBusStartAt - Release a hold, with the first start bit at a given Timer1 time
+// CricketBusStarted - Return the Timer1 time that start bit actually went out
 //
-// Inputs:      Pattern, as four bytes, each bit representing a digit segment
-//              [Optional] Device ID (0 or 1)
+// For sending at a set time (see CricketDeadline.h). Timer and OCR drivers only, since
+//   they run Timer1 at the CPU clock. The hold only succeeds with the bus idle, and
+//   CricketBusStartAt starts right away if the time is too close.
 //
-// Outputs:     None.
+// CricketBusStartAt programs a kick CRICKET_START_LEAD counts ahead of the start bit,
+//   which must be no more than 65535 counts after Now. So the start bit can be up to
+//   65535 + CRICKET_START_LEAD counts ahead.
 //
-//                   bit 0
-//                 ----------
-//                |          |
-//                |          |
-//             5  |          |  1
-//                |    6     |
-//                 ----------
-//                |          |
-//                |          |
-//             4  |          |  2
-//                |    3     |
-//                 ----------  
-//                              x bit 7
-//
-#define CricketLEDPat(_Dig1_,_Dig2_,_Dig3_,_Dig4_,_ID_) {                                \
-    CricketBusPut(CRICKET_BUS_LED       ,true);                                          \
-    CricketBusPut(CRICKET_LED_PAT+(_ID_),false);                                         \
-    CricketBusPut(_Dig1_,false);                                                         \
-    CricketBusPut(_Dig2_,false);                                                         \
-    CricketBusPut(_Dig3_,false);                                                         \
-    CricketBusPut(_Dig4_,false);                                                         \
-    }
+// Inputs:      [CricketBusStartAt] A Timer1 time from before the call, and counts
+//                from then to the first start bit (0 == right away)
+//              [CricketBusStarted] Where to put the Timer1 time of that start bit
+//
+// Outputs:     [CricketBusHold]    TRUE if held, FALSE if the bus is busy
+//              [CricketBusStarted] TRUE once the start bit is out (*When is set, once)
+//
+bool CricketBusHold   (void);
+void CricketBusStartAt(uint16_t Now,uint32_t Ahead);
+bool CricketBusStarted(uint16_t *When);
+
+//
+// Timer1 counts from the kick to the first start bit: the pre-start, and for the OCR
+//   driver one kick delay (a bit time) before that
+//
+#if CRICKET_BUS_DRIVER == CRICKET_DRIVER_OCR
+#define CRICKET_START_LEAD  (CRICKET_US_TICKS(CRICKET_BIT_US)+CRICKET_US_TICKS(CRICKET_PRESTART_US))
+#else
+#define CRICKET_START_LEAD  CRICKET_US_TICKS(CRICKET_PRESTART_US)
+#endif
+#endif
 
 #endif  // CRICKETBUS_H - entire file
@@ -0,0 +1,200 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      CricketBusEdge.h - Cricket bus byte decoder, from edge times
+//
+//  SYNOPSIS
+//
+//      #include "CricketBusEdge.h"
+//
+//      CRICKET_EDGE Decode;                // Phase CRICKET_EDGE_IDLE to decode
+//
+//      //////////////////////////////////////
+//      //
+//      // In the edge interrupt. Times are Timer1 ticks, bit timing is in ticks too.
+//      //
+//      if( CricketEdge(&Decode,Time,Level,BIT_TICKS,PRESTART_MIN) )
+//          OCR1B = Time + CRICKET_EDGE_END(BIT_TICKS); // Start bit: time the byte end
+//
+//      //////////////////////////////////////
+//      //
+//      // In the compare interrupt, middle of the stop bit
+//      //
+//      uint16_t Wire = CricketEdgeDone(&Decode,OCR1B);
+//
+//      CRICKET_WIRE_BYTE(Wire)             // Data byte
+//      CRICKET_WIRE_COMMAND(Wire)          // TRUE if the command bit was set (low)
+//      CRICKET_WIRE_FRAMING(Wire)          // TRUE if the start or stop bit was low
+//
+//  DESCRIPTION
+//
+//      The edge decoder used by the bus receiver (CricketBusRx.c) and the sniffer
+//        (CricketSniffer.c).
+//
+//      A pre-start low of at least the minimum, followed by a rising edge, starts a
+//        byte. Every bit cell that ended at or before an edge (give or take half a
+//        bit) had the old level, and the cells after the last edge are filled in at
+//        the middle of the stop bit.
+//
+//  NOTES
+//
+//      Each user runs Timer1 at its own rate, so the bit timing is passed in. The
+//        functions are inline, and with constant timing it all folds away.
+//
+//      Call from interrupt handlers (or with interrupts off).
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CRICKETBUSEDGE_H
+#define CRICKETBUSEDGE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define CRICKET_EDGE_STOP       10          // Cells: start, 8 data, command, stop
+
+//
+// Time from the start bit edge to the middle of the stop bit
+//
+#define CRICKET_EDGE_END(_bit_) (CRICKET_EDGE_STOP*(_bit_)+(_bit_)/2)
+
+//
+// Decoded cell levels, LSB first, 1 == line high
+//
+#define CRICKET_WIRE_BYTE(_w_)      ((uint8_t) ((_w_) >> 1))
+#define CRICKET_WIRE_COMMAND(_w_)   (((_w_) & 0x0200) == 0)
+#define CRICKET_WIRE_FRAMING(_w_)   (((_w_) & 0x0001) == 0 || ((_w_) & 0x0400) == 0)
+
+enum {
+    CRICKET_EDGE_OFF = 0,               // Not decoding (edges ignored)
+    CRICKET_EDGE_IDLE,                  // Waiting for a pre-start
+    CRICKET_EDGE_PRESTART,              // Line low, maybe a pre-start
+    CRICKET_EDGE_BITS,                  // Decoding start, data, command and stop bits
+    };
+
+typedef struct {
+    uint8_t     Phase;                  // Per above
+    uint8_t     Level;                  // Line level after the last edge
+    uint16_t    Edge;                   // PRESTART: time line went low
+                                        // BITS:     time current cell ends
+    uint8_t     Cell;                   // BITS: current cell, 0 == start bit
+    uint16_t    Wire;                   // BITS: cell levels so far, LSB first
+    } CRICKET_EDGE;
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketEdge - Process one edge on the bus line
+//
+// Inputs:      Decoder
+//              Timer1 time of the edge
+//              Line level after the edge
+//              Ticks per bit
+//              Shortest pre-start, in ticks
+//
+// Outputs:     TRUE if the edge was a start bit (time the end of the byte from it)
+//
+static inline bool CricketEdge(CRICKET_EDGE *D,uint16_t Time,uint8_t Level,
+                               uint16_t BitTicks,uint16_t PrestartMin) {
+
+    if( Level == D->Level )                     // Missed a short glitch, ignore
+        return(false);
+
+    D->Level = Level;
+
+    switch( D->Phase ) {
+
+        case CRICKET_EDGE_IDLE:
+            if( !Level ) {
+                D->Edge  = Time;
+                D->Phase = CRICKET_EDGE_PRESTART;
+                }
+            break;
+
+        //
+        // Rising edge. If the line was low long enough, it's the start bit: set up the
+        //   bit cells from here.
+        //
+        case CRICKET_EDGE_PRESTART:
+            if( (uint16_t) (Time - D->Edge) < PrestartMin ) {
+                D->Phase = CRICKET_EDGE_IDLE;
+                break;
+                }
+            D->Edge  = Time + BitTicks;
+            D->Cell  = 0;
+            D->Wire  = 0;
+            D->Phase = CRICKET_EDGE_BITS;
+            return(true);
+
+        case CRICKET_EDGE_BITS:
+            while( D->Cell < CRICKET_EDGE_STOP &&
+                   (int16_t) (Time - D->Edge) > -(int16_t) (BitTicks/2) ) {
+                if( !Level )
+                    D->Wire |= 1 << D->Cell;
+                D->Cell++;
+                D->Edge += BitTicks;
+                }
+            break;
+        }
+
+    return(false);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketEdgeDone - Finish the byte, at the middle of the stop bit
+//
+// Any cells since the last edge are at the current line level. A line still low
+//   afterwards might be the next pre-start, from the end time.
+//
+// Inputs:      Decoder
+//              Timer1 time of the middle of the stop bit
+//
+// Outputs:     Cell levels, per CRICKET_WIRE_xxx()
+//
+static inline uint16_t CricketEdgeDone(CRICKET_EDGE *D,uint16_t End) {
+
+    while( D->Cell <= CRICKET_EDGE_STOP ) {
+        if( D->Level )
+            D->Wire |= 1 << D->Cell;
+        D->Cell++;
+        }
+
+    D->Phase = CRICKET_EDGE_IDLE;
+    if( !D->Level ) {                           // Stuck low: might be a pre-start
+        D->Edge  = End;
+        D->Phase = CRICKET_EDGE_PRESTART;
+        }
+
+    return(D->Wire);
+    }
+
+#endif  // CRICKETBUSEDGE_H - entire file
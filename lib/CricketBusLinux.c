@@ -0,0 +1,647 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      CricketBusLinux.c
+//
+//  SYNOPSIS
+//
+//      CricketBusInit();                   // Or CricketBusLinuxInit(&Config)
+//
+//      CricketLEDDec(1234,1);              // Queued, sent by the bus thread
+//
+//      CricketBusLinuxReport(stdout);      // Timing jitter, &c
+//      CricketBusLinuxExit();
+//
+//  DESCRIPTION
+//
+//      Cricket bus driver for Linux GPIO. See CricketBusLinux.h
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <linux/gpio.h>
+
+#include "CricketBusLinux.h"
+
+#define CRICKET_FIFO_WRAP   (CRICKET_FIFO_SIZE-1)   // Wraparound mask for FIFO
+
+//
+// Wire image of one byte, as for the timer driver (see CricketBus.c): after the
+//   pre-start, bit 0 is the start bit, 1-8 the data, 9 the command bit (low for
+//   command) and 10 the stop bit.
+//
+#define CRICKET_WIRE(_Byte_,_Command_)  ( 0x0401 | (((uint16_t) (_Byte_)) << 1) |           \
+                                          ((_Command_) ? 0 : 0x0200) )
+#define CRICKET_WIRE_CMD    0x0200
+
+#define BIT_NS              (CRICKET_BIT_US*1000ULL)
+#define PRESTART_NS         (CRICKET_PRESTART_US*1000ULL)
+#define MAX_EDGES           (CRICKET_FIFO_SIZE*(CRICKET_BYTE_BITS+1))
+
+typedef struct {
+    uint64_t    At;                         // Scheduled time, nS
+    uint8_t     Level;
+    bool        PreStart;                   // Pre-start edge of a byte
+    } EDGE;
+
+static struct {
+    uint16_t    FIFO[CRICKET_FIFO_SIZE];    // Wire images, per above
+    uint8_t     FIFO_In;                    // FIFO input  pointer
+    uint8_t     FIFO_Out;                   // FIFO output pointer
+    bool        Active;                     // TRUE if the thread is sending
+    uint16_t    Posted;                     // Bytes accepted by CricketBusPut
+    uint16_t    Sent;                       // Bytes completely sent
+
+    pthread_mutex_t Lock;                   // For all of the above, and Stats
+    pthread_cond_t  Wake;                   // To the thread: FIFO not empty, or exit
+    pthread_cond_t  Ready;                  // From the thread: up and running
+    pthread_t   Thread;
+    bool        Running;
+    bool        Up;
+    bool        Exit;
+
+    CRICKET_LINUX Config;
+    int         Fd;                         // Line request, -1 for the mock line
+    uint64_t    End;                        // When the last stop bit sent ends
+    EDGE        Edges[MAX_EDGES];           // Frame being sent
+    CRICKET_LINUX_STATS Stats;
+    } Bus = { .Lock  = PTHREAD_MUTEX_INITIALIZER,
+              .Wake  = PTHREAD_COND_INITIALIZER,
+              .Ready = PTHREAD_COND_INITIALIZER,
+              .Fd    = -1 };
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Now - Return CLOCK_MONOTONIC, in nS
+//
+static uint64_t Now(void) {
+    struct timespec Time;
+
+    clock_gettime(CLOCK_MONOTONIC,&Time);
+
+    return(Time.tv_sec*1000000000ULL + Time.tv_nsec);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// WaitUntil - Wait for a set time
+//
+// Sleep to within CRICKET_LINUX_SPIN_NS, then busy wait: clock_nanosleep() wakes up
+//   tens of uS late, which is several bit cells.
+//
+// Inputs:      Time, in nS
+//
+// Outputs:     None.
+//
+static void WaitUntil(uint64_t At) {
+
+    if( At > Now() + CRICKET_LINUX_SPIN_NS ) {
+        uint64_t        Wake = At - CRICKET_LINUX_SPIN_NS;
+        struct timespec Time = { Wake/1000000000ULL, Wake%1000000000ULL };
+
+        while( clock_nanosleep(CLOCK_MONOTONIC,TIMER_ABSTIME,&Time,NULL) == EINTR );
+        }
+
+    while( Now() < At );
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// LineOpen  - Request the line as an output, idle (high)
+// LineSet   - Set the line
+// LineClose - Release the line
+//
+// Inputs:      [LineSet] Level, and the time it was scheduled for
+//
+// Outputs:     [LineOpen] TRUE if OK, FALSE if not (errno says why)
+//              [LineSet]  Time the line was set, in nS
+//
+static bool LineOpen(void) {
+    struct gpio_v2_line_request Request;
+    int Chip;
+
+    if( Bus.Config.Chip == NULL )
+        return(true);                                   // Mock line
+
+    memset(&Request,0,sizeof(Request));
+    Request.offsets[0]                  = Bus.Config.Line;
+    Request.num_lines                   = 1;
+    Request.config.flags                = GPIO_V2_LINE_FLAG_OUTPUT;
+    Request.config.num_attrs            = 1;
+    Request.config.attrs[0].attr.id     = GPIO_V2_LINE_ATTR_ID_OUTPUT_VALUES;
+    Request.config.attrs[0].attr.values = 1;
+    Request.config.attrs[0].mask        = 1;
+    strncpy(Request.consumer,"CricketBus",sizeof(Request.consumer)-1);
+
+    if( (Chip = open(Bus.Config.Chip,O_RDWR | O_CLOEXEC)) < 0 )
+        return(false);
+
+    if( ioctl(Chip,GPIO_V2_GET_LINE_IOCTL,&Request) < 0 ) {
+        int Error = errno;
+
+        close(Chip);
+        errno = Error;
+        return(false);
+        }
+
+    close(Chip);
+    Bus.Fd = Request.fd;
+
+    return(true);
+    }
+
+static uint64_t LineSet(uint8_t Level,uint64_t At) {
+    uint64_t Actual = Now();
+
+    if( Bus.Fd >= 0 ) {
+        struct gpio_v2_line_values Values = { .bits = Level, .mask = 1 };
+
+        ioctl(Bus.Fd,GPIO_V2_LINE_SET_VALUES_IOCTL,&Values);
+        }
+    else if( Bus.Config.Mock )
+        Bus.Config.Mock(At,Actual,Level);
+
+    return(Actual);
+    }
+
+static void LineClose(void) {
+
+    if( Bus.Fd >= 0 )
+        close(Bus.Fd);
+
+    Bus.Fd = -1;
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Take - Take the next frame from the FIFO
+//
+// A frame is the byte at the head of the FIFO, and the data bytes after it up to the
+//   next command byte. Called with the lock held.
+//
+// Inputs:      Where to put the wire images
+//
+// Outputs:     Number of bytes taken
+//
+static uint8_t Take(uint16_t *Wires) {
+    uint8_t Count = 0;
+
+    while( Bus.FIFO_Out != Bus.FIFO_In ) {
+        uint16_t Wire = Bus.FIFO[Bus.FIFO_Out];
+
+        if( Count && !(Wire & CRICKET_WIRE_CMD) )
+            break;                                      // Next frame's command byte
+
+        Wires[Count++] = Wire;
+        Bus.FIFO_Out   = (Bus.FIFO_Out+1) & CRICKET_FIFO_WRAP;
+        }
+
+    return(Count);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Plan - Work out the edges of a frame
+//
+// Inputs:      Wire images, and how many
+//              Time of the first pre-start edge, nS
+//
+// Outputs:     Number of edges in Bus.Edges[]
+//
+static uint16_t Plan(const uint16_t *Wires,uint8_t Count,uint64_t At) {
+    uint16_t Edges = 0;
+    uint8_t  Byte;
+
+    for( Byte = 0; Byte < Count; Byte++ ) {
+        uint8_t Level = 0;
+        uint8_t Bit;
+
+        Bus.Edges[Edges++] = (EDGE) { At, 0, true };    // Pre-start
+        At += PRESTART_NS;
+
+        for( Bit = 0; Bit < CRICKET_BYTE_BITS; Bit++ ) {
+            uint8_t Next = (Wires[Byte] >> Bit) & 1;
+
+            if( Next != Level )
+                Bus.Edges[Edges++] = (EDGE) { At, Next, false };
+            Level = Next;
+            At   += BIT_NS;
+            }
+        }
+
+    Bus.End = At;
+
+    return(Edges);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Send - Play out the planned edges, and time them
+//
+// A late pre-start edge is harmless (the line was idle), so the rest of its byte is
+//   moved back to match. Any other late edge is jitter on the bus.
+//
+// Inputs:      Number of edges
+//              Stats to add to
+//
+// Outputs:     None.
+//
+static void Send(uint16_t Edges,CRICKET_LINUX_STATS *Stats) {
+    uint64_t Shift = 0;
+    uint16_t Index;
+
+    for( Index = 0; Index < Edges; Index++ ) {
+        const EDGE *Edge = &Bus.Edges[Index];
+        uint64_t    At   = Edge->At + Shift;
+        uint64_t    Late;
+        uint32_t    Bucket;
+
+        WaitUntil(At);
+        Late = LineSet(Edge->Level,At) - At;
+
+        if( Edge->PreStart ) {
+            if( Late > CRICKET_LINUX_TOL_NS )
+                Stats->Gaps++;
+            Shift += Late;
+            continue;
+            }
+
+        Bucket = Late/1000;
+        Stats->Hist[Bucket < CRICKET_LINUX_HIST ? Bucket : CRICKET_LINUX_HIST-1]++;
+        Stats->Edges++;
+        Stats->SumLateNS += Late;
+
+        if( Late > Stats->MaxLateNS )
+            Stats->MaxLateNS = Late;
+
+        if( Late > CRICKET_LINUX_TOL_NS )
+            Stats->Misses++;
+        }
+
+    Bus.End += Shift;
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Thread - The bus thread
+//
+// Sets itself up for real time (as far as it's allowed), then sends frames as they're
+//   queued. A frame queued before the last one has finished follows it straight on.
+//   At exit, anything queued is sent first.
+//
+static void *Thread(void *Arg) {
+    CRICKET_LINUX_STATS Stats;
+    struct sched_param  Param = { .sched_priority = Bus.Config.Priority };
+    cpu_set_t           CPUs;
+    uint16_t            Wires[CRICKET_FIFO_SIZE];
+
+    CPU_ZERO(&CPUs);
+    CPU_SET(Bus.Stats.CPU,&CPUs);
+
+    pthread_mutex_lock(&Bus.Lock);
+    Bus.Stats.Pinned   = pthread_setaffinity_np(pthread_self(),sizeof(CPUs),&CPUs) == 0;
+    Bus.Stats.Realtime = Bus.Config.Priority > 0 &&
+                         pthread_setschedparam(pthread_self(),SCHED_FIFO,&Param) == 0;
+    Bus.Up = true;
+    pthread_cond_signal(&Bus.Ready);
+
+    while(1) {
+        uint8_t  Count;
+        uint16_t Edges;
+        uint8_t  Bucket;
+
+        while( Bus.FIFO_In == Bus.FIFO_Out && !Bus.Exit )
+            pthread_cond_wait(&Bus.Wake,&Bus.Lock);
+
+        if( Bus.FIFO_In == Bus.FIFO_Out )
+            break;                                      // Exit, with all sent
+
+        Count      = Take(Wires);
+        Bus.Active = true;
+        pthread_mutex_unlock(&Bus.Lock);
+
+        memset(&Stats,0,sizeof(Stats));
+        Edges = Plan(Wires,Count,Bus.End > Now() ? Bus.End : Now());
+        Send(Edges,&Stats);
+
+        pthread_mutex_lock(&Bus.Lock);
+        Bus.Sent       += Count;
+        Bus.Active      = false;
+        Bus.Stats.Batches++;
+        Bus.Stats.Bytes     += Count;
+        Bus.Stats.Edges     += Stats.Edges;
+        Bus.Stats.Misses    += Stats.Misses;
+        Bus.Stats.Gaps      += Stats.Gaps;
+        Bus.Stats.SumLateNS += Stats.SumLateNS;
+        if( Stats.MaxLateNS > Bus.Stats.MaxLateNS )
+            Bus.Stats.MaxLateNS = Stats.MaxLateNS;
+        for( Bucket = 0; Bucket < CRICKET_LINUX_HIST; Bucket++ )
+            Bus.Stats.Hist[Bucket] += Stats.Hist[Bucket];
+        }
+
+    pthread_mutex_unlock(&Bus.Lock);
+
+    return(NULL);
+    }
+
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketBusLinuxInit - Open the line, and start the bus thread
+//
+// Inputs:      Line and thread settings
+//
+// Outputs:     TRUE  if running
+//              FALSE if the line or thread couldn't be had (errno says why)
+//
+bool CricketBusLinuxInit(const CRICKET_LINUX *Config) {
+    int Error;
+
+    CricketBusLinuxExit();
+
+    Bus.FIFO_In  = 0;
+    Bus.FIFO_Out = 0;
+    Bus.Active   = false;
+    Bus.Posted   = 0;
+    Bus.Sent     = 0;
+    Bus.Up       = false;
+    Bus.Exit     = false;
+    Bus.End      = 0;
+    Bus.Config   = *Config;
+    memset(&Bus.Stats,0,sizeof(Bus.Stats));
+
+    Bus.Stats.CPU = Config->CPU >= 0 ? Config->CPU : sysconf(_SC_NPROCESSORS_ONLN)-1;
+
+    if( !LineOpen() )
+        return(false);
+
+    if( Config->Priority > 0 )
+        Bus.Stats.Locked = mlockall(MCL_CURRENT | MCL_FUTURE) == 0;
+
+    if( (Error = pthread_create(&Bus.Thread,NULL,Thread,NULL)) != 0 ) {
+        LineClose();
+        errno = Error;
+        return(false);
+        }
+
+    pthread_mutex_lock(&Bus.Lock);
+    while( !Bus.Up )
+        pthread_cond_wait(&Bus.Ready,&Bus.Lock);
+    pthread_mutex_unlock(&Bus.Lock);
+
+    Bus.Running = true;
+
+    return(true);
+    }
+
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketBusLinuxExit - Send what's queued, stop the thread and release the line
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void CricketBusLinuxExit(void) {
+
+    if( !Bus.Running )
+        return;
+
+    pthread_mutex_lock(&Bus.Lock);
+    Bus.Exit = true;
+    pthread_cond_signal(&Bus.Wake);
+    pthread_mutex_unlock(&Bus.Lock);
+
+    pthread_join(Bus.Thread,NULL);
+    LineClose();
+
+    if( Bus.Stats.Locked )
+        munlockall();
+
+    Bus.Running = false;
+    }
+
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketBusInit - Initialize cricket bus interface
+//
+// With the line and thread settings in CricketBusLinux.h. There's no way to return an
+//   error from here, so a bus that can't be had is fatal.
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void CricketBusInit(void) {
+    static const CRICKET_LINUX Default = CRICKET_LINUX_DEFAULT;
+
+    if( !CricketBusLinuxInit(&Default) ) {
+        perror("CricketBusInit: " CRICKET_LINUX_CHIP);
+        exit(1);
+        }
+    }
+
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketBusPut - Send one byte and command bit out the cricket bus
+//
+// The byte goes in the FIFO for the bus thread, which is woken if it was idle. When
+//   the FIFO is full the caller gives up the CPU before being told so, since on a
+//   single core the bus thread can't empty it otherwise.
+//
+// Inputs:      Byte to send
+//              TRUE if this is a command byte
+//
+// Outputs:     TRUE  if byte was queued OK,
+//              FALSE if FIFO full
+//
+bool CricketBusPut(uint8_t Byte,bool Command) {
+    uint8_t NewIn;
+    bool    Success = false;
+
+    pthread_mutex_lock(&Bus.Lock);
+
+    NewIn = (Bus.FIFO_In+1) & CRICKET_FIFO_WRAP;
+
+    if( NewIn != Bus.FIFO_Out ) {
+        if( Bus.FIFO_In == Bus.FIFO_Out )
+            pthread_cond_signal(&Bus.Wake);
+        Bus.FIFO[Bus.FIFO_In] = CRICKET_WIRE(Byte,Command);
+        Bus.FIFO_In           = NewIn;
+        Bus.Posted++;
+        Success = true;
+        }
+
+    pthread_mutex_unlock(&Bus.Lock);
+
+    if( !Success )
+        sched_yield();
+
+    return(Success);
+    }
+
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketBusBusy   - Return TRUE if bus is busy sending output
+// CricketBusQueued - Return number of bytes not yet completely sent
+// CricketBusRoom   - Return number of free FIFO slots
+// CricketBusPosted - Return running count of bytes accepted by CricketBusPut
+// CricketBusSent   - Return running count of bytes completely sent
+//
+// Inputs:      None.
+//
+// Outputs:     As above
+//
+bool CricketBusBusy(void) {
+    bool Busy;
+
+    pthread_mutex_lock(&Bus.Lock);
+    Busy = Bus.Active || Bus.FIFO_In != Bus.FIFO_Out;
+    pthread_mutex_unlock(&Bus.Lock);
+
+    return(Busy);
+    }
+
+uint8_t CricketBusQueued(void) { return( (uint8_t) (CricketBusPosted() - CricketBusSent()) ); }
+
+uint8_t CricketBusRoom(void) {
+    uint8_t Room;
+
+    pthread_mutex_lock(&Bus.Lock);
+    Room = (Bus.FIFO_Out - Bus.FIFO_In - 1) & CRICKET_FIFO_WRAP;
+    pthread_mutex_unlock(&Bus.Lock);
+
+    return(Room);
+    }
+
+uint16_t CricketBusPosted(void) {
+    uint16_t Posted;
+
+    pthread_mutex_lock(&Bus.Lock);
+    Posted = Bus.Posted;
+    pthread_mutex_unlock(&Bus.Lock);
+
+    return(Posted);
+    }
+
+uint16_t CricketBusSent(void) {
+    uint16_t Sent;
+
+    pthread_mutex_lock(&Bus.Lock);
+    Sent = Bus.Sent;
+    pthread_mutex_unlock(&Bus.Lock);
+
+    return(Sent);
+    }
+
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketBusLinuxStats  - Return timing statistics since init
+// CricketBusLinuxReport - Print them
+//
+// Inputs:      [Stats]  Where to put them
+//              [Report] Where to print them
+//
+// Outputs:     None.
+//
+void CricketBusLinuxStats(CRICKET_LINUX_STATS *Stats) {
+
+    pthread_mutex_lock(&Bus.Lock);
+    *Stats = Bus.Stats;
+    pthread_mutex_unlock(&Bus.Lock);
+    }
+
+void CricketBusLinuxReport(FILE *Out) {
+    CRICKET_LINUX_STATS Stats;
+    uint32_t Most = 1;
+    uint8_t  Bucket;
+
+    CricketBusLinuxStats(&Stats);
+
+    fprintf(Out,"Cricket bus: %u bytes in %u batches, %s, %s CPU %d, memory %slocked\n",
+            Stats.Bytes,Stats.Batches,
+            Stats.Realtime ? "SCHED_FIFO" : "normal scheduling",
+            Stats.Pinned   ? "on" : "not on",Stats.CPU,
+            Stats.Locked   ? "" : "not ");
+
+    if( Stats.Edges == 0 )
+        return;
+
+    fprintf(Out,"  %u edges, late by %.2f uS mean, %.2f uS worst, %u over %.1f uS, %u late pre-starts\n",
+            Stats.Edges,Stats.SumLateNS/1000.0/Stats.Edges,Stats.MaxLateNS/1000.0,
+            Stats.Misses,CRICKET_LINUX_TOL_NS/1000.0,Stats.Gaps);
+
+    for( Bucket = 0; Bucket < CRICKET_LINUX_HIST; Bucket++ )
+        if( Stats.Hist[Bucket] > Most )
+            Most = Stats.Hist[Bucket];
+
+    for( Bucket = 0; Bucket < CRICKET_LINUX_HIST; Bucket++ ) {
+        if( Stats.Hist[Bucket] == 0 )
+            continue;
+
+        fprintf(Out,"  %s%2u uS %8u %.*s\n",Bucket == CRICKET_LINUX_HIST-1 ? ">=" : "  ",
+                Bucket,Stats.Hist[Bucket],(int) (40*Stats.Hist[Bucket]/Most + 1),
+                "########################################");
+        }
+    }
@@ -0,0 +1,217 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      CricketBusLinux.h - Cricket bus driver for Linux GPIO
+//
+//  SYNOPSIS
+//
+//      //////////////////////////////////////
+//      //
+//      // Linux build: -DCRICKET_BUS_DRIVER=CRICKET_DRIVER_LINUX, this file in place of
+//      //   CricketBus.c, and -lpthread (see linux/Makefile). The CricketBus, CricketLED,
+//      //   CricketMotor and CricketRelay calls are then as on the AVR.
+//      //
+//      CricketBusInit();                   // Line and settings below, exits on failure
+//
+//      CRICKET_LINUX Config = CRICKET_LINUX_DEFAULT;
+//      Config.Chip = "/dev/gpiochip1";
+//      Config.Line = 23;
+//      if( !CricketBusLinuxInit(&Config) ) // Or choose at run time
+//          perror("CricketBusLinuxInit");
+//
+//      CricketLEDDec(1234,1);              // Returns right away, thread sends it
+//
+//      CRICKET_LINUX_STATS Stats;
+//      CricketBusLinuxStats(&Stats);       // Timing jitter, &c
+//      CricketBusLinuxReport(stdout);      // Same, printed
+//
+//      CricketBusLinuxExit();              // Send what's queued, release the line
+//
+//  DESCRIPTION
+//
+//      Cricket bus driver for Linux single board computers, sending from a GPIO line.
+//
+//      Bytes are queued by CricketBusPut() in a FIFO of wire images, as on the AVR,
+//        and sent by a thread of their own. The thread takes a frame at a time (a
+//        command byte and the data bytes queued after it, so a frame still being
+//        queued goes in parts, back to back), works out every edge of the batch in
+//        advance, then plays the edges out against CLOCK_MONOTONIC: it sleeps with
+//        clock_nanosleep() until CRICKET_LINUX_SPIN_NS before each edge, then busy
+//        waits the rest of the way, so the wakeup latency of the kernel doesn't show
+//        up on the bus.
+//
+//      For steady timing the thread runs SCHED_FIFO, pinned to one core, with memory
+//        locked. On the gateway, keep that core for the thread alone (isolcpus=3
+//        nohz_full=3 on the kernel command line, for core 3 of 4). If real time
+//        scheduling isn't permitted the thread runs anyway, and the stats say so.
+//
+//      Lateness of every edge against its schedule is measured: worst, mean and a
+//        histogram, and a count of edges later than CRICKET_LINUX_TOL_NS (past which
+//        a device may misread the bit). An edge is never early. The pre-start edge of
+//        a byte is the exception: the line is idle high before it, so if it's late the
+//        rest of the byte is simply moved back to match, and it's counted as a gap.
+//
+//      The line is a GPIO character device line (/dev/gpiochipN, line uAPI v2), which
+//        is also what the gpio-sim kernel module provides for testing. With Config.Chip
+//        NULL there's no line at all: each edge goes to Config.Mock instead, with the
+//        time it was scheduled and the time it was set, for tests without hardware
+//        (see linux/LinuxTest.c).
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CRICKETBUSLINUX_H
+#define CRICKETBUSLINUX_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "CricketBus.h"
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// User configurable options
+//
+// Line and thread used by CricketBusInit(), which CRICKET_LINUX_DEFAULT copies.
+//
+#ifndef CRICKET_LINUX_CHIP
+#define CRICKET_LINUX_CHIP      "/dev/gpiochip0"
+#endif
+
+#ifndef CRICKET_LINUX_LINE
+#define CRICKET_LINUX_LINE      17          // Line offset on the chip
+#endif
+
+#ifndef CRICKET_LINUX_CPU
+#define CRICKET_LINUX_CPU       (-1)        // Core for the thread, -1 for the last one
+#endif
+
+#ifndef CRICKET_LINUX_PRIORITY
+#define CRICKET_LINUX_PRIORITY  80          // SCHED_FIFO priority, 0 for normal scheduling
+#endif
+
+//
+// Timing
+//
+#ifndef CRICKET_LINUX_SPIN_NS
+#define CRICKET_LINUX_SPIN_NS   60000       // Busy wait this long before each edge
+#endif
+
+#ifndef CRICKET_LINUX_TOL_NS
+#define CRICKET_LINUX_TOL_NS    2000        // Edges later than this are counted as misses
+#endif
+
+#ifndef CRICKET_LINUX_HIST
+#define CRICKET_LINUX_HIST      16          // Histogram, 1 uS per bucket, last is the rest
+#endif
+
+//
+// End of user configurable options
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#if CRICKET_BUS_DRIVER != CRICKET_DRIVER_LINUX
+#   error "CricketBusLinux.h: needs CRICKET_BUS_DRIVER == CRICKET_DRIVER_LINUX"
+#endif
+
+//
+// Mock line: called from the bus thread for each edge, with the time it was scheduled
+//   and the time it was set (CLOCK_MONOTONIC, nS)
+//
+typedef void (*CricketLinuxEdgeFn)(uint64_t Scheduled,uint64_t Actual,uint8_t Level);
+
+typedef struct {
+    const char         *Chip;               // GPIO chip device, NULL for the mock line
+    uint32_t            Line;               // Line offset on the chip
+    int                 CPU;                // Core for the thread, -1 for the last one
+    int                 Priority;           // SCHED_FIFO priority, 0 for normal
+    CricketLinuxEdgeFn  Mock;               // With Chip NULL, called for each edge
+    } CRICKET_LINUX;
+
+#define CRICKET_LINUX_DEFAULT   { CRICKET_LINUX_CHIP, CRICKET_LINUX_LINE,                   \
+                                  CRICKET_LINUX_CPU,  CRICKET_LINUX_PRIORITY, NULL }
+
+typedef struct {
+    bool        Realtime;                   // Thread got SCHED_FIFO
+    bool        Pinned;                     // Thread got its core
+    bool        Locked;                     // Memory locked
+    int         CPU;                        // Core asked for
+
+    uint32_t    Batches;                    // Frames (or parts) sent in one go
+    uint32_t    Bytes;
+    uint32_t    Edges;                      // Edges timed (not counting pre-starts)
+    uint32_t    Misses;                     // Edges later than CRICKET_LINUX_TOL_NS
+    uint32_t    Gaps;                       // Late pre-starts, absorbed into the idle time
+    uint32_t    MaxLateNS;                  // Worst edge
+    uint64_t    SumLateNS;                  // Mean is SumLateNS/Edges
+    uint32_t    Hist[CRICKET_LINUX_HIST];   // Edges by lateness, 1 uS per bucket
+    } CRICKET_LINUX_STATS;
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketBusLinuxInit - Open the line, and start the bus thread
+//
+// CricketBusInit() calls this with CRICKET_LINUX_DEFAULT, and exits if it fails.
+//
+// Inputs:      Line and thread settings
+//
+// Outputs:     TRUE  if running
+//              FALSE if the line or thread couldn't be had (errno says why)
+//
+bool CricketBusLinuxInit(const CRICKET_LINUX *Config);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketBusLinuxExit - Send what's queued, stop the thread and release the line
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void CricketBusLinuxExit(void);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketBusLinuxStats  - Return timing statistics since init
+// CricketBusLinuxReport - Print them
+//
+// Inputs:      [Stats]  Where to put them
+//              [Report] Where to print them
+//
+// Outputs:     None.
+//
+void CricketBusLinuxStats (CRICKET_LINUX_STATS *Stats);
+void CricketBusLinuxReport(FILE *Out);
+
+#endif  // CRICKETBUSLINUX_H - entire file
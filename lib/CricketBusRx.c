@@ -0,0 +1,450 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      CricketBusRx.c
+//
+//  SYNOPSIS
+//
+//      //////////////////////////////////////
+//      //
+//      // In CricketBusRx.h
+//      //
+//      #define CRICKET_RX_PCINT    2       // Pin change group of the bus pin
+//      #define CRICKET_RX_OC       B       // Timer1 compare channel for receive timing
+//
+//      //////////////////////////////////////
+//      //
+//      // In main.c
+//      //
+//      CricketBusInit();                   // Called once at startup
+//      CricketBusRxInit();
+//
+//      CricketBusPutW(0x20,true);          // Send a command to a sensor board
+//      ...
+//      while( !CricketBusListen(2000) );   // Release the bus when sent, 2 mS timeout
+//
+//      uint8_t Byte;
+//      uint8_t Status = CricketBusGet(&Byte);
+//
+//      if( Status & CRICKET_RX_BYTE    ) ...   // Got a byte
+//      if( Status & CRICKET_RX_COMMAND ) ...   //   ...with the command bit set
+//      if( Status & CRICKET_RX_FRAMING ) ...   //   ...with bad start or stop bit
+//      if( Status & CRICKET_RX_OVERRUN ) ...   // Bytes lost before this one
+//      if( Status & CRICKET_RX_TIMEOUT ) ...   // Bus quiet, receive ended
+//
+//      if( CricketBusListening() ) ...     // TRUE until timeout or CricketBusRxStop()
+//
+//  DESCRIPTION
+//
+//      Interrupt driven receive for the cricket bus. See CricketBusRx.h
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+
+#include <avr/interrupt.h>
+
+#include "CricketBusRx.h"
+#include "CricketBusEdge.h"
+#include "PortMacros.h"
+
+#if defined(CRICKET_RX_CAPTURE) && CRICKET_BUS_DRIVER == CRICKET_DRIVER_OCR
+#   error "CricketBusRx.h: CRICKET_RX_CAPTURE needs the bus on ICP1, the OCR driver needs OC1x"
+#endif
+
+#define CRICKET_RX_WRAP     (CRICKET_RX_FIFO_SIZE-1)    // Wraparound mask for FIFO
+
+//
+// Timer1 runs at the CPU clock, so bus times convert directly to timer ticks
+//
+#define RX_US_TICKS(_us_)   ((uint16_t) (((F_CPU/1000UL)*(_us_))/1000UL))
+
+#define RX_BIT_TICKS        RX_US_TICKS(CRICKET_BIT_US)
+#define RX_PRESTART_MIN     RX_US_TICKS(CRICKET_PRESTART_US/2)
+#define RX_END_TICKS        CRICKET_EDGE_END(RX_BIT_TICKS)      // Middle of stop bit
+
+//
+// Timer1 compare channel and pin change registers
+//
+#define _OCR1(_x_)          _JOIN(OCR1,_x_)
+#define _OCIE1(_x_)         _JOIN(OCIE1,_x_)
+#define _OCF1(_x_)          _JOIN(OCF1,_x_)
+#define _FOC1(_x_)          _JOIN(FOC1,_x_)
+#define _COM1(_x_,_b_)      _JOIN3(COM1,_x_,_b_)
+#define _T1VECT(_x_)        _JOIN3(TIMER1_COMP,_x_,_vect)
+#define _PCIE(_x_)          _JOIN(PCIE,_x_)
+#define _PCMSK(_x_)         _JOIN(PCMSK,_x_)
+#define _PCVECT(_x_)        _JOIN3(PCINT,_x_,_vect)
+
+#define RX_OCR              _OCR1(CRICKET_RX_OC)
+#define RX_OCIE             _OCIE1(CRICKET_RX_OC)
+#define RX_OCF              _OCF1(CRICKET_RX_OC)
+#define RX_VECT             _T1VECT(CRICKET_RX_OC)
+#define RX_PCIE             _PCIE(CRICKET_RX_PCINT)
+#define RX_PCMSK            _PCMSK(CRICKET_RX_PCINT)
+#define RX_PCVECT           _PCVECT(CRICKET_RX_PCINT)
+
+#define RX_LEVEL            _BIT_ON(_PIN(CRICKET_BUS_PORT),CRICKET_BUS_PIN)
+
+static struct {
+    uint16_t    FIFO[CRICKET_RX_FIFO_SIZE]; // Status << 8 | Byte
+
+    uint8_t     FIFO_In;                // FIFO input  pointer
+    uint8_t     FIFO_Out;               // FIFO output pointer
+
+    CRICKET_EDGE Decode;                // Phase OFF when not listening
+    bool        Lost;                   // FIFO overflowed since last entry
+
+    uint16_t    Timeout;                // Timeout, low 16 bits of ticks (0 == 65536)
+    uint8_t     TimeoutWraps;           // Timeout, wraps after the first match
+    uint8_t     Wraps;                  // Full timer wraps left before timeout
+    } Rx NOINIT;
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketBusRxInit - Initialize cricket bus receive
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void CricketBusRxInit(void) {
+
+    memset(&Rx,0,sizeof(Rx));
+
+#if CRICKET_BUS_DRIVER == CRICKET_DRIVER_BITBANG || CRICKET_BUS_DRIVER == CRICKET_DRIVER_USART
+    //
+    // Transmit doesn't use Timer1 with these drivers, so set it up the same as the
+    //   timer driver would.
+    //
+    TCCR1A = 0;                                         // Normal mode, no pin outputs
+    TCCR1B = (1 << CS10);                               // Clk/1
+#endif
+
+    _CLR_BIT(TIMSK1,RX_OCIE);
+#ifdef CRICKET_RX_CAPTURE
+    _CLR_BIT(TIMSK1,ICIE1);
+    _SET_BIT(TCCR1B,ICNC1);                             // Noise canceler (4 clocks)
+#else
+    _CLR_BIT(PCICR,RX_PCIE);
+    _SET_BIT(RX_PCMSK,CRICKET_BUS_PIN);
+#endif
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// RxPut - Add one entry to the receive FIFO
+//
+// If the FIFO is full the entry is lost, and the next one that fits is marked
+//   CRICKET_RX_OVERRUN. A timeout with the FIFO full is added to the newest entry
+//   instead, so it's never lost.
+//
+// Inputs:      Status bits
+//              Byte
+//
+// Outputs:     None.
+//
+static void RxPut(uint8_t Status,uint8_t Byte) {
+    uint8_t NewIn = (Rx.FIFO_In+1) & CRICKET_RX_WRAP;
+
+    if( NewIn == Rx.FIFO_Out ) {
+        if( Status & CRICKET_RX_TIMEOUT )
+            Rx.FIFO[(Rx.FIFO_In-1) & CRICKET_RX_WRAP] |= CRICKET_RX_TIMEOUT << 8;
+        else
+            Rx.Lost = true;
+        return;
+        }
+
+    if( Rx.Lost )
+        Status |= CRICKET_RX_OVERRUN;
+    Rx.Lost = false;
+
+    Rx.FIFO[Rx.FIFO_In] = (((uint16_t) Status) << 8) | Byte;
+    Rx.FIFO_In          = NewIn;
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// RxArmTimeout - Start the quiet-bus timeout from now
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+static void RxArmTimeout(void) {
+
+    RX_OCR   = TCNT1 + Rx.Timeout;
+    Rx.Wraps = Rx.TimeoutWraps;
+    TIFR1    = _PIN_MASK(RX_OCF);               // Clear any stale match
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// RxRelease - Turn the bus line into an input and start the edge interrupt
+// RxTakeBack - Turn the bus line back into a (high) output for transmit
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+static void RxRelease(void) {
+
+#if CRICKET_BUS_DRIVER == CRICKET_DRIVER_OCR
+    TCCR1A = 0;                                         // Pin back to the port
+#endif
+    _SET_BIT(_PORT(CRICKET_BUS_PORT),CRICKET_BUS_PIN);  // Pullup on
+    _CLR_BIT(_DDR (CRICKET_BUS_PORT),CRICKET_BUS_PIN);  // Bus line is an input
+
+#ifdef CRICKET_RX_CAPTURE
+    _CLR_BIT(TCCR1B,ICES1);                             // Falling edge first
+    TIFR1 = _PIN_MASK(ICF1);
+    _SET_BIT(TIMSK1,ICIE1);
+#else
+    PCIFR = _PIN_MASK(RX_PCIE);
+    _SET_BIT(PCICR,RX_PCIE);
+#endif
+    }
+
+static void RxTakeBack(void) {
+
+#ifdef CRICKET_RX_CAPTURE
+    _CLR_BIT(TIMSK1,ICIE1);
+#else
+    _CLR_BIT(PCICR,RX_PCIE);
+#endif
+    _CLR_BIT(TIMSK1,RX_OCIE);
+
+    _SET_BIT(_PORT(CRICKET_BUS_PORT),CRICKET_BUS_PIN);  // High until first data
+    _SET_BIT(_DDR (CRICKET_BUS_PORT),CRICKET_BUS_PIN);  // Bus line is an output
+
+#if CRICKET_BUS_DRIVER == CRICKET_DRIVER_OCR
+    //
+    // Hand the pin back to the compare unit, forced high, as in CricketBusInit()
+    //
+    TCCR1A = _PIN_MASK(_COM1(CRICKET_BUS_OC,1)) | _PIN_MASK(_COM1(CRICKET_BUS_OC,0));
+    TCCR1C = _PIN_MASK(_FOC1(CRICKET_BUS_OC));
+#endif
+
+    Rx.Decode.Phase = CRICKET_EDGE_OFF;
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketBusListen - Release the bus line and receive replies
+//
+// Inputs:      Timeout, in uS of bus quiet time (up to 65535)
+//
+// Outputs:     TRUE  if listening
+//              FALSE if the transmitter is still busy (try again later)
+//
+bool CricketBusListen(uint16_t TimeoutUS) {
+    uint32_t Ticks = ((F_CPU/1000UL)*TimeoutUS + 500UL)/1000UL;  // Rounded, any F_CPU
+    uint8_t  SaveSREG;
+
+    if( CricketBusBusy() )
+        return(false);
+
+    SaveSREG = SREG;
+    cli();
+
+    //
+    // The first compare match is Timeout counts after arming (a full wrap if that's
+    //   0), then TimeoutWraps more wraps follow. An exact multiple of 65536 ticks is
+    //   a full first wrap and one fewer after it.
+    //
+    Rx.Timeout      = (uint16_t) Ticks;
+    Rx.TimeoutWraps = Ticks ? (Ticks-1) >> 16 : 0;
+    Rx.Decode.Phase = CRICKET_EDGE_IDLE;
+    Rx.Decode.Level = 1;
+
+    RxRelease();
+    RxArmTimeout();
+    _SET_BIT(TIMSK1,RX_OCIE);
+
+    SREG = SaveSREG;
+
+    return(true);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketBusRxStop - Stop listening, take the bus line back for transmit
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void CricketBusRxStop(void) {
+    uint8_t SaveSREG = SREG;
+
+    cli();
+    if( Rx.Decode.Phase != CRICKET_EDGE_OFF )
+        RxTakeBack();
+    SREG = SaveSREG;
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketBusListening - Return TRUE if the receiver is listening
+//
+// Inputs:      None.
+//
+// Outputs:     TRUE  if listening
+//              FALSE if timed out or stopped
+//
+bool CricketBusListening(void) { return( Rx.Decode.Phase != CRICKET_EDGE_OFF ); }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketBusGet - Get one received byte from the FIFO
+//
+// Inputs:      Where to put the byte
+//
+// Outputs:     Status bits (CRICKET_RX_xxx) of the entry, and byte if there was one,
+//              0 if FIFO empty
+//
+uint8_t CricketBusGet(uint8_t *Byte) {
+    uint16_t Entry;
+
+    if( Rx.FIFO_In == Rx.FIFO_Out )
+        return(0);
+
+    _CLR_BIT(TIMSK1,RX_OCIE);                   // Timeout can change the newest entry
+    Entry       = Rx.FIFO[Rx.FIFO_Out];
+    Rx.FIFO_Out = (Rx.FIFO_Out+1) & CRICKET_RX_WRAP;
+    if( Rx.Decode.Phase != CRICKET_EDGE_OFF )
+        _SET_BIT(TIMSK1,RX_OCIE);
+
+    *Byte = Entry & 0xFF;
+    return(Entry >> 8);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// RxEdge - Process one edge on the bus line
+//
+// Called from the edge interrupt. See CricketBusEdge.h for the decoding.
+//
+// Inputs:      Timer1 time of the edge
+//              Line level after the edge
+//
+// Outputs:     None.
+//
+static void RxEdge(uint16_t Time,uint8_t Level) {
+
+    if( CricketEdge(&Rx.Decode,Time,Level,RX_BIT_TICKS,RX_PRESTART_MIN) ) {
+        RX_OCR = Time + RX_END_TICKS;           // Start bit: time the middle of stop
+        TIFR1  = _PIN_MASK(RX_OCF);
+        }
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Edge interrupt - Stamp the edge and decode
+//
+#ifdef CRICKET_RX_CAPTURE
+
+ISR(TIMER1_CAPT_vect) {
+    uint16_t Time  = ICR1;
+    uint8_t  Level = _BIT_ON(TCCR1B,ICES1) ? 1 : 0;
+
+    //
+    // Look for the opposite edge next, per the line as it is now. If the line has
+    //   already gone back, that edge came too soon to capture - use the timer.
+    //
+    if( RX_LEVEL ) { _CLR_BIT(TCCR1B,ICES1); }
+    else           { _SET_BIT(TCCR1B,ICES1); }
+    TIFR1 = _PIN_MASK(ICF1);                    // Per datasheet, after changing ICES1
+
+    RxEdge(Time,Level);
+    if( (RX_LEVEL ? 1 : 0) != Level )
+        RxEdge(TCNT1,!Level);
+    }
+
+#else
+
+ISR(RX_PCVECT) {
+    uint16_t Time = TCNT1;
+
+    RxEdge(Time,RX_LEVEL ? 1 : 0);
+    }
+
+#endif
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Compare interrupt - End of byte, or timeout
+//
+// In the middle of the stop bit, any cells since the last edge are at the current line
+//   level. Otherwise, it's the timeout, which might need a few more timer wraps.
+//
+ISR(RX_VECT) {
+
+    if( Rx.Decode.Phase == CRICKET_EDGE_BITS ) {
+        uint16_t Wire   = CricketEdgeDone(&Rx.Decode,RX_OCR);
+        uint8_t  Status = CRICKET_RX_BYTE;
+
+        if( CRICKET_WIRE_FRAMING(Wire) )
+            Status |= CRICKET_RX_FRAMING;
+        if( CRICKET_WIRE_COMMAND(Wire) )
+            Status |= CRICKET_RX_COMMAND;
+
+        RxPut(Status,CRICKET_WIRE_BYTE(Wire));
+        RxArmTimeout();
+        return;
+        }
+
+    if( Rx.Wraps ) {
+        Rx.Wraps--;
+        return;
+        }
+
+    RxPut(CRICKET_RX_TIMEOUT,0);
+    RxTakeBack();
+    }
@@ -0,0 +1,225 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      CricketBusRx.h - Cricket bus receive
+//
+//  SYNOPSIS
+//
+//      //////////////////////////////////////
+//      //
+//      // In CricketBusRx.h
+//      //
+//      #define CRICKET_RX_PCINT    2       // Pin change group of the bus pin
+//      #define CRICKET_RX_OC       B       // Timer1 compare channel for receive timing
+//
+//      //////////////////////////////////////
+//      //
+//      // In main.c
+//      //
+//      CricketBusInit();                   // Called once at startup
+//      CricketBusRxInit();
+//
+//      CricketBusPutW(0x20,true);          // Send a command to a sensor board
+//      ...
+//      while( !CricketBusListen(2000) );   // Release the bus when sent, 2 mS timeout
+//
+//      uint8_t Byte;
+//      uint8_t Status = CricketBusGet(&Byte);
+//
+//      if( Status & CRICKET_RX_BYTE    ) ...   // Got a byte
+//      if( Status & CRICKET_RX_COMMAND ) ...   //   ...with the command bit set
+//      if( Status & CRICKET_RX_FRAMING ) ...   //   ...with bad start or stop bit
+//      if( Status & CRICKET_RX_OVERRUN ) ...   // Bytes lost before this one
+//      if( Status & CRICKET_RX_TIMEOUT ) ...   // Bus quiet, receive ended
+//
+//      if( CricketBusListening() ) ...     // TRUE until timeout or CricketBusRxStop()
+//
+//  DESCRIPTION
+//
+//      Interrupt driven receive for the cricket bus.
+//
+//      Cricket sensor boards answer on the bus line. After the command has gone out,
+//        CricketBusListen() turns the line into an input (with pullup) and decodes
+//        replies in the background. Each byte goes into a FIFO, along with its status.
+//
+//      Bytes are decoded from edge times, not by sampling the line. The pin change
+//        interrupt (or the Timer1 input capture unit, see CRICKET_RX_CAPTURE) stamps
+//        each edge with Timer1, and the bits between two edges are filled in from the
+//        time between them. One compare match per byte, in the middle of the stop
+//        bit, finishes the byte.
+//
+//      A pre-start low of at least half the spec length, followed by a rising edge,
+//        starts a byte. The start bit and stop bit must be high, else the byte is
+//        marked CRICKET_RX_FRAMING.
+//
+//      Receive ends when the bus has been quiet for the timeout time (from the call to
+//        CricketBusListen() or the last byte). A CRICKET_RX_TIMEOUT entry goes into the
+//        FIFO, and the line goes back to being a (high) output for CricketBusPut().
+//
+//  NOTES
+//
+//      Uses Timer1 free running at the CPU clock, the same as the timer and OCR
+//        transmit drivers, and compare channel CRICKET_RX_OC which must not be the
+//        transmit channel CRICKET_BUS_OC.
+//
+//      Don't call CricketBusPut() while listening.
+//
+//      Pin change timestamps include the interrupt latency, so other long interrupt
+//        handlers can throw the timing off. The decoder allows half a bit (5 uS) of
+//        error. With the bus on the ICP1 pin, define CRICKET_RX_CAPTURE and the
+//        hardware stamps the edges instead.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CRICKETBUSRX_H
+#define CRICKETBUSRX_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "CricketBus.h"
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Specify the receive hardware
+//
+// Pin change group for CRICKET_BUS_PORT (PCINTn_vect, PCIEn, PCMSKn). The mask bit is
+//   the pin number.
+//
+//      ATmega328P      B = 0   C = 1   D = 2
+//      ATmega1284P     A = 0   B = 1   C = 2   D = 3
+//      ATmega2560      B = 0
+//
+#ifndef CRICKET_RX_PCINT
+#define CRICKET_RX_PCINT    2
+#endif
+
+//
+// Timer1 compare channel used to time the end of each byte, and the timeout. Must not
+//   be CRICKET_BUS_OC.
+//
+#ifndef CRICKET_RX_OC
+#define CRICKET_RX_OC       B
+#endif
+
+//
+// Define CRICKET_RX_CAPTURE to use the input capture unit instead of pin change. The
+//   bus must then be on the ICP1 pin, which rules out the OCR driver:
+//
+//      ATmega328P      ICP1 = B,0
+//      ATmega1284P     ICP1 = D,6
+//      ATmega2560      ICP1 = D,4
+//
+//#define CRICKET_RX_CAPTURE
+
+//
+// The receive FIFO must be a power of two long, since the code uses a mask for
+//   wraparound.
+//
+#ifndef CRICKET_RX_FIFO_SIZE
+#define CRICKET_RX_FIFO_SIZE    (1 << 3)    // == 8 byte Rx FIFO
+#endif
+
+//
+// End of user configurable options
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+//
+// Receive status, returned by CricketBusGet(). Zero means nothing was waiting.
+//
+#define CRICKET_RX_BYTE     0x01            // Byte received
+#define CRICKET_RX_COMMAND  0x02            // Command bit was set (line low)
+#define CRICKET_RX_FRAMING  0x04            // Start or stop bit was low
+#define CRICKET_RX_OVERRUN  0x08            // FIFO was full, bytes lost before this
+#define CRICKET_RX_TIMEOUT  0x10            // Bus quiet, receive has ended
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketBusRxInit - Initialize cricket bus receive
+//
+// Call after CricketBusInit(). The line stays an output until CricketBusListen().
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void CricketBusRxInit(void);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketBusListen - Release the bus line and receive replies
+//
+// Inputs:      Timeout, in uS of bus quiet time (up to 65535)
+//
+// Outputs:     TRUE  if listening
+//              FALSE if the transmitter is still busy (try again later)
+//
+bool CricketBusListen(uint16_t TimeoutUS);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketBusRxStop - Stop listening, take the bus line back for transmit
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void CricketBusRxStop(void);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketBusListening - Return TRUE if the receiver is listening
+//
+// Inputs:      None.
+//
+// Outputs:     TRUE  if listening
+//              FALSE if timed out or stopped
+//
+bool CricketBusListening(void);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketBusGet - Get one received byte from the FIFO
+//
+// Inputs:      Where to put the byte
+//
+// Outputs:     Status bits (CRICKET_RX_xxx) of the entry, and byte if there was one,
+//              0 if FIFO empty
+//
+uint8_t CricketBusGet(uint8_t *Byte);
+
+#endif  // CRICKETBUSRX_H - entire file
@@ -0,0 +1,244 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      CricketCanvas.c
+//
+//  SYNOPSIS
+//
+//      CricketCanvasMap(0,CRICKET_CANVAS_BUS,1);   // Panel 0 (digits 0-3)  is ID 1, main bus
+//      CricketCanvasMap(1,CRICKET_CANVAS_BUS,2);   // Panel 1 (digits 4-7)  is ID 2, main bus
+//      CricketCanvasMap(2,0,1);                    // Panel 2 (digits 8-11) is ID 1, multi-bus 0
+//      ...
+//
+//      CricketCanvasText(0,6,"TEMP");              // Text in digits 0-5, blank filled
+//      CricketCanvasNumber(6,5,-123,1,0);          // "-12.3" in digits 6-10
+//      CricketCanvasPat(12,Segs,4);                // Raw patterns in digits 12-15
+//      CricketCanvasClear();                       // Blank everything
+//
+//      CricketCanvasFlush();                       // Send the panels that changed
+//
+//  DESCRIPTION
+//
+//      Virtual canvas over many LED displays. See CricketCanvas.h
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+
+#include "CricketCanvas.h"
+#include "CricketNumber.h"
+#include "PortMacros.h"
+
+#if CRICKET_CANVAS_PANELS < 1 || CRICKET_CANVAS_PANELS > 16
+#   error "CricketCanvas.h: CRICKET_CANVAS_PANELS must be 1 to 16"
+#endif
+
+typedef struct {
+    uint8_t     Bus;
+    uint8_t     ID;
+    } CANVAS_PANEL;
+
+static struct {
+    uint8_t      Digits[CRICKET_CANVAS_DIGITS];
+    CANVAS_PANEL Panel [CRICKET_CANVAS_PANELS];
+    uint16_t     Mapped;                    // Bit per panel
+    uint16_t     Dirty;                     // Bit per panel
+    } Canvas;
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// SetDigits - Write patterns to the canvas, marking changed panels dirty
+//
+// Inputs:      First digit
+//              Patterns
+//              Number of patterns
+//
+// Outputs:     None.
+//
+static void SetDigits(uint8_t Pos,const uint8_t *Segs,uint8_t Len) {
+
+    while( Len-- && Pos < CRICKET_CANVAS_DIGITS ) {
+        if( Canvas.Digits[Pos] != *Segs ) {
+            Canvas.Digits[Pos] = *Segs;
+            Canvas.Dirty |= (uint16_t) 1 << (Pos/4);
+            }
+        Pos++;
+        Segs++;
+        }
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketCanvasMap - Map a panel to a display
+//
+// Inputs:      Panel number (digits 4*Panel to 4*Panel+3)
+//              Bus (CRICKET_CANVAS_BUS, or a CricketMulti bus in CRICKET_MULTI_MASK)
+//              Device ID (0, 1 or 2)
+//
+// Outputs:     None.
+//
+void CricketCanvasMap(uint8_t Panel,uint8_t Bus,uint8_t ID) {
+
+    if( Panel >= CRICKET_CANVAS_PANELS || ID >= CRICKET_LED_IDS )
+        return;
+
+#ifdef CRICKET_CANVAS_MULTI
+    if( Bus != CRICKET_CANVAS_BUS &&
+        (Bus >= CRICKET_MULTI_BUSES || !_BIT_ON(CRICKET_MULTI_MASK,Bus)) )
+        return;
+#else
+    if( Bus != CRICKET_CANVAS_BUS )
+        return;
+#endif
+
+    Canvas.Panel[Panel].Bus = Bus;
+    Canvas.Panel[Panel].ID  = ID;
+    Canvas.Mapped |= (uint16_t) 1 << Panel;
+    Canvas.Dirty  |= (uint16_t) 1 << Panel;
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketCanvasPat    - Write segment patterns to the canvas
+// CricketCanvasText   - Write text to a field, left justified and blank filled
+// CricketCanvasNumber - Write a number to a field, right justified (see CricketNumber.h)
+//
+// Inputs:      First digit
+//              [Pat]    Patterns, and number of them
+//              [Text]   Field width, and text (NUL terminated, in RAM)
+//              [Number] Field width, value, decimals and flags (CRICKET_NUM_xxx)
+//
+// Outputs:     [Number] TRUE if the number fit, FALSE if dashes are shown
+//
+void CricketCanvasPat(uint8_t Pos,const uint8_t *Segs,uint8_t Len) {
+
+    SetDigits(Pos,Segs,Len);
+    }
+
+void CricketCanvasText(uint8_t Pos,uint8_t Width,const char *Text) {
+    uint8_t Segs[CRICKET_CANVAS_DIGITS];
+
+    if( Width > sizeof(Segs) )
+        Width = sizeof(Segs);
+
+    memset(Segs,0,Width);
+    CricketFontText(Text,Segs,Width);
+    SetDigits(Pos,Segs,Width);
+    }
+
+bool CricketCanvasNumber(uint8_t Pos,uint8_t Width,int32_t Value,uint8_t Decimals,uint8_t Flags) {
+    uint8_t Segs[CRICKET_CANVAS_DIGITS];
+    bool    Fits;
+
+    if( Width > sizeof(Segs) )
+        Width = sizeof(Segs);
+
+    Fits = CricketNumberSegs(Value,Decimals,Flags,Segs,Width);
+    SetDigits(Pos,Segs,Width);
+    return(Fits);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketCanvasClear - Blank the whole canvas
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void CricketCanvasClear(void) {
+    uint8_t Pos;
+
+    for( Pos = 0; Pos < CRICKET_CANVAS_DIGITS; Pos++ ) {
+        uint8_t Blank = 0;
+
+        SetDigits(Pos,&Blank,1);
+        }
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketCanvasFlush - Send every panel that changed since the last flush
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void CricketCanvasFlush(void) {
+    uint16_t Send = Canvas.Dirty & Canvas.Mapped;
+    uint16_t Multi;
+    uint8_t  Panel;
+
+    Canvas.Dirty &= ~Send;
+
+    for( Panel = 0, Multi = 0; Send; Panel++, Send >>= 1 ) {
+        CANVAS_PANEL *P      = &Canvas.Panel[Panel];
+        uint8_t      *Digits = &Canvas.Digits[4*Panel];
+
+        if( !(Send & 1) )
+            continue;
+
+        if( P->Bus == CRICKET_CANVAS_BUS ) {
+            CricketLEDPat(Digits[0],Digits[1],Digits[2],Digits[3],P->ID);
+            continue;
+            }
+
+        Multi |= (uint16_t) 1 << Panel;
+        }
+
+#ifdef CRICKET_CANVAS_MULTI
+    //
+    // CricketMulti sends with interrupts off, which would stretch the bits of a main
+    //   bus byte going out under interrupts. Let the main bus finish first.
+    //
+    if( Multi == 0 )
+        return;
+
+    while( CricketBusBusy() );
+
+    for( Panel = 0; Multi; Panel++, Multi >>= 1 ) {
+        CANVAS_PANEL *P      = &Canvas.Panel[Panel];
+        uint8_t      *Digits = &Canvas.Digits[4*Panel];
+
+        if( Multi & 1 )
+            CricketMultiLEDPat(P->Bus,Digits[0],Digits[1],Digits[2],Digits[3],P->ID);
+        }
+
+    CricketMultiSend();
+#endif
+    }
@@ -0,0 +1,154 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      CricketCanvas.h - Virtual canvas over many LED displays
+//
+//  SYNOPSIS
+//
+//      CricketCanvasMap(0,CRICKET_CANVAS_BUS,1);   // Panel 0 (digits 0-3)  is ID 1, main bus
+//      CricketCanvasMap(1,CRICKET_CANVAS_BUS,2);   // Panel 1 (digits 4-7)  is ID 2, main bus
+//      CricketCanvasMap(2,0,1);                    // Panel 2 (digits 8-11) is ID 1, multi-bus 0
+//      ...
+//
+//      CricketCanvasText(0,6,"TEMP");              // Text in digits 0-5, blank filled
+//      CricketCanvasNumber(6,5,-123,1,0);          // "-12.3" in digits 6-10
+//      CricketCanvasPat(12,Segs,4);                // Raw patterns in digits 12-15
+//      CricketCanvasClear();                       // Blank everything
+//
+//      CricketCanvasFlush();                       // Send the panels that changed
+//
+//  DESCRIPTION
+//
+//      Virtual canvas over many LED displays.
+//
+//      The canvas is one row of CRICKET_CANVAS_PANELS*4 digits. Each group of 4 digits
+//        (a panel) is mapped to a display, as a bus and device ID. The bus is
+//        CRICKET_CANVAS_BUS for the main cricket bus, or a CricketMulti bus number.
+//
+//      Writes go into the canvas buffer, and a write that changes any digit of a
+//        panel marks that panel dirty. CricketCanvasFlush() sends one pattern frame
+//        per dirty panel, so updating one field on a 32-digit board costs one or two
+//        frames, not eight. Multi-bus frames are queued, then sent together with one
+//        CricketMultiSend() at the end.
+//
+//      Define CRICKET_CANVAS_MULTI to enable panels on CricketMulti buses.
+//
+//      Unmapped panels are never sent. Mapping a panel marks it dirty, so that it gets
+//        sent on the next flush.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CRICKETCANVAS_H
+#define CRICKETCANVAS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "CricketLED.h"
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// User configurable options
+//
+#ifndef CRICKET_CANVAS_PANELS
+#define CRICKET_CANVAS_PANELS   8           // Number of 4-digit displays (max 16)
+#endif
+
+//#define CRICKET_CANVAS_MULTI              // Panels on CricketMulti buses
+
+//
+// End of user configurable options
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#define CRICKET_CANVAS_DIGITS   (4*CRICKET_CANVAS_PANELS)
+#define CRICKET_CANVAS_BUS      0xFF        // Bus number of the main cricket bus
+
+#ifdef CRICKET_CANVAS_MULTI
+#include "CricketMulti.h"
+#endif
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketCanvasMap - Map a panel to a display
+//
+// Inputs:      Panel number (digits 4*Panel to 4*Panel+3)
+//              Bus (CRICKET_CANVAS_BUS, or a CricketMulti bus in CRICKET_MULTI_MASK)
+//              Device ID (0, 1 or 2)
+//
+// Outputs:     None.
+//
+void CricketCanvasMap(uint8_t Panel,uint8_t Bus,uint8_t ID);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketCanvasPat    - Write segment patterns to the canvas
+// CricketCanvasText   - Write text to a field, left justified and blank filled
+// CricketCanvasNumber - Write a number to a field, right justified (see CricketNumber.h)
+//
+// Anything past the end of the canvas is dropped.
+//
+// Inputs:      First digit
+//              [Pat]    Patterns, and number of them
+//              [Text]   Field width, and text (NUL terminated, in RAM)
+//              [Number] Field width, value, decimals and flags (CRICKET_NUM_xxx)
+//
+// Outputs:     [Number] TRUE if the number fit, FALSE if dashes are shown
+//
+void CricketCanvasPat   (uint8_t Pos,const uint8_t *Segs,uint8_t Len);
+void CricketCanvasText  (uint8_t Pos,uint8_t Width,const char *Text);
+bool CricketCanvasNumber(uint8_t Pos,uint8_t Width,int32_t Value,uint8_t Decimals,uint8_t Flags);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketCanvasClear - Blank the whole canvas
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void CricketCanvasClear(void);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketCanvasFlush - Send every panel that changed since the last flush
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void CricketCanvasFlush(void);
+
+#endif  // CRICKETCANVAS_H - entire file
@@ -0,0 +1,278 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      CricketComp.c
+//
+//  SYNOPSIS
+//
+//      CricketCompDec(1025,ID);            // Base layer: "1025"
+//      CricketCompHex(0x1025,ID);          // Base layer: "1025" in hex
+//      CricketCompBase(a,b,c,d,ID);        // Base layer: segment patterns
+//
+//      CricketCompBlink(0,0,0xFF,0xFF,ID); // Blink the last two digits
+//      CricketCompDots(0x04,ID);           // Decimal point on digit 3 (bit per digit)
+//      CricketCompOverlay(a,b,c,d,ID);     // Extra segments, on top of the base
+//
+//      CricketCompAlert(a,b,c,d,100,ID);   // Flash an alert for 100 ticks (0 == forever)
+//      CricketCompAlertOff(ID);            // Back to the layers
+//
+//      CricketCompTick();                  // Called every CRICKET_TICK_MS
+//
+//  DESCRIPTION
+//
+//      Cricket LED display compositor. See CricketComp.h
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+
+#include "CricketComp.h"
+#include "PortMacros.h"
+
+#define COMP_BLINK_TICKS    ((CRICKET_COMP_BLINK_MS+CRICKET_TICK_MS/2)/CRICKET_TICK_MS)
+
+#if COMP_BLINK_TICKS < 1 || COMP_BLINK_TICKS > 255
+#   error "CricketComp.h: CRICKET_COMP_BLINK_MS out of range for CRICKET_TICK_MS"
+#endif
+
+typedef struct {
+    uint8_t     Base   [4];
+    uint8_t     Overlay[4];
+    uint8_t     Blink  [4];
+    uint8_t     Dots;                       // Bit per digit
+    uint8_t     Alert  [4];
+    uint16_t    AlertTicks;                 // Ticks left, 0 == forever
+    bool        AlertOn;
+    bool        Active;                     // Compositor owns this display
+    bool        Known;                      // Shown is valid
+    uint8_t     Shown  [4];                 // Last pattern sent
+    } COMP_DISPLAY;
+
+static struct {
+    COMP_DISPLAY Display[CRICKET_LED_IDS];
+
+    uint8_t     BlinkTicks;                 // Ticks left in this half of the cycle
+    bool        BlinkOff;                   // TRUE in the off half
+    } Comp;
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// SetLayer - Set one 4-digit layer, and start compositing the display
+//
+// Inputs:      Device ID
+//              Layer to set
+//              Pattern, as four bytes
+//
+// Outputs:     None.
+//
+static void SetLayer(uint8_t ID,uint8_t *Layer,uint8_t Dig1,uint8_t Dig2,uint8_t Dig3,uint8_t Dig4) {
+
+    Layer[0] = Dig1;
+    Layer[1] = Dig2;
+    Layer[2] = Dig3;
+    Layer[3] = Dig4;
+    Comp.Display[ID].Active = true;
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketCompBase - Set the base layer from segment patterns
+// CricketCompDec  - Set the base layer to a number in decimal (0-9999)
+// CricketCompHex  - Set the base layer to a number in hex
+//
+// Decimal numbers have their leading zeros blanked.
+//
+// Inputs:      Pattern, as four bytes (or number to show)
+//              Device ID (0, 1 or 2)
+//
+// Outputs:     None.
+//
+void CricketCompBase(uint8_t Dig1,uint8_t Dig2,uint8_t Dig3,uint8_t Dig4,uint8_t ID) {
+
+    if( ID < CRICKET_LED_IDS )
+        SetLayer(ID,Comp.Display[ID].Base,Dig1,Dig2,Dig3,Dig4);
+    }
+
+void CricketCompDec(uint16_t Number,uint8_t ID) {
+    uint8_t Digits[4];
+    int8_t  Index;
+
+    if( Number > 9999 )
+        Number = 9999;
+
+    for( Index = 3; Index >= 0; Index-- ) {
+        Digits[Index] = (Number || Index == 3) ? CricketCompSegment(Number % 10) : 0;
+        Number /= 10;
+        }
+
+    CricketCompBase(Digits[0],Digits[1],Digits[2],Digits[3],ID);
+    }
+
+void CricketCompHex(uint16_t Number,uint8_t ID) {
+
+    CricketCompBase(CricketCompSegment((Number >> 12) & 0x0F),
+                    CricketCompSegment((Number >>  8) & 0x0F),
+                    CricketCompSegment((Number >>  4) & 0x0F),
+                    CricketCompSegment((Number >>  0) & 0x0F),ID);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketCompOverlay - Set the overlay layer (segments always on)
+// CricketCompBlink   - Set the blink layer (segments that blink)
+// CricketCompDots    - Set the decimal points
+//
+// Inputs:      Segment masks, as four bytes (or bit per digit, for dots)
+//              Device ID (0, 1 or 2)
+//
+// Outputs:     None.
+//
+void CricketCompOverlay(uint8_t Dig1,uint8_t Dig2,uint8_t Dig3,uint8_t Dig4,uint8_t ID) {
+
+    if( ID < CRICKET_LED_IDS )
+        SetLayer(ID,Comp.Display[ID].Overlay,Dig1,Dig2,Dig3,Dig4);
+    }
+
+void CricketCompBlink(uint8_t Dig1,uint8_t Dig2,uint8_t Dig3,uint8_t Dig4,uint8_t ID) {
+
+    if( ID < CRICKET_LED_IDS )
+        SetLayer(ID,Comp.Display[ID].Blink,Dig1,Dig2,Dig3,Dig4);
+    }
+
+void CricketCompDots(uint8_t Dots,uint8_t ID) {
+
+    if( ID >= CRICKET_LED_IDS )
+        return;
+
+    Comp.Display[ID].Dots   = Dots;
+    Comp.Display[ID].Active = true;
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketCompAlert    - Flash an alert pattern in place of the layers
+// CricketCompAlertOff - Stop the alert
+//
+// Inputs:      [CricketCompAlert] Pattern, as four bytes
+//              [CricketCompAlert] Ticks to show the alert, 0 == until CricketCompAlertOff
+//              Device ID (0, 1 or 2)
+//
+// Outputs:     None.
+//
+void CricketCompAlert(uint8_t Dig1,uint8_t Dig2,uint8_t Dig3,uint8_t Dig4,uint16_t Ticks,uint8_t ID) {
+
+    if( ID >= CRICKET_LED_IDS )
+        return;
+
+    SetLayer(ID,Comp.Display[ID].Alert,Dig1,Dig2,Dig3,Dig4);
+    Comp.Display[ID].AlertTicks = Ticks;
+    Comp.Display[ID].AlertOn    = true;
+    }
+
+void CricketCompAlertOff(uint8_t ID) {
+
+    if( ID < CRICKET_LED_IDS )
+        Comp.Display[ID].AlertOn = false;
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketCompTick - Merge the layers and update the displays that changed
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void CricketCompTick(void) {
+    uint8_t ID;
+
+    if( Comp.BlinkTicks == 0 ) {
+        Comp.BlinkTicks = COMP_BLINK_TICKS;
+        Comp.BlinkOff   = !Comp.BlinkOff;
+        }
+    Comp.BlinkTicks--;
+
+    for( ID = 0; ID < CRICKET_LED_IDS; ID++ ) {
+        COMP_DISPLAY *Display = &Comp.Display[ID];
+        uint8_t       Frame[4];
+        uint8_t       Digit;
+
+        if( !Display->Active )
+            continue;
+
+        if( Display->AlertOn && Display->AlertTicks != 0 && --Display->AlertTicks == 0 )
+            Display->AlertOn = false;
+
+        for( Digit = 0; Digit < 4; Digit++ ) {
+            if( Display->AlertOn )
+                Frame[Digit] = Comp.BlinkOff ? 0 : Display->Alert[Digit];
+            else {
+                Frame[Digit] = Display->Base[Digit] | Display->Overlay[Digit];
+                if( _BIT_ON(Display->Dots,Digit) )
+                    Frame[Digit] |= CRICKET_SEG_DP;
+                if( Comp.BlinkOff )
+                    Frame[Digit] &= ~Display->Blink[Digit];
+                }
+            }
+
+        if( Display->Known && memcmp(Frame,Display->Shown,4) == 0 )
+            continue;
+
+        CricketLEDPat(Frame[0],Frame[1],Frame[2],Frame[3],ID);
+        memcpy(Display->Shown,Frame,4);
+        Display->Known = true;
+        }
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketCompSegment - Return the segment pattern for a hex digit
+//
+// Inputs:      Digit, 0-15
+//
+// Outputs:     Segment pattern (0 if out of range)
+//
+uint8_t CricketCompSegment(uint8_t Digit) {
+
+    if( Digit > 15 )
+        return(0);
+
+    return(CricketFontChar(Digit < 10 ? '0'+Digit : 'A'-10+Digit));
+    }
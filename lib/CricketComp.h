@@ -0,0 +1,175 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      CricketComp.h - Cricket LED display compositor
+//
+//  SYNOPSIS
+//
+//      CricketCompDec(1025,ID);            // Base layer: "1025"
+//      CricketCompHex(0x1025,ID);          // Base layer: "1025" in hex
+//      CricketCompBase(a,b,c,d,ID);        // Base layer: segment patterns
+//
+//      CricketCompBlink(0,0,0xFF,0xFF,ID); // Blink the last two digits
+//      CricketCompDots(0x04,ID);           // Decimal point on digit 3 (bit per digit)
+//      CricketCompOverlay(a,b,c,d,ID);     // Extra segments, on top of the base
+//
+//      CricketCompAlert(a,b,c,d,100,ID);   // Flash an alert for 100 ticks (0 == forever)
+//      CricketCompAlertOff(ID);            // Back to the layers
+//
+//      CricketCompTick();                  // Called every CRICKET_TICK_MS
+//
+//  DESCRIPTION
+//
+//      Display compositor.
+//
+//      The compositor keeps a 4-digit segment framebuffer per display ID (segment bits
+//        as in CricketLEDPat, see CricketLED.h) and builds it from layers:
+//
+//          Base            The value shown, as segment patterns
+//          Overlay         Segments OR'ed on top (decimal points from CricketCompDots)
+//          Blink           Segments that turn off in the off half of the blink cycle
+//          Alert           If active, replaces everything else and flashes
+//
+//      CricketCompTick() merges the layers for each display and sends a pattern frame
+//        only when the result has changed. The layer calls just update memory, so
+//        they're cheap to call as often as the application likes.
+//
+//      Per tick the cost is fixed: one merge per display, and at most one pattern frame
+//        (6 bytes of bus time) per display.
+//
+//      A display ID is only composited after one of the calls above has been made for
+//        it, so other displays can still be driven with the CricketLEDxxx() calls.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CRICKETCOMP_H
+#define CRICKETCOMP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "CricketLED.h"
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Blink timing: time on, then the same time off
+//
+#ifndef CRICKET_COMP_BLINK_MS
+#define CRICKET_COMP_BLINK_MS   250
+#endif
+
+//
+// End of user configurable options
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketCompBase - Set the base layer from segment patterns
+// CricketCompDec  - Set the base layer to a number in decimal (0-9999)
+// CricketCompHex  - Set the base layer to a number in hex
+//
+// Inputs:      Pattern, as four bytes (or number to show)
+//              Device ID (0, 1 or 2)
+//
+// Outputs:     None.
+//
+void CricketCompBase(uint8_t Dig1,uint8_t Dig2,uint8_t Dig3,uint8_t Dig4,uint8_t ID);
+void CricketCompDec (uint16_t Number,uint8_t ID);
+void CricketCompHex (uint16_t Number,uint8_t ID);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketCompOverlay - Set the overlay layer (segments always on)
+// CricketCompBlink   - Set the blink layer (segments that blink)
+//
+// Inputs:      Segment masks, as four bytes
+//              Device ID (0, 1 or 2)
+//
+// Outputs:     None.
+//
+void CricketCompOverlay(uint8_t Dig1,uint8_t Dig2,uint8_t Dig3,uint8_t Dig4,uint8_t ID);
+void CricketCompBlink  (uint8_t Dig1,uint8_t Dig2,uint8_t Dig3,uint8_t Dig4,uint8_t ID);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketCompDots - Set the decimal points
+//
+// Inputs:      Bit per digit, bit 0 == leftmost digit
+//              Device ID (0, 1 or 2)
+//
+// Outputs:     None.
+//
+void CricketCompDots(uint8_t Dots,uint8_t ID);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketCompAlert    - Flash an alert pattern in place of the layers
+// CricketCompAlertOff - Stop the alert
+//
+// Inputs:      [CricketCompAlert] Pattern, as four bytes
+//              [CricketCompAlert] Ticks to show the alert, 0 == until CricketCompAlertOff
+//              Device ID (0, 1 or 2)
+//
+// Outputs:     None.
+//
+void CricketCompAlert(uint8_t Dig1,uint8_t Dig2,uint8_t Dig3,uint8_t Dig4,uint16_t Ticks,uint8_t ID);
+void CricketCompAlertOff(uint8_t ID);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketCompTick - Merge the layers and update the displays that changed
+//
+// Call once every CRICKET_TICK_MS, from the main loop.
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void CricketCompTick(void);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketCompSegment - Return the segment pattern for a hex digit
+//
+// Inputs:      Digit, 0-15
+//
+// Outputs:     Segment pattern (0 if out of range)
+//
+uint8_t CricketCompSegment(uint8_t Digit);
+
+#endif  // CRICKETCOMP_H - entire file
@@ -0,0 +1,317 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      CricketDeadline.c
+//
+//  SYNOPSIS
+//
+//      CricketDeadlineInit();              // Called once at startup, after CricketBusInit()
+//
+//      uint32_t When = CricketDeadlineNow() + CRICKET_DEADLINE_US(1000000);
+//
+//      CricketDeadlinePat(When,a,b,c,d,ID);        // Pattern frame, start bit at When
+//      CricketDeadlinePut(When,Frame,Len);         // Any frame
+//
+//      uint32_t When;
+//      int32_t  LateUS;
+//      while( CricketDeadlineReport(&When,&LateUS) )   // How it went, per frame
+//          ...
+//
+//  DESCRIPTION
+//
+//      Frames sent at a set time. See CricketDeadline.h
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+#include "CricketDeadline.h"
+#include "PortMacros.h"
+
+#if CRICKET_BUS_DRIVER != CRICKET_DRIVER_TIMER && CRICKET_BUS_DRIVER != CRICKET_DRIVER_OCR
+#   error "CricketDeadline.c: needs the timer or OCR bus driver (Timer1 at the CPU clock)"
+#endif
+
+#if !CRICKET_BUS_ISR_PUT
+#   error "CricketDeadline.c: puts frames from an interrupt, set CRICKET_BUS_ISR_PUT"
+#endif
+
+#define DEADLINE_REPORT_WRAP    (CRICKET_DEADLINE_REPORTS-1)
+
+typedef struct {
+    uint32_t    When;
+    uint8_t     Frame[CRICKET_DEADLINE_FRAME_MAX];
+    uint8_t     Len;
+    } DEADLINE_FRAME;
+
+typedef struct {
+    uint32_t    When;
+    int32_t     Late;                       // Timer1 counts
+    } DEADLINE_REPORT;
+
+static struct {
+    uint16_t        Wraps;                  // Timer1 overflows, top of the 32-bit clock
+    DEADLINE_FRAME  Queue[CRICKET_DEADLINE_QUEUE];      // In deadline order
+    uint8_t         Queued;
+    uint32_t        Armed;                  // Deadline of the frame in the bus
+    uint32_t        Expect;                 //   ...when its start bit should go out
+    bool            Waiting;                //   ...TRUE while waiting for its start bit
+    DEADLINE_REPORT Report[CRICKET_DEADLINE_REPORTS];
+    uint8_t         Report_In;
+    uint8_t         Report_Out;
+    } Deadline;
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketDeadlineInit - Start the 32-bit clock
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void CricketDeadlineInit(void) {
+
+    memset(&Deadline,0,sizeof(Deadline));
+
+    TIFR1 = _PIN_MASK(TOV1);                            // Clear stale overflow
+    _SET_BIT(TIMSK1,TOIE1);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Now - Return the time, interrupts already off
+//
+// If Timer1 wrapped since the last overflow interrupt (because interrupts are off),
+//   count the wrap here.
+//
+// Inputs:      None.
+//
+// Outputs:     Time, in Timer1 counts
+//
+static uint32_t Now(void) {
+    uint16_t Count = TCNT1;
+    uint16_t Wraps = Deadline.Wraps;
+
+    if( _BIT_ON(TIFR1,TOV1) && Count < 0x8000 )
+        Wraps++;
+
+    return(((uint32_t) Wraps << 16) | Count);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketDeadlineNow - Return the time
+//
+// Inputs:      None.
+//
+// Outputs:     Time, in Timer1 counts (CPU clocks)
+//
+uint32_t CricketDeadlineNow(void) {
+    uint8_t  SaveSREG = SREG;
+    uint32_t Time;
+
+    cli();
+    Time = Now();
+    SREG = SaveSREG;
+
+    return(Time);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketDeadlinePut - Queue a frame to start at a set time
+// CricketDeadlinePat - Queue an LED pattern frame to start at a set time
+//
+// Inputs:      Time of the first start bit (from CricketDeadlineNow)
+//              [Put] Frame (first byte is sent as a command), and length
+//              [Pat] Pattern, as four bytes, and device ID
+//
+// Outputs:     TRUE  if queued
+//              FALSE if the queue is full (or the frame is too long)
+//
+bool CricketDeadlinePut(uint32_t When,const uint8_t *Frame,uint8_t Len) {
+    uint8_t SaveSREG = SREG;
+    uint8_t Index;
+    bool    Success  = false;
+
+    if( Len == 0 || Len > CRICKET_DEADLINE_FRAME_MAX )
+        return(false);
+
+    cli();                                              // Queue is used by the ISR
+
+    if( Deadline.Queued < CRICKET_DEADLINE_QUEUE ) {
+
+        //
+        // Insert after any frames due sooner (or at the same time)
+        //
+        for( Index = Deadline.Queued; Index > 0; Index-- ) {
+            if( (int32_t) (When - Deadline.Queue[Index-1].When) >= 0 )
+                break;
+            }
+
+        memmove(&Deadline.Queue[Index+1],&Deadline.Queue[Index],
+                (Deadline.Queued-Index)*sizeof(DEADLINE_FRAME));
+
+        Deadline.Queue[Index].When = When;
+        Deadline.Queue[Index].Len  = Len;
+        memcpy(Deadline.Queue[Index].Frame,Frame,Len);
+        Deadline.Queued++;
+        Success = true;
+        }
+
+    SREG = SaveSREG;
+
+    return(Success);
+    }
+
+bool CricketDeadlinePat(uint32_t When,uint8_t Dig1,uint8_t Dig2,uint8_t Dig3,uint8_t Dig4,uint8_t ID) {
+    uint8_t Frame[6] = { CRICKET_BUS_LED, CRICKET_LED_PAT+ID, Dig1, Dig2, Dig3, Dig4 };
+
+    return(CricketDeadlinePut(When,Frame,sizeof(Frame)));
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketDeadlineReport - Return how a frame went
+//
+// Inputs:      Where to put the frame's deadline
+//              Where to put how late the start bit was, in uS (negative if early)
+//
+// Outputs:     TRUE  if a report was returned
+//              FALSE if none are waiting
+//
+bool CricketDeadlineReport(uint32_t *When,int32_t *LateUS) {
+    uint8_t          SaveSREG = SREG;
+    DEADLINE_REPORT  Report;
+
+    cli();
+
+    if( Deadline.Report_In == Deadline.Report_Out ) {
+        SREG = SaveSREG;
+        return(false);
+        }
+
+    Report = Deadline.Report[Deadline.Report_Out];
+    Deadline.Report_Out = (Deadline.Report_Out+1) & DEADLINE_REPORT_WRAP;
+
+    SREG = SaveSREG;
+
+    *When   = Report.When;
+    *LateUS = Report.Late/(int32_t) CRICKET_DEADLINE_PER_US;
+
+    return(true);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// TIMER1_OVF_vect - Extend the clock, and hand frames that are coming due to the bus
+//
+// Runs every 65536 CPU clocks. A frame whose kick (CRICKET_START_LEAD counts ahead
+//   of its start bit) is due before the next overflow is put in the held bus FIFO,
+//   with the kick programmed to start it on time. Going by the start bit instead
+//   would leave a deadline just after the next overflow with its kick already past.
+//
+// Inputs:      None. (ISR)
+//
+// Outputs:     None.
+//
+ISR(TIMER1_OVF_vect) {
+    DEADLINE_FRAME *Frame = &Deadline.Queue[0];
+    uint32_t        Time;
+    uint16_t        Started;
+    uint8_t         Index;
+
+    Deadline.Wraps++;
+
+    Time = Now();
+
+    //
+    // Report on the frame handed over last time, once its start bit is out. That
+    //   was near when it was expected (the deadline, or right away if handed over
+    //   late), so the 16-bit bus time extends from there. Counting back from now
+    //   won't do: a kick armed just before the wrap starts it after this overflow.
+    //
+    if( Deadline.Waiting && CricketBusStarted(&Started) ) {
+        uint8_t NewIn = (Deadline.Report_In+1) & DEADLINE_REPORT_WRAP;
+
+        Deadline.Waiting = false;
+
+        if( NewIn != Deadline.Report_Out ) {
+            uint32_t Actual = Deadline.Expect + (int16_t) (Started - (uint16_t) Deadline.Expect);
+
+            Deadline.Report[Deadline.Report_In].When = Deadline.Armed;
+            Deadline.Report[Deadline.Report_In].Late = (int32_t) (Actual - Deadline.Armed);
+            Deadline.Report_In = NewIn;
+            }
+        }
+
+    if( Deadline.Waiting || Deadline.Queued == 0 )
+        return;
+
+    if( (int32_t) (Frame->When - CRICKET_START_LEAD - Time) > 0xFFFFL )
+        return;                                         // Kick not due yet
+
+    if( !CricketBusHold() )
+        return;                                         // Busy, try again next time
+
+    for( Index = 0; Index < Frame->Len; Index++ )
+        CricketBusPut(Frame->Frame[Index],Index == 0);
+
+    //
+    // If it's already late, go now
+    //
+    if( (int32_t) (Frame->When - Time) < 0 ) {
+        CricketBusStartAt((uint16_t) Time,0);
+        Deadline.Expect = Time;
+        }
+    else {
+        CricketBusStartAt((uint16_t) Time,Frame->When - Time);
+        Deadline.Expect = Frame->When;
+        }
+
+    Deadline.Armed   = Frame->When;
+    Deadline.Waiting = true;
+
+    Deadline.Queued--;
+    memmove(&Deadline.Queue[0],&Deadline.Queue[1],Deadline.Queued*sizeof(DEADLINE_FRAME));
+    }
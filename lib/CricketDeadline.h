@@ -0,0 +1,165 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      CricketDeadline.h - Frames sent at a set time
+//
+//  SYNOPSIS
+//
+//      CricketDeadlineInit();              // Called once at startup, after CricketBusInit()
+//
+//      uint32_t When = CricketDeadlineNow() + CRICKET_DEADLINE_US(1000000);
+//
+//      CricketDeadlinePat(When,a,b,c,d,ID);        // Pattern frame, start bit at When
+//      CricketDeadlinePut(When,Frame,Len);         // Any frame
+//
+//      uint32_t When;
+//      int32_t  LateUS;
+//      while( CricketDeadlineReport(&When,&LateUS) )   // How it went, per frame
+//          ...
+//
+//  DESCRIPTION
+//
+//      Frames sent at a set time.
+//
+//      Time is Timer1 (which the timer and OCR bus drivers run at the CPU clock),
+//        extended to 32 bits by the Timer1 overflow interrupt. That's 62.5 nS per count
+//        at 16 MHz, wrapping every 268 seconds. CRICKET_DEADLINE_US() converts.
+//
+//      Frames are queued in deadline order. In the overflow interrupt before the bus
+//        kick for a frame's deadline (a pre-start ahead of it), if the bus is idle, the frame is put in the bus FIFO with the
+//        transmitter held, and the bus idle kick is programmed on the compare channel
+//        so that the pre-start begins early and the first start bit goes out at the
+//        deadline. With the OCR driver that edge is exact; with the timer driver it's
+//        late by the interrupt latency, a few uS.
+//
+//      The time the start bit really went out is read back from the bus driver, and
+//        CricketDeadlineReport() returns each frame's deadline and how late (or, never
+//        in practice, early) it was, in uS.
+//
+//      If the bus is busy when a frame comes due, the frame waits for the next
+//        overflow (4 mS at 16 MHz) and goes out as soon as the bus is free, and the
+//        report shows it as late. Keep other traffic clear of deadlines, such as by
+//        sending it through CricketSched.
+//
+//  NOTES
+//
+//      The display changes at the end of the frame, CRICKET_FRAME_US(Len) after the
+//        start bit. Subtract that from the deadline if the change itself has to be
+//        on time.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CRICKETDEADLINE_H
+#define CRICKETDEADLINE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "CricketBus.h"
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// User configurable options
+//
+#ifndef CRICKET_DEADLINE_QUEUE
+#define CRICKET_DEADLINE_QUEUE  4           // Frames waiting for their deadline
+#endif
+
+//
+// The report FIFO must be a power of two long, since the code uses a mask for
+//   wraparound.
+//
+#ifndef CRICKET_DEADLINE_REPORTS
+#define CRICKET_DEADLINE_REPORTS (1 << 2)   // == 4 reports
+#endif
+
+//
+// End of user configurable options
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#define CRICKET_DEADLINE_FRAME_MAX  6       // Longest frame
+
+#define CRICKET_DEADLINE_PER_US     (F_CPU/1000000UL)           // Timer1 counts per uS
+#define CRICKET_DEADLINE_US(_us_)   ((uint32_t) (_us_)*CRICKET_DEADLINE_PER_US)
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketDeadlineInit - Start the 32-bit clock
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void CricketDeadlineInit(void);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketDeadlineNow - Return the time
+//
+// Inputs:      None.
+//
+// Outputs:     Time, in Timer1 counts (CPU clocks)
+//
+uint32_t CricketDeadlineNow(void);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketDeadlinePut - Queue a frame to start at a set time
+// CricketDeadlinePat - Queue an LED pattern frame to start at a set time
+//
+// Inputs:      Time of the first start bit (from CricketDeadlineNow)
+//              [Put] Frame (first byte is sent as a command), and length
+//              [Pat] Pattern, as four bytes, and device ID
+//
+// Outputs:     TRUE  if queued
+//              FALSE if the queue is full (or the frame is too long)
+//
+bool CricketDeadlinePut(uint32_t When,const uint8_t *Frame,uint8_t Len);
+bool CricketDeadlinePat(uint32_t When,uint8_t Dig1,uint8_t Dig2,uint8_t Dig3,uint8_t Dig4,uint8_t ID);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketDeadlineReport - Return how a frame went
+//
+// Inputs:      Where to put the frame's deadline
+//              Where to put how late the start bit was, in uS (negative if early)
+//
+// Outputs:     TRUE  if a report was returned
+//              FALSE if none are waiting
+//
+bool CricketDeadlineReport(uint32_t *When,int32_t *LateUS);
+
+#endif  // CRICKETDEADLINE_H - entire file
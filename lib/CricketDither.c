@@ -0,0 +1,245 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      CricketDither.c
+//
+//  SYNOPSIS
+//
+//      CricketDitherPat(a,b,c,d,ID);       // Start dithering a pattern on display ID
+//      CricketDitherLevels(8,8,2,8,ID);    // Per-digit intensity, 0 (off) to 8 (full)
+//      CricketDitherStop(ID);              // Back to the plain (full intensity) pattern
+//
+//      if( CricketDitherBusy(ID) ) ...     // TRUE while dithering
+//
+//      uint16_t FPS = CricketDitherRate(); // Pattern frames per second, last second
+//
+//      CricketDitherService();             // Called as often as possible, from the main loop
+//      CricketDitherTick();                // Called every CRICKET_TICK_MS
+//
+//  DESCRIPTION
+//
+//      Per-digit dimming by temporal dithering. See CricketDither.h
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+
+#include "CricketDither.h"
+#include "PortMacros.h"
+
+#define DITHER_SECOND_TICKS ((1000+CRICKET_TICK_MS/2)/CRICKET_TICK_MS)
+
+typedef struct {
+    uint8_t     Pat  [4];                   // Full pattern
+    uint8_t     Level[4];                   // Intensity per digit
+    uint8_t     Acc  [4];                   // Sigma-delta accumulator per digit
+    bool        LevelSet;                   // TRUE once Level has been set
+    bool        Dithering;
+    } DITHER;
+
+static DITHER Dither[CRICKET_LED_IDS];
+
+static struct {
+    uint8_t     Next;                       // ID to look at next, round robin
+    uint16_t    Frames;                     // Frames sent this second
+    uint16_t    Ticks;                      // Ticks into this second
+    uint16_t    Rate;                       // Frames sent last second
+    } Rate;
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketDitherPat - Start dithering a pattern on a display
+//
+// Inputs:      Pattern, as four bytes (see CricketLEDPat)
+//              Device ID (0, 1 or 2)
+//
+// Outputs:     None.
+//
+void CricketDitherPat(uint8_t Dig1,uint8_t Dig2,uint8_t Dig3,uint8_t Dig4,uint8_t ID) {
+    DITHER *D;
+
+    if( ID >= CRICKET_LED_IDS )
+        return;
+
+    D = &Dither[ID];
+
+    //
+    // The shadow holds the full pattern, for CricketDitherStop
+    //
+    CricketLEDPat(Dig1,Dig2,Dig3,Dig4,ID);
+
+    D->Pat[0] = Dig1;
+    D->Pat[1] = Dig2;
+    D->Pat[2] = Dig3;
+    D->Pat[3] = Dig4;
+
+    if( !D->Dithering ) {
+        memset(D->Acc,0,sizeof(D->Acc));
+        if( !D->LevelSet )
+            CricketDitherLevels(CRICKET_DITHER_FULL,CRICKET_DITHER_FULL,
+                                CRICKET_DITHER_FULL,CRICKET_DITHER_FULL,ID);
+        D->Dithering = true;
+        }
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketDitherLevels - Set per-digit intensity
+//
+// Inputs:      Intensity of each digit, 0 (off) to CRICKET_DITHER_FULL
+//              Device ID (0, 1 or 2)
+//
+// Outputs:     None.
+//
+void CricketDitherLevels(uint8_t Lev1,uint8_t Lev2,uint8_t Lev3,uint8_t Lev4,uint8_t ID) {
+    DITHER *D;
+
+    if( ID >= CRICKET_LED_IDS )
+        return;
+
+    D = &Dither[ID];
+
+    D->Level[0] = Lev1 > CRICKET_DITHER_FULL ? CRICKET_DITHER_FULL : Lev1;
+    D->Level[1] = Lev2 > CRICKET_DITHER_FULL ? CRICKET_DITHER_FULL : Lev2;
+    D->Level[2] = Lev3 > CRICKET_DITHER_FULL ? CRICKET_DITHER_FULL : Lev3;
+    D->Level[3] = Lev4 > CRICKET_DITHER_FULL ? CRICKET_DITHER_FULL : Lev4;
+    D->LevelSet = true;
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketDitherStop - Stop dithering, and show the plain pattern
+// CricketDitherBusy - Return TRUE if a display is dithering
+//
+// Inputs:      Device ID (0, 1 or 2)
+//
+// Outputs:     [CricketDitherBusy] TRUE if dithering
+//
+void CricketDitherStop(uint8_t ID) {
+
+    if( ID >= CRICKET_LED_IDS || !Dither[ID].Dithering )
+        return;
+
+    Dither[ID].Dithering = false;
+    CricketLEDRefresh(ID);
+    }
+
+bool CricketDitherBusy(uint8_t ID) {
+
+    if( ID >= CRICKET_LED_IDS )
+        return(false);
+
+    return(Dither[ID].Dithering);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketDitherRate - Return the frame rate
+//
+// Inputs:      None.
+//
+// Outputs:     Pattern frames sent in the last full second (all displays)
+//
+uint16_t CricketDitherRate(void) { return(Rate.Rate); }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketDitherService - Send the next dithered frame, if the bus has room
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void CricketDitherService(void) {
+    uint8_t Index;
+
+    //
+    // Wait until the frame being sent is nearly done, so the next one is queued
+    //   just in time and always has the latest levels.
+    //
+    if( CricketBusQueued() >= CRICKET_DITHER_FRAME || CricketBusRoom() < CRICKET_DITHER_FRAME )
+        return;
+
+    for( Index = 0; Index < CRICKET_LED_IDS; Index++ ) {
+        uint8_t ID = Rate.Next;
+        DITHER *D  = &Dither[ID];
+        uint8_t Digit;
+
+        if( ++Rate.Next >= CRICKET_LED_IDS )
+            Rate.Next = 0;
+
+        if( !D->Dithering )
+            continue;
+
+        CricketBusPut(CRICKET_BUS_LED,true);
+        CricketBusPut(CRICKET_LED_PAT+ID,false);
+
+        for( Digit = 0; Digit < 4; Digit++ ) {
+            D->Acc[Digit] += D->Level[Digit];
+            if( D->Acc[Digit] >= CRICKET_DITHER_FULL ) {
+                D->Acc[Digit] -= CRICKET_DITHER_FULL;
+                CricketBusPut(D->Pat[Digit],false);
+                }
+            else
+                CricketBusPut(0,false);
+            }
+
+        Rate.Frames++;
+        return;
+        }
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketDitherTick - Keep track of the frame rate
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void CricketDitherTick(void) {
+
+    if( ++Rate.Ticks < DITHER_SECOND_TICKS )
+        return;
+
+    Rate.Rate   = Rate.Frames;
+    Rate.Frames = 0;
+    Rate.Ticks  = 0;
+    }
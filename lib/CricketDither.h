@@ -0,0 +1,180 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      CricketDither.h - Per-digit dimming by temporal dithering
+//
+//  SYNOPSIS
+//
+//      CricketDitherPat(a,b,c,d,ID);       // Start dithering a pattern on display ID
+//      CricketDitherLevels(8,8,2,8,ID);    // Per-digit intensity, 0 (off) to 8 (full)
+//      CricketDitherStop(ID);              // Back to the plain (full intensity) pattern
+//
+//      if( CricketDitherBusy(ID) ) ...     // TRUE while dithering
+//
+//      uint16_t FPS = CricketDitherRate(); // Pattern frames per second, last second
+//
+//      CricketDitherService();             // Called as often as possible, from the main loop
+//      CricketDitherTick();                // Called every CRICKET_TICK_MS
+//
+//  DESCRIPTION
+//
+//      Per-digit dimming for the LED displays, by temporal dithering.
+//
+//      The display brightness command applies to the whole display. To dim single
+//        digits, the pattern is resent over and over, with each digit blanked in a
+//        fraction of the frames set by its intensity level. The eye averages this out
+//        when the frame rate is high enough.
+//
+//      Each digit has a sigma-delta accumulator, so a digit at level N is lit in
+//        exactly N of every CRICKET_DITHER_FULL frames, spread as evenly as possible.
+//        That keeps the flicker frequency as high as the frame rate allows.
+//
+//      Frame rate is limited by the bus. A pattern frame is 6 bytes, about 1.3 ms, so
+//        the bus tops out near 790 frames per second, shared among the dithering
+//        displays. CricketDitherService() puts the next frame in the bus FIFO as soon
+//        as less than one frame is left to send, so the bus never goes idle between
+//        frames, and new levels take effect within about two frames. It has to be
+//        called at least once a millisecond or so to keep up.
+//
+//      CricketDitherRate() returns the frames sent in the last full second, measured
+//        with CricketDitherTick().
+//
+//  NOTES
+//
+//      Dithered frames go straight to the bus, around the CricketLED shadow (and
+//        CricketSched, if used). CricketDitherPat() records the full pattern in the
+//        shadow, and CricketDitherStop() resends it with CricketLEDRefresh().
+//
+//      Don't use CricketComp, CricketAnim or CricketMarquee on a display while it's
+//        dithering.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CRICKETDITHER_H
+#define CRICKETDITHER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "CricketLED.h"
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// User configurable options
+//
+#ifndef CRICKET_DITHER_FULL
+#define CRICKET_DITHER_FULL     8           // Intensity levels 0 (off) to full
+#endif
+
+//
+// End of user configurable options
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#define CRICKET_DITHER_FRAME    6           // Bytes in a pattern frame
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketDitherPat - Start dithering a pattern on a display
+//
+// Intensity levels are left as they are (all full, the first time).
+//
+// Inputs:      Pattern, as four bytes (see CricketLEDPat)
+//              Device ID (0, 1 or 2)
+//
+// Outputs:     None.
+//
+void CricketDitherPat(uint8_t Dig1,uint8_t Dig2,uint8_t Dig3,uint8_t Dig4,uint8_t ID);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketDitherLevels - Set per-digit intensity
+//
+// Inputs:      Intensity of each digit, 0 (off) to CRICKET_DITHER_FULL
+//              Device ID (0, 1 or 2)
+//
+// Outputs:     None.
+//
+void CricketDitherLevels(uint8_t Lev1,uint8_t Lev2,uint8_t Lev3,uint8_t Lev4,uint8_t ID);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketDitherStop - Stop dithering, and show the plain pattern
+// CricketDitherBusy - Return TRUE if a display is dithering
+//
+// Inputs:      Device ID (0, 1 or 2)
+//
+// Outputs:     [CricketDitherBusy] TRUE if dithering
+//
+void CricketDitherStop(uint8_t ID);
+bool CricketDitherBusy(uint8_t ID);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketDitherRate - Return the frame rate
+//
+// Inputs:      None.
+//
+// Outputs:     Pattern frames sent in the last full second (all displays)
+//
+uint16_t CricketDitherRate(void);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketDitherService - Send the next dithered frame, if the bus has room
+//
+// Call as often as possible, from the main loop.
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void CricketDitherService(void);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketDitherTick - Keep track of the frame rate
+//
+// Call once every CRICKET_TICK_MS, from the main loop.
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void CricketDitherTick(void);
+
+#endif  // CRICKETDITHER_H - entire file
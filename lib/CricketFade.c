@@ -0,0 +1,199 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      CricketFade.c
+//
+//  SYNOPSIS
+//
+//      CricketFadeTo(7,500,1);             // Fade display 1 up to level 7 over 500 ms
+//      CricketFadeTo(0,2000,2);            // ...while display 2 fades down over 2 sec
+//      CricketFade(0,7,1000,0);            // Fade all displays from level 0 to 7
+//      CricketFadeStop(ID);                // Stop fading (brightness stays where it is)
+//
+//      if( CricketFadeBusy(ID) ) ...       // TRUE while fading
+//
+//      CricketFadeTick();                  // Called every CRICKET_TICK_MS
+//
+//  DESCRIPTION
+//
+//      Brightness fades for the LED displays. See CricketFade.h
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#include <avr/pgmspace.h>
+
+#include "CricketFade.h"
+#include "PortMacros.h"
+
+//
+// Brightness level for each point on the perceptual scale,
+//
+//   Level = round(7 * (Step/31)^2.2)
+//
+static const uint8_t Gamma[CRICKET_FADE_STEPS] PROGMEM = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1,
+    2, 2, 2, 2, 3, 3, 3, 4, 4, 4, 5, 5, 6, 6, 7, 7,
+    };
+
+//
+// ...and the first point on the scale for each level
+//
+static const uint8_t GammaStep[CRICKET_FADE_LEVELS] PROGMEM = {
+     0, 10, 16, 20, 23, 26, 28, 30,
+    };
+
+typedef struct {
+    int16_t     Step;                       // Point on the scale, 8.8 fixed point
+    int16_t     Rate;                       // Change per tick, 8.8 fixed point
+    uint16_t    Ticks;                      // Ticks left in the fade
+    uint8_t     To;                         // Final level
+    uint8_t     Level;                      // Level last sent
+    bool        Known;                      // TRUE if Level has been sent
+    bool        Fading;
+    } FADER;
+
+static FADER Fader[CRICKET_LED_IDS];
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketFade   - Fade a display from one brightness level to another
+// CricketFadeTo - Fade a display from its current level to another
+//
+// Inputs:      [CricketFade] Level to start from, 0-7
+//              Level to end at, 0-7
+//              Time for the fade, in ms (0 == right away)
+//              Device ID (0, 1 or 2)
+//
+// Outputs:     None.
+//
+void CricketFade(uint8_t From,uint8_t To,uint16_t MS,uint8_t ID) {
+    FADER  *F;
+    int16_t Start;
+    int16_t End;
+
+    if( ID >= CRICKET_LED_IDS )
+        return;
+
+    F = &Fader[ID];
+
+    From &= CRICKET_FADE_LEVELS-1;
+    To   &= CRICKET_FADE_LEVELS-1;
+
+    Start = pgm_read_byte(&GammaStep[From]);
+    End   = pgm_read_byte(&GammaStep[To]);
+
+    F->Fading = false;
+    F->Step   = Start << 8;
+    F->To     = To;
+    F->Ticks  = (MS + CRICKET_TICK_MS/2)/CRICKET_TICK_MS;
+
+    if( F->Ticks == 0 )
+        F->Ticks = 1;
+
+    F->Rate   = ((int32_t) (End - Start) << 8)/F->Ticks;
+
+    CricketLEDBright(From,ID);
+    F->Level  = From;
+    F->Known  = true;
+    F->Fading = true;
+    }
+
+void CricketFadeTo(uint8_t To,uint16_t MS,uint8_t ID) {
+
+    if( ID >= CRICKET_LED_IDS )
+        return;
+
+    CricketFade(Fader[ID].Known ? Fader[ID].Level : CRICKET_FADE_LEVELS-1,To,MS,ID);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketFadeStop - Stop fading (brightness stays where it is)
+// CricketFadeBusy - Return TRUE if a display is fading
+//
+// Inputs:      Device ID (0, 1 or 2)
+//
+// Outputs:     [CricketFadeBusy] TRUE if fading, FALSE if stopped or done
+//
+void CricketFadeStop(uint8_t ID) {
+
+    if( ID < CRICKET_LED_IDS )
+        Fader[ID].Fading = false;
+    }
+
+bool CricketFadeBusy(uint8_t ID) {
+
+    if( ID >= CRICKET_LED_IDS )
+        return(false);
+
+    return(Fader[ID].Fading);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketFadeTick - Advance every active fade by one tick
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void CricketFadeTick(void) {
+    uint8_t ID;
+
+    for( ID = 0; ID < CRICKET_LED_IDS; ID++ ) {
+        FADER  *F = &Fader[ID];
+        uint8_t Level;
+
+        if( !F->Fading )
+            continue;
+
+        //
+        // The last tick lands exactly on the final level, whatever the rounding
+        //   in Rate did along the way.
+        //
+        if( --F->Ticks == 0 ) {
+            Level     = F->To;
+            F->Fading = false;
+            }
+        else {
+            F->Step += F->Rate;
+            Level    = pgm_read_byte(&Gamma[(F->Step + 0x80) >> 8]);
+            }
+
+        if( Level != F->Level ) {
+            CricketLEDBright(Level,ID);
+            F->Level = Level;
+            }
+        }
+    }
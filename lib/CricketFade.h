@@ -0,0 +1,115 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      CricketFade.h - Brightness fades for the LED displays
+//
+//  SYNOPSIS
+//
+//      CricketFadeTo(7,500,1);             // Fade display 1 up to level 7 over 500 ms
+//      CricketFadeTo(0,2000,2);            // ...while display 2 fades down over 2 sec
+//      CricketFade(0,7,1000,0);            // Fade all displays from level 0 to 7
+//      CricketFadeStop(ID);                // Stop fading (brightness stays where it is)
+//
+//      if( CricketFadeBusy(ID) ) ...       // TRUE while fading
+//
+//      CricketFadeTick();                  // Called every CRICKET_TICK_MS
+//
+//  DESCRIPTION
+//
+//      Brightness fades for the LED displays.
+//
+//      The display has 8 brightness levels (0-7), which are roughly linear in light
+//        output. A linear ramp through them looks like it jumps at the low end and
+//        crawls at the top, so fades move linearly along a perceptual scale instead,
+//        and a gamma table in PROGMEM maps each point on the scale to a level.
+//
+//      CricketFadeTick() advances every active fade, one per device ID, so fades on
+//        both displays run at once. The application only starts them; each tick is
+//        an add and a table lookup, and a CRICKET_LED_BRIGHT frame goes out only when
+//        the level changes (at most 7 frames per fade).
+//
+//      CricketFadeTo() fades from the level the fader last set on that ID (or from
+//        level 7 if it hasn't set one). Use CricketFade() to give the starting level.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CRICKETFADE_H
+#define CRICKETFADE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "CricketLED.h"
+
+#define CRICKET_FADE_LEVELS     8           // Brightness levels 0-7
+#define CRICKET_FADE_STEPS      32          // Points on the perceptual scale
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketFade   - Fade a display from one brightness level to another
+// CricketFadeTo - Fade a display from its current level to another
+//
+// Inputs:      [CricketFade] Level to start from, 0-7
+//              Level to end at, 0-7
+//              Time for the fade, in ms (0 == right away)
+//              Device ID (0, 1 or 2)
+//
+// Outputs:     None.
+//
+void CricketFade(uint8_t From,uint8_t To,uint16_t MS,uint8_t ID);
+void CricketFadeTo(uint8_t To,uint16_t MS,uint8_t ID);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketFadeStop - Stop fading (brightness stays where it is)
+// CricketFadeBusy - Return TRUE if a display is fading
+//
+// Inputs:      Device ID (0, 1 or 2)
+//
+// Outputs:     [CricketFadeBusy] TRUE if fading, FALSE if stopped or done
+//
+void CricketFadeStop(uint8_t ID);
+bool CricketFadeBusy(uint8_t ID);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketFadeTick - Advance every active fade by one tick
+//
+// Call once every CRICKET_TICK_MS, from the main loop.
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void CricketFadeTick(void);
+
+#endif  // CRICKETFADE_H - entire file
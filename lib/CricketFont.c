@@ -0,0 +1,117 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      CricketFont.c
+//
+//  SYNOPSIS
+//
+//      CricketLEDText("HELP",0,ID);        // Show text (see CricketLED.h)
+//      CricketLEDText("12.5C",0,ID);       // '.' lights the decimal point of the digit before
+//      CricketLEDText("ON",0x01,ID);       // Dots: extra decimal points, bit 0 == leftmost
+//
+//      uint8_t Seg = CricketFontChar('A');         // Segments for one char, from flash
+//      uint8_t Segs[8];
+//      uint8_t Len = CricketFontText("Err.",Segs,sizeof(Segs));   // Text to segments
+//
+//      uint8_t Seg = CRICKET_SEG('A');             // Same, as a compile time constant
+//
+//      //////////////////////////////////////
+//      //
+//      // C++ only
+//      //
+//      CricketLEDTextC("Err.",ID);         // Text converted at compile time, no lookups
+//
+//  DESCRIPTION
+//
+//      7-segment font for the cricket LED display. See CricketFont.h
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#include <avr/pgmspace.h>
+
+#include "CricketFont.h"
+#include "PortMacros.h"
+
+//
+// The font table, ' ' to '_', built from CRICKET_FONT
+//
+#define FONT_ENTRY(_A_,_Char_,_Seg_)    [(_Char_)-CRICKET_FONT_FIRST] = (_Seg_),
+
+static const uint8_t Font[CRICKET_FONT_LAST-CRICKET_FONT_FIRST+1] PROGMEM = {
+    CRICKET_FONT(FONT_ENTRY,0)
+    };
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketFontChar - Return the segments for one character
+//
+// Inputs:      Character
+//
+// Outputs:     Segment pattern (0x00 if not in the font)
+//
+uint8_t CricketFontChar(char Char) {
+
+    Char = CRICKET_UPPER(Char);
+
+    if( Char < CRICKET_FONT_FIRST || Char > CRICKET_FONT_LAST )
+        return(0x00);
+
+    return(pgm_read_byte(&Font[Char-CRICKET_FONT_FIRST]));
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketFontText - Convert text to segment patterns
+//
+// Inputs:      Text (NUL terminated)
+//              Where to put the segment patterns
+//              Max patterns to make
+//
+// Outputs:     Number of patterns made (digits used)
+//
+uint8_t CricketFontText(const char *Text,uint8_t *Segs,uint8_t Max) {
+    uint8_t Len = 0;
+
+    while( *Text && Len < Max ) {
+        if( *Text == '.' )
+            Segs[Len] = CRICKET_SEG_DP;
+        else {
+            Segs[Len] = CricketFontChar(*Text);
+            if( Text[1] == '.' )
+                Segs[Len] |= CRICKET_SEG_DP, Text++;
+            }
+        Text++;
+        Len++;
+        }
+
+    return(Len);
+    }
@@ -0,0 +1,195 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      CricketFont.h - 7-segment font for the cricket LED display
+//
+//  SYNOPSIS
+//
+//      CricketLEDText("HELP",0,ID);        // Show text (see CricketLED.h)
+//      CricketLEDText("12.5C",0,ID);       // '.' lights the decimal point of the digit before
+//      CricketLEDText("ON",0x01,ID);       // Dots: extra decimal points, bit 0 == leftmost
+//
+//      uint8_t Seg = CricketFontChar('A');         // Segments for one char, from flash
+//      uint8_t Segs[8];
+//      uint8_t Len = CricketFontText("Err.",Segs,sizeof(Segs));   // Text to segments
+//
+//      uint8_t Seg = CRICKET_SEG('A');             // Same, as a compile time constant
+//
+//      //////////////////////////////////////
+//      //
+//      // C++ only
+//      //
+//      CricketLEDTextC("Err.",ID);         // Text converted at compile time, no lookups
+//
+//  DESCRIPTION
+//
+//      7-segment font for the cricket LED display.
+//
+//      The font is defined once, as the X-macro CRICKET_FONT below, with segment bits as
+//        in the CricketLEDPat diagram (CricketLED.h). It expands to a PROGMEM table for
+//        run time lookups, and to CRICKET_SEG(), a constant expression for use with
+//        character constants.
+//
+//      Lower case letters use the upper case glyph (several of which are the lower case
+//        shapes anyway, such as b, d, n and r). Characters not in the font are blank.
+//
+//      In text, a '.' lights the decimal point of the digit before it. A '.' at the
+//        start, or after another '.', takes a digit of its own.
+//
+//      In C++, CricketTextSeg() does the same as CricketFontText() as a constexpr, and
+//        CricketLEDTextC() uses it to turn a string literal into four constant segment
+//        bytes when compiling. The message costs no RAM, no font lookups and no text
+//        in flash - just the four bytes in the call.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CRICKETFONT_H
+#define CRICKETFONT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define CRICKET_SEG_DP          0x80        // Decimal point segment (bit 7)
+
+//
+// The font: character and segment pattern. _X_ is called as _X_(_A_,Char,Segments)
+//
+//                   bit 0
+//                 ----------
+//                |          |
+//             5  |          |  1
+//                |    6     |
+//                 ----------
+//                |          |
+//             4  |          |  2
+//                |    3     |
+//                 ----------  
+//                              x bit 7
+//
+#define CRICKET_FONT(_X_,_A_)                                                           \
+    _X_(_A_,' ' ,0x00) _X_(_A_,'-' ,0x40) _X_(_A_,'_' ,0x08) _X_(_A_,'=' ,0x48)         \
+    _X_(_A_,'"' ,0x22) _X_(_A_,'\'',0x02) _X_(_A_,'[' ,0x39) _X_(_A_,']' ,0x0F)         \
+    _X_(_A_,'(' ,0x39) _X_(_A_,')' ,0x0F) _X_(_A_,'?' ,0x53) _X_(_A_,'/' ,0x52)         \
+    _X_(_A_,'*' ,0x63) _X_(_A_,'0' ,0x3F) _X_(_A_,'1' ,0x06) _X_(_A_,'2' ,0x5B)         \
+    _X_(_A_,'3' ,0x4F) _X_(_A_,'4' ,0x66) _X_(_A_,'5' ,0x6D) _X_(_A_,'6' ,0x7D)         \
+    _X_(_A_,'7' ,0x07) _X_(_A_,'8' ,0x7F) _X_(_A_,'9' ,0x6F) _X_(_A_,'A' ,0x77)         \
+    _X_(_A_,'B' ,0x7C) _X_(_A_,'C' ,0x39) _X_(_A_,'D' ,0x5E) _X_(_A_,'E' ,0x79)         \
+    _X_(_A_,'F' ,0x71) _X_(_A_,'G' ,0x3D) _X_(_A_,'H' ,0x76) _X_(_A_,'I' ,0x30)         \
+    _X_(_A_,'J' ,0x1E) _X_(_A_,'K' ,0x75) _X_(_A_,'L' ,0x38) _X_(_A_,'M' ,0x37)         \
+    _X_(_A_,'N' ,0x54) _X_(_A_,'O' ,0x3F) _X_(_A_,'P' ,0x73) _X_(_A_,'Q' ,0x67)         \
+    _X_(_A_,'R' ,0x50) _X_(_A_,'S' ,0x6D) _X_(_A_,'T' ,0x78) _X_(_A_,'U' ,0x3E)         \
+    _X_(_A_,'V' ,0x1C) _X_(_A_,'W' ,0x2A) _X_(_A_,'X' ,0x76) _X_(_A_,'Y' ,0x6E)         \
+    _X_(_A_,'Z' ,0x5B)
+
+#define CRICKET_FONT_FIRST      ' '         // Table covers ' ' to '_'
+#define CRICKET_FONT_LAST       '_'
+
+//
+// CRICKET_SEG - Segments for one character, as a constant expression
+//
+// Expands to a chain of compares, so use it with constants (where the compiler does
+//   all the work). Use CricketFontChar() for variables.
+//
+#define CRICKET_UPPER(_c_)      (((_c_) >= 'a' && (_c_) <= 'z') ? (_c_) - 'a' + 'A' : (_c_))
+#define _CRICKET_SEG_IF(_c_,_Char_,_Seg_)   CRICKET_UPPER(_c_) == (_Char_) ? (_Seg_) :
+#define CRICKET_SEG(_c_)        ((uint8_t) CRICKET_SEG_OF(_c_))
+#define CRICKET_SEG_OF(_c_)     (CRICKET_FONT(_CRICKET_SEG_IF,_c_) 0x00)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketFontChar - Return the segments for one character
+//
+// Inputs:      Character
+//
+// Outputs:     Segment pattern (0x00 if not in the font)
+//
+uint8_t CricketFontChar(char Char);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketFontText - Convert text to segment patterns
+//
+// Inputs:      Text (NUL terminated)
+//              Where to put the segment patterns
+//              Max patterns to make
+//
+// Outputs:     Number of patterns made (digits used)
+//
+uint8_t CricketFontText(const char *Text,uint8_t *Segs,uint8_t Max);
+
+#ifdef __cplusplus
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketTextSeg - Segments for one digit of a string literal, at compile time
+//
+// Inputs:      Text
+//              Digit number, 0 == leftmost
+//
+// Outputs:     Segment pattern, with decimal point per the '.' rules above
+//
+constexpr const char *CricketTextNext(const char *Text) {
+    return( *Text == 0   ? Text   :
+            *Text == '.' ? Text+1 :
+            Text[1] == '.' ? Text+2 : Text+1 );
+    }
+
+constexpr const char *CricketTextAt(const char *Text,uint8_t Digit) {
+    return( Digit == 0 ? Text : CricketTextAt(CricketTextNext(Text),Digit-1) );
+    }
+
+constexpr uint8_t CricketTextSegAt(const char *Text) {
+    return( *Text == 0   ? 0x00           :
+            *Text == '.' ? CRICKET_SEG_DP :
+            (uint8_t) (CRICKET_SEG_OF(*Text) | (Text[1] == '.' ? CRICKET_SEG_DP : 0)) );
+    }
+
+constexpr uint8_t CricketTextSeg(const char *Text,uint8_t Digit) {
+    return( CricketTextSegAt(CricketTextAt(Text,Digit)) );
+    }
+
+template<uint8_t _Seg_> struct CricketConstSeg { static constexpr uint8_t Value = _Seg_; };
+
+#define CricketLEDTextC(_Text_,_ID_)                                                    \
+    CricketLEDPat(CricketConstSeg<CricketTextSeg(_Text_,0)>::Value,                     \
+                  CricketConstSeg<CricketTextSeg(_Text_,1)>::Value,                     \
+                  CricketConstSeg<CricketTextSeg(_Text_,2)>::Value,                     \
+                  CricketConstSeg<CricketTextSeg(_Text_,3)>::Value,_ID_)
+
+#endif  // __cplusplus
+
+#endif  // CRICKETFONT_H - entire file
@@ -0,0 +1,319 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      CricketLED.c
+//
+//  SYNOPSIS
+//
+//      CricketBusInit();                   // Called once at startup (see CricketBus.h)
+//
+//      In the calls below, ID can be zero (for "any"), or 1 or 2 to identify
+//        which of two LED displays are connected. See Cricket LED display documentation for
+//        how to set the device ID (involves cutting a trace on the board).
+//
+//      CricketLEDDec(1025,ID);             // Display numeric "1025" on LED display
+//      CricketLEDHex(0x1025,ID);           // Display numeric "1025" on LED display
+//      CricketLEDBright(7,ID);             // Set brightness level to 7
+//
+//      CricketLEDPat(a,b,c,d,ID);          // Set segments based on pattern (see notes below)
+//
+//      CricketLEDRefresh(ID);              // Resend display state, after a power glitch
+//
+//  DESCRIPTION
+//
+//      Cricket LED display driver. See CricketLED.h
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+
+#include "CricketLED.h"
+#include "PortMacros.h"
+
+#define LED_UNKNOWN     0xFF                // Shadow Mode/Bright: not known
+
+#if defined(CRICKET_LED_SCHED) && CRICKET_SCHED_DEPTH < 2*CRICKET_LED_IDS
+#   error "CricketLED.c: CRICKET_SCHED_DEPTH too small for CRICKET_LED_SCHED"
+#endif
+
+//
+// What one display (ID) is currently showing
+//
+typedef struct {
+    uint8_t Mode;                           // CRICKET_LED_NUMBER, _HEX, _PAT or LED_UNKNOWN
+    uint8_t Data[4];                        // Number (high, low) or pattern
+    uint8_t Bright;                         // Brightness level or LED_UNKNOWN
+    } LED_SHADOW;
+
+static LED_SHADOW Shadow[CRICKET_LED_IDS];
+static bool       ShadowInit;
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// SendFrame - Send one LED frame out the bus
+//
+// Inputs:      Command (CRICKET_LED_xxx)
+//              Device ID
+//              Data bytes to send
+//              Number of data bytes
+//
+// Outputs:     None.
+//
+static void SendFrame(uint8_t Command,uint8_t ID,const uint8_t *Data,uint8_t Len) {
+#ifdef CRICKET_LED_SCHED
+    uint8_t Frame[CRICKET_SCHED_FRAME_MAX];
+    uint8_t Key = (Command == CRICKET_LED_BRIGHT ? 0x80 : 0x00) | ID;
+
+    Frame[0] = CRICKET_BUS_LED;
+    Frame[1] = Command+ID;
+    memcpy(&Frame[2],Data,Len);
+
+    //
+    // There are only 2 keys per ID, so LED frames on their own never fill the class
+    //   queue and this doesn't wait.
+    //
+    while( !CricketSchedPut(CRICKET_LED_SCHED,Key,Frame,Len+2) )
+        CricketSchedService();
+#else
+    CricketBusPutW(CRICKET_BUS_LED,true);
+    CricketBusPutW(Command+ID,false);
+    while( Len-- )
+        CricketBusPutW(*Data++,false);
+#endif
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CheckShadow - Set up the shadows the first time through
+//
+// Done on first use, so that the application can call CricketLEDxxx() without an
+//   init call of its own. Everything starts out unknown.
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+static void CheckShadow(void) {
+
+    if( ShadowInit )
+        return;
+
+    memset(Shadow,LED_UNKNOWN,sizeof(Shadow));
+    ShadowInit = true;
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// SetContents - Send display contents, if they change what's shown
+//
+// Inputs:      Mode (CRICKET_LED_NUMBER, _HEX or _PAT)
+//              Device ID
+//              Data bytes (2 for numbers, 4 for pattern)
+//
+// Outputs:     None.
+//
+static void SetContents(uint8_t Mode,uint8_t ID,const uint8_t *Data) {
+    uint8_t Len = (Mode == CRICKET_LED_PAT) ? 4 : 2;
+    uint8_t Index;
+
+    if( ID >= CRICKET_LED_IDS )
+        return;
+
+    CheckShadow();
+
+    //
+    // ID 0 hits every display, so it's only redundant if they all match.
+    //
+    for( Index = 0; Index < CRICKET_LED_IDS; Index++ ) {
+        if( ID != 0 && Index != ID )
+            continue;
+        if( Shadow[Index].Mode != Mode || memcmp(Shadow[Index].Data,Data,Len) != 0 )
+            break;
+        }
+
+    if( Index == CRICKET_LED_IDS )
+        return;                                         // No change
+
+    SendFrame(Mode,ID,Data,Len);
+
+    for( Index = 0; Index < CRICKET_LED_IDS; Index++ ) {
+        if( ID == 0 || Index == ID ) {
+            Shadow[Index].Mode = Mode;
+            memcpy(Shadow[Index].Data,Data,Len);
+            }
+        }
+
+    if( ID != 0 )
+        Shadow[0].Mode = LED_UNKNOWN;
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketLEDDec - Display one 16-bit number in decimal
+// CricketLEDHex - Display one 16-bit number in hexadecimal
+//
+// Inputs:      Number to display
+//              Device ID (0, 1 or 2)
+//
+// Outputs:     None.
+//
+void CricketLEDDec(uint16_t Number,uint8_t ID) {
+    uint8_t Data[2] = { Number >> 8, Number & 0xFF };
+
+    SetContents(CRICKET_LED_NUMBER,ID,Data);
+    }
+
+void CricketLEDHex(uint16_t Number,uint8_t ID) {
+    uint8_t Data[2] = { Number >> 8, Number & 0xFF };
+
+    SetContents(CRICKET_LED_HEX,ID,Data);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketLEDPat - Set the display based on a pattern
+//
+// Inputs:      Pattern, as four bytes, each bit representing a digit segment
+//              Device ID (0, 1 or 2)
+//
+// Outputs:     None.
+//
+void CricketLEDPat(uint8_t Dig1,uint8_t Dig2,uint8_t Dig3,uint8_t Dig4,uint8_t ID) {
+    uint8_t Data[4] = { Dig1, Dig2, Dig3, Dig4 };
+
+    SetContents(CRICKET_LED_PAT,ID,Data);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketLEDText - Display text
+//
+// Inputs:      Text (NUL terminated, in RAM)
+//              Extra decimal points, bit 0 == leftmost digit
+//              Device ID (0, 1 or 2)
+//
+// Outputs:     None.
+//
+void CricketLEDText(const char *Text,uint8_t Dots,uint8_t ID) {
+    uint8_t Data[4] = { 0, 0, 0, 0 };
+    uint8_t Index;
+
+    CricketFontText(Text,Data,sizeof(Data));
+
+    for( Index = 0; Index < 4; Index++ ) {
+        if( Dots & (1 << Index) )
+            Data[Index] |= CRICKET_SEG_DP;
+        }
+
+    SetContents(CRICKET_LED_PAT,ID,Data);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketLEDBright - Set the display brightness level (1-7)
+//
+// Inputs:      Brightness level 1-7
+//              Device ID (0, 1 or 2)
+//
+// Outputs:     None.
+//
+void CricketLEDBright(uint8_t Level,uint8_t ID) {
+    uint8_t Data[2];
+    uint8_t Index;
+
+    if( ID >= CRICKET_LED_IDS )
+        return;
+
+    CheckShadow();
+
+    Level &= 0x07;
+
+    for( Index = 0; Index < CRICKET_LED_IDS; Index++ ) {
+        if( (ID == 0 || Index == ID) && Shadow[Index].Bright != Level )
+            break;
+        }
+
+    if( Index == CRICKET_LED_IDS )
+        return;                                         // No change
+
+    Data[0] = 0;
+    Data[1] = Level;
+    SendFrame(CRICKET_LED_BRIGHT,ID,Data,2);
+
+    for( Index = 0; Index < CRICKET_LED_IDS; Index++ ) {
+        if( ID == 0 || Index == ID )
+            Shadow[Index].Bright = Level;
+        }
+
+    if( ID != 0 )
+        Shadow[0].Bright = LED_UNKNOWN;
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketLEDRefresh - Resend the remembered state of a display
+//
+// Inputs:      Device ID (0, 1 or 2)
+//
+// Outputs:     None.
+//
+void CricketLEDRefresh(uint8_t ID) {
+    LED_SHADOW *Display;
+
+    if( ID >= CRICKET_LED_IDS )
+        return;
+
+    CheckShadow();
+
+    Display = &Shadow[ID];
+
+    if( Display->Mode != LED_UNKNOWN )
+        SendFrame(Display->Mode,ID,Display->Data,Display->Mode == CRICKET_LED_PAT ? 4 : 2);
+
+    if( Display->Bright != LED_UNKNOWN ) {
+        uint8_t Data[2] = { 0, Display->Bright };
+
+        SendFrame(CRICKET_LED_BRIGHT,ID,Data,2);
+        }
+    }
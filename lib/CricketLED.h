@@ -0,0 +1,195 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      CricketLED.h - Cricket LED display driver
+//
+//  SYNOPSIS
+//
+//      CricketBusInit();                   // Called once at startup (see CricketBus.h)
+//
+//      In the calls below, ID can be zero (for "any"), or 1 or 2 to identify
+//        which of two LED displays are connected. See Cricket LED display documentation for
+//        how to set the device ID (involves cutting a trace on the board).
+//
+//      CricketLEDDec(1025,ID);             // Display numeric "1025" on LED display
+//      CricketLEDHex(0x1025,ID);           // Display numeric "1025" on LED display
+//      CricketLEDBright(7,ID);             // Set brightness level to 7
+//
+//      CricketLEDPat(a,b,c,d,ID);          // Set segments based on pattern (see notes below)
+//      CricketLEDText("HELP",0,ID);        // Show text, using the font in CricketFont.h
+//      CricketLEDText("12.5C",0,ID);       // '.' lights the decimal point of the digit before
+//      CricketLEDText("ON",0x01,ID);       // Dots: extra decimal points, bit 0 == leftmost
+//
+//      CricketLEDTextC("Err.",ID);         // C++ only: same, with the text encoded at compile time
+//
+//      CricketLEDRefresh(ID);              // Resend display state, after a power glitch
+//
+//  DESCRIPTION
+//
+//      Cricket LED display driver, with a shadow copy of each display's state.
+//
+//      The driver remembers what was last sent to each device ID (mode, value or
+//        pattern, and brightness). A call that wouldn't change what the display
+//        shows is dropped without touching the bus, so the application can call
+//        CricketLEDDec() &c every time through its loop at no cost.
+//
+//      Writes to ID 0 go to every display, so they update all the shadows. Writes
+//        to ID 1 or 2 make the ID 0 shadow unknown, since the displays no longer
+//        necessarily match.
+//
+//  NOTES
+//
+//      If a display loses power (or is plugged in late), it won't match the shadow.
+//        Call CricketLEDRefresh() to send the full state again.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CRICKETLED_H
+#define CRICKETLED_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "CricketBus.h"
+#include "CricketFont.h"
+
+#define CRICKET_LED_IDS     3               // Device IDs 0 (any), 1 and 2
+
+//
+// Define CRICKET_LED_SCHED to send LED frames through the frame scheduler in that
+//   class (see CricketSched.h), rather than straight to the bus. Queued contents and
+//   brightness frames for an ID are superseded by newer ones.
+//
+//#define CRICKET_LED_SCHED   CRICKET_SCHED_DISPLAY
+
+#ifdef CRICKET_LED_SCHED
+#include "CricketSched.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketLEDDec - Display one 16-bit number in decimal
+//
+// Inputs:      Number to display
+//              Device ID (0, 1 or 2)
+//
+// Outputs:     None.
+//
+void CricketLEDDec(uint16_t Number,uint8_t ID);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketLEDHex - Display one 16-bit number in hexadecimal
+//
+// Inputs:      Number to display
+//              Device ID (0, 1 or 2)
+//
+// Outputs:     None.
+//
+void CricketLEDHex(uint16_t Number,uint8_t ID);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketLEDBright - Set the display brightness level (1-7)
+//
+// Inputs:      Brightness level 1-7
+//              Device ID (0, 1 or 2)
+//
+// Outputs:     None.
+//
+void CricketLEDBright(uint8_t Level,uint8_t ID);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketLEDPat - Set the display based on a pattern
+//
+// Inputs:      Pattern, as four bytes, each bit representing a digit segment
+//              Device ID (0, 1 or 2)
+//
+// Outputs:     None.
+//
+//                   bit 0
+//                 ----------
+//                |          |
+//                |          |
+//             5  |          |  1
+//                |    6     |
+//                 ----------
+//                |          |
+//                |          |
+//             4  |          |  2
+//                |    3     |
+//                 ----------  
+//                              x bit 7
+//
+void CricketLEDPat(uint8_t Dig1,uint8_t Dig2,uint8_t Dig3,uint8_t Dig4,uint8_t ID);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketLEDText - Display text
+//
+// Text is left justified and blank filled, and anything past the 4th digit is dropped.
+//   A '.' lights the decimal point of the digit before it (see CricketFont.h).
+//
+// Inputs:      Text (NUL terminated, in RAM)
+//              Extra decimal points, bit 0 == leftmost digit
+//              Device ID (0, 1 or 2)
+//
+// Outputs:     None.
+//
+void CricketLEDText(const char *Text,uint8_t Dots,uint8_t ID);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketLEDRefresh - Resend the remembered state of a display
+//
+// Sends the last display contents and brightness for the ID, whether or not they
+//   appear to have changed. Anything never set is left alone.
+//
+// Inputs:      Device ID (0, 1 or 2)
+//
+// Outputs:     None.
+//
+void CricketLEDRefresh(uint8_t ID);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // CRICKETLED_H - entire file
@@ -0,0 +1,168 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      CricketMarquee.c
+//
+//  SYNOPSIS
+//
+//      CricketMarqueeText("HELLO 12.5",200,true);  // Scroll text, 200 ms per step, looping
+//      CricketMarqueeSpeed(100);                   // Change scroll speed
+//      CricketMarqueeStop();                       // Stop (the displays keep what's shown)
+//
+//      if( CricketMarqueeBusy() ) ...              // TRUE while scrolling
+//
+//      CricketMarqueeTick();                       // Called every CRICKET_TICK_MS
+//
+//  DESCRIPTION
+//
+//      Scrolling text across the LED displays. See CricketMarquee.h
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+
+#include "CricketMarquee.h"
+#include "PortMacros.h"
+
+#if CRICKET_MARQUEE_DISPLAYS < 1 || CRICKET_MARQUEE_DISPLAYS >= CRICKET_LED_IDS
+#   error "CricketMarquee.h: CRICKET_MARQUEE_DISPLAYS out of range"
+#endif
+
+#if CRICKET_MARQUEE_MAX+CRICKET_MARQUEE_DIGITS > 255
+#   error "CricketMarquee.h: CRICKET_MARQUEE_MAX too large"
+#endif
+
+static struct {
+    uint8_t     Text  [CRICKET_MARQUEE_MAX];        // Text, as segments
+    uint8_t     Window[CRICKET_MARQUEE_DIGITS];     // What's shown
+    uint8_t     Len;                                // Segments in Text
+    uint8_t     Next;                               // Next position to scroll in
+    uint8_t     End;                                // Position where a pass ends
+    uint16_t    StepTicks;                          // Ticks per step
+    uint16_t    Ticks;                              // Ticks left on this step
+    bool        Loop;
+    bool        Scrolling;
+    } Marquee;
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketMarqueeText - Start scrolling text
+//
+// Inputs:      Text (NUL terminated, in RAM), converted to segments before returning
+//              Time per step, in ms
+//              TRUE to loop forever
+//
+// Outputs:     None.
+//
+void CricketMarqueeText(const char *Text,uint16_t StepMS,bool Loop) {
+
+    Marquee.Scrolling = false;
+
+    Marquee.Len  = CricketFontText(Text,Marquee.Text,sizeof(Marquee.Text));
+    Marquee.Next = 0;
+    Marquee.End  = Marquee.Len + (Loop ? CRICKET_MARQUEE_GAP : CRICKET_MARQUEE_DIGITS);
+    Marquee.Loop = Loop;
+    memset(Marquee.Window,0,sizeof(Marquee.Window));
+
+    CricketMarqueeSpeed(StepMS);
+    Marquee.Ticks     = 1;                          // First step on the next tick
+    Marquee.Scrolling = true;
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketMarqueeSpeed - Change the scroll speed
+//
+// Inputs:      Time per step, in ms
+//
+// Outputs:     None.
+//
+void CricketMarqueeSpeed(uint16_t StepMS) {
+    uint16_t Ticks = (StepMS + CRICKET_TICK_MS/2)/CRICKET_TICK_MS;
+
+    Marquee.StepTicks = Ticks ? Ticks : 1;
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketMarqueeStop - Stop scrolling (the displays keep what's shown)
+// CricketMarqueeBusy - Return TRUE if text is scrolling
+//
+// Inputs:      None.
+//
+// Outputs:     [CricketMarqueeBusy] TRUE if scrolling, FALSE if stopped or done
+//
+void CricketMarqueeStop(void) { Marquee.Scrolling = false; }
+bool CricketMarqueeBusy(void) { return(Marquee.Scrolling); }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketMarqueeTick - Scroll one tick
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void CricketMarqueeTick(void) {
+    uint8_t ID;
+
+    if( !Marquee.Scrolling || --Marquee.Ticks )
+        return;
+
+    Marquee.Ticks = Marquee.StepTicks;
+
+    //
+    // Past the text it's blanks, until the end of the pass
+    //
+    if( Marquee.Next == Marquee.End ) {
+        if( !Marquee.Loop ) {
+            Marquee.Scrolling = false;
+            return;
+            }
+        Marquee.Next = 0;
+        }
+
+    memmove(&Marquee.Window[0],&Marquee.Window[1],CRICKET_MARQUEE_DIGITS-1);
+    Marquee.Window[CRICKET_MARQUEE_DIGITS-1] =
+        Marquee.Next < Marquee.Len ? Marquee.Text[Marquee.Next] : 0;
+    Marquee.Next++;
+
+    for( ID = 1; ID <= CRICKET_MARQUEE_DISPLAYS; ID++ ) {
+        uint8_t *Digits = &Marquee.Window[4*(ID-1)];
+
+        CricketLEDPat(Digits[0],Digits[1],Digits[2],Digits[3],ID);
+        }
+    }
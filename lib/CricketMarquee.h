@@ -0,0 +1,149 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      CricketMarquee.h - Scrolling text across the LED displays
+//
+//  SYNOPSIS
+//
+//      CricketMarqueeText("HELLO 12.5",200,true);  // Scroll text, 200 ms per step, looping
+//      CricketMarqueeSpeed(100);                   // Change scroll speed
+//      CricketMarqueeStop();                       // Stop (the displays keep what's shown)
+//
+//      if( CricketMarqueeBusy() ) ...              // TRUE while scrolling
+//
+//      CricketMarqueeTick();                       // Called every CRICKET_TICK_MS
+//
+//  DESCRIPTION
+//
+//      Scrolling text on the LED displays.
+//
+//      The two displays (IDs 1 and 2) are treated as one 8-digit strip, ID 1 on the
+//        left. Text enters at the right and scrolls left one digit per step.
+//
+//      The text is converted to segments once, by CricketMarqueeText(). Each step
+//        shifts the 8-digit window left by one and adds one segment byte at the
+//        right, so the cost of a step is the same however long the message is. The
+//        window goes out as pattern frames via CricketLEDPat(), which drops the frame
+//        for a display whose half of the window didn't change.
+//
+//      When not looping, the text scrolls completely off, leaving the displays blank.
+//        When looping, CRICKET_MARQUEE_GAP blanks separate the end of the text from
+//        the start of the next pass.
+//
+//  NOTES
+//
+//      The marquee writes patterns straight to the displays, so don't use it at the
+//        same time as CricketComp or CricketAnim on the same IDs.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CRICKETMARQUEE_H
+#define CRICKETMARQUEE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "CricketLED.h"
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// User configurable options
+//
+#ifndef CRICKET_MARQUEE_MAX
+#define CRICKET_MARQUEE_MAX     32          // Max text length, in digits
+#endif
+
+#ifndef CRICKET_MARQUEE_DISPLAYS
+#define CRICKET_MARQUEE_DISPLAYS 2          // Displays in the strip, IDs 1 and up
+#endif
+
+#ifndef CRICKET_MARQUEE_GAP
+#define CRICKET_MARQUEE_GAP     3           // Blank digits between loops
+#endif
+
+//
+// End of user configurable options
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#define CRICKET_MARQUEE_DIGITS  (4*CRICKET_MARQUEE_DISPLAYS)
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketMarqueeText - Start scrolling text
+//
+// Inputs:      Text (NUL terminated, in RAM), converted to segments before returning
+//              Time per step, in ms
+//              TRUE to loop forever
+//
+// Outputs:     None.
+//
+void CricketMarqueeText(const char *Text,uint16_t StepMS,bool Loop);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketMarqueeSpeed - Change the scroll speed
+//
+// Inputs:      Time per step, in ms
+//
+// Outputs:     None.
+//
+void CricketMarqueeSpeed(uint16_t StepMS);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketMarqueeStop - Stop scrolling (the displays keep what's shown)
+// CricketMarqueeBusy - Return TRUE if text is scrolling
+//
+// Inputs:      None.
+//
+// Outputs:     [CricketMarqueeBusy] TRUE if scrolling, FALSE if stopped or done
+//
+void CricketMarqueeStop(void);
+bool CricketMarqueeBusy(void);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketMarqueeTick - Scroll one tick
+//
+// Call once every CRICKET_TICK_MS, from the main loop.
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void CricketMarqueeTick(void);
+
+#endif  // CRICKETMARQUEE_H - entire file
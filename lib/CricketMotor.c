@@ -0,0 +1,151 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      CricketMotor.c
+//
+//  SYNOPSIS
+//
+//      CricketBusInit();                   // Called once at startup (see CricketBus.h)
+//
+//      CricketMotorSet(0,100);             // Motor 0 forward, speed 100 (of 127)
+//      CricketMotorSet(1,-50);             // Motor 1 reverse, speed 50
+//      CricketMotorStop(1);                // Same as CricketMotorSet(1,0)
+//
+//      CricketMotorService();              // Called often, from the main loop
+//
+//      if( CricketMotorPending() ) ...     // TRUE if any new speed not yet sent
+//
+//  DESCRIPTION
+//
+//      Cricket motor board driver. See CricketMotor.h
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+
+#include "CricketMotor.h"
+#include "PortMacros.h"
+
+#if CRICKET_MOTOR_FRAME > CRICKET_FIFO_RESERVE
+#   error "CricketMotor.c: CRICKET_FIFO_RESERVE too small for a motor frame"
+#endif
+
+//
+// The outbox: newest speed per motor, and which of them still need sending
+//
+static struct {
+    int8_t      Speed[CRICKET_MOTORS];      // Newest speed
+    int8_t      Shown[CRICKET_MOTORS];      // Speed last sent
+    uint8_t     Known;                      // Bit per motor: Shown is valid
+    uint8_t     Dirty;                      // Bit per motor: Speed not yet sent
+    uint8_t     Next;                       // Motor to look at first (round robin)
+    uint16_t    Ticket;                     // CricketBusPosted() after last frame
+    } Motor;
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketMotorSet - Set the speed and direction of one motor
+//
+// Inputs:      Motor number (0-3)
+//              Speed, -127 (full reverse) to 127 (full forward)
+//
+// Outputs:     None.
+//
+void CricketMotorSet(uint8_t Number,int8_t Speed) {
+
+    if( Number >= CRICKET_MOTORS )
+        return;
+
+    if( Speed < -127 )
+        Speed = -127;
+
+    Motor.Speed[Number] = Speed;
+
+    //
+    // Last writer wins: if the motor already has this speed, cancel anything pending.
+    //
+    if( _BIT_ON(Motor.Known,Number) && Motor.Shown[Number] == Speed ) { _CLR_BIT(Motor.Dirty,Number); }
+    else                                                               { _SET_BIT(Motor.Dirty,Number); }
+
+    CricketMotorService();
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketMotorService - Send the next motor speed, if the bus is free
+//
+// Only one motor frame is on the bus at a time, so new speeds coalesce in the outbox
+//   instead of the bus FIFO. Motors take turns, so a busy one can't starve the rest.
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void CricketMotorService(void) {
+    uint8_t Number;
+    uint8_t Count;
+
+    if( Motor.Dirty == 0 || !CricketBusDone(Motor.Ticket) )
+        return;
+
+    if( CricketBusRoom() < CRICKET_MOTOR_FRAME )
+        return;
+
+    for( Count = 0; Count < CRICKET_MOTORS; Count++ ) {
+        Number     = Motor.Next;
+        Motor.Next = (Motor.Next+1) % CRICKET_MOTORS;
+        if( _BIT_ON(Motor.Dirty,Number) )
+            break;
+        }
+
+    CricketBusPut(CRICKET_BUS_MOTOR,true);
+    CricketBusPut(CRICKET_MOTOR_SPEED+Number,false);
+    CricketBusPut((uint8_t) Motor.Speed[Number],false);
+
+    Motor.Ticket        = CricketBusPosted();
+    Motor.Shown[Number] = Motor.Speed[Number];
+    _SET_BIT(Motor.Known,Number);
+    _CLR_BIT(Motor.Dirty,Number);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketMotorPending - Return TRUE if any motor speed is waiting to be sent
+//
+// Inputs:      None.
+//
+// Outputs:     TRUE  if any speed not yet sent
+//              FALSE if all motors are up to date
+//
+bool CricketMotorPending(void) { return( Motor.Dirty != 0 ); }
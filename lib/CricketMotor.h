@@ -0,0 +1,121 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      CricketMotor.h - Cricket motor board driver
+//
+//  SYNOPSIS
+//
+//      CricketBusInit();                   // Called once at startup (see CricketBus.h)
+//
+//      CricketMotorSet(0,100);             // Motor 0 forward, speed 100 (of 127)
+//      CricketMotorSet(1,-50);             // Motor 1 reverse, speed 50
+//      CricketMotorStop(1);                // Same as CricketMotorSet(1,0)
+//
+//      CricketMotorService();              // Called often, from the main loop
+//
+//      if( CricketMotorPending() ) ...     // TRUE if any new speed not yet sent
+//
+//  DESCRIPTION
+//
+//      Cricket motor board driver, with a coalescing outbox.
+//
+//      CricketMotorSet() only records the new speed for the motor. The outbox sends one
+//        frame at a time, and only when the previous motor frame has completely left
+//        the bus. Each frame carries the newest speed of the next motor that needs
+//        one. A control loop can set speeds at 1 KHz (or any rate) without backing
+//        up the bus: speeds that were replaced before their turn are never sent, and
+//        neither is a speed the motor already has.
+//
+//      Motor frames go straight into the bus FIFO, so when the display goes through
+//        CricketSched.c they wait behind at most CRICKET_SCHED_BACKLOG display bytes.
+//
+//  NOTES
+//
+//      Author has only tested the LED display. The command bytes below follow the same
+//        layout as the LED (command + number, then data), but have not been checked
+//        against a real board - verify them against your board's documentation.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CRICKETMOTOR_H
+#define CRICKETMOTOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "CricketBus.h"
+
+#define CRICKET_MOTORS          4           // Motors 0-3
+
+#define CRICKET_MOTOR_SPEED     0x00        // + motor, next byte is speed (signed)
+#define CRICKET_MOTOR_FRAME     3           // Device, command, speed
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketMotorSet  - Set the speed and direction of one motor
+// CricketMotorStop - Stop one motor
+//
+// The speed is sent from CricketMotorService(), when the bus is free.
+//
+// Inputs:      Motor number (0-3)
+//              [CricketMotorSet] Speed, -127 (full reverse) to 127 (full forward)
+//
+// Outputs:     None.
+//
+void CricketMotorSet(uint8_t Motor,int8_t Speed);
+
+#define CricketMotorStop(_Motor_)   CricketMotorSet(_Motor_,0)
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketMotorService - Send the next motor speed, if the bus is free
+//
+// Call often, from the main loop. CricketMotorSet() also calls this.
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void CricketMotorService(void);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketMotorPending - Return TRUE if any motor speed is waiting to be sent
+//
+// Inputs:      None.
+//
+// Outputs:     TRUE  if any speed not yet sent
+//              FALSE if all motors are up to date
+//
+bool CricketMotorPending(void);
+
+#endif  // CRICKETMOTOR_H - entire file
@@ -0,0 +1,278 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      CricketMulti.c
+//
+//  SYNOPSIS
+//
+//      //////////////////////////////////////
+//      //
+//      // In CricketMulti.h
+//      //
+//      #define CRICKET_MULTI_PORT          C       // All buses on PORTC
+//      #define CRICKET_MULTI_MASK          0x0F    // Buses on pins 0-3
+//
+//      //////////////////////////////////////
+//      //
+//      // In main.c
+//      //
+//      CricketMultiInit();                 // Called once at startup
+//
+//      CricketMultiPut(2,0x10,true);       // Queue command byte 0x10 on bus 2 (== PORTC.2)
+//      CricketMultiPutW(2,0x05,false);     // Same, but flush all buses if queue full
+//
+//      CricketMultiSend();                 // Send everything queued, all buses at once
+//
+//      CricketMultiLEDDec(Bus,1025,ID)     // CricketLEDDec(1025,ID) on bus Bus
+//      CricketMultiLEDHex(Bus,0x1025,ID)
+//      CricketMultiLEDBright(Bus,7,ID)
+//      CricketMultiLEDPat(Bus,a,b,c,d,ID)
+//
+//  DESCRIPTION
+//
+//      Bit-sliced transmit on up to 8 cricket buses. See CricketMulti.h
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+
+#include <avr/interrupt.h>
+#include <util/delay.h>
+
+#include "CricketMulti.h"
+#include "PortMacros.h"
+
+#define CRICKET_MULTI_WRAP      (CRICKET_MULTI_FIFO_SIZE-1) // Wraparound mask for FIFO
+#define CRICKET_MULTI_CMD       0x100                       // Command bit, in FIFO entries
+
+//
+// One port value per bit cell: the pre-start is CRICKET_PRESTART_US/CRICKET_BIT_US
+//   cells, then start, 8 data, command and stop.
+//
+#define SLOT_PRESTART       0
+#define SLOT_START          (CRICKET_PRESTART_US/CRICKET_BIT_US)
+#define SLOT_DATA           (SLOT_START+1)
+#define SLOT_CMD            (SLOT_DATA+8)
+#define SLOT_STOP           (SLOT_CMD+1)
+#define SLOT_COUNT          (SLOT_STOP+1)
+
+//
+// Transmit loop timing. Each pass of the loop is one cell: load and write the port
+//   value (3 cycles), wait, then count and branch (3 cycles).
+//
+#define MULTI_WAIT_CYCLES   (CRICKET_BIT_CYCLES-6)
+#define MULTI_WAIT_LOOPS    (MULTI_WAIT_CYCLES/3)           // 3 cycles per loop
+#define MULTI_WAIT_NOPS     (MULTI_WAIT_CYCLES%3)
+
+#if MULTI_WAIT_LOOPS < 1 || MULTI_WAIT_LOOPS > 255
+#   error "CricketMulti.c: F_CPU out of range for multi-bus driver"
+#endif
+
+static struct {
+    uint16_t    FIFO[CRICKET_MULTI_BUSES][CRICKET_MULTI_FIFO_SIZE];
+
+    uint8_t     FIFO_In [CRICKET_MULTI_BUSES];      // FIFO input  pointers
+    uint8_t     FIFO_Out[CRICKET_MULTI_BUSES];      // FIFO output pointers
+    } Multi NOINIT;
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketMultiInit - Initialize multi-bus interface
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void CricketMultiInit(void) {
+
+    memset(&Multi,0,sizeof(Multi));
+
+    _SET_MASK(_DDR (CRICKET_MULTI_PORT),CRICKET_MULTI_MASK);   // Bus lines are outputs
+    _SET_MASK(_PORT(CRICKET_MULTI_PORT),CRICKET_MULTI_MASK);   // Idle high
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketMultiPut - Queue one byte and command bit for one bus
+//
+// Inputs:      Bus number (== pin number on CRICKET_MULTI_PORT)
+//              Byte to send
+//              TRUE if this is a command byte
+//
+// Outputs:     TRUE  if byte was queued OK,
+//              FALSE if bus FIFO full (or bus not in CRICKET_MULTI_MASK)
+//
+bool CricketMultiPut(uint8_t Bus,uint8_t Byte,bool Command) {
+    uint8_t NewIn;
+
+    if( Bus >= CRICKET_MULTI_BUSES || _BIT_OFF(CRICKET_MULTI_MASK,Bus) )
+        return(false);
+
+    NewIn = (Multi.FIFO_In[Bus]+1) & CRICKET_MULTI_WRAP;
+
+    if( NewIn == Multi.FIFO_Out[Bus] )
+        return(false);
+
+    Multi.FIFO[Bus][Multi.FIFO_In[Bus]] = Byte | (Command ? CRICKET_MULTI_CMD : 0);
+    Multi.FIFO_In[Bus]                  = NewIn;
+
+    return(true);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketMultiQueued - Return number of bytes queued for one bus
+//
+// Inputs:      Bus number
+//
+// Outputs:     Number of bytes waiting for CricketMultiSend()
+//
+uint8_t CricketMultiQueued(uint8_t Bus) {
+
+    if( Bus >= CRICKET_MULTI_BUSES )
+        return(0);
+
+    return( (Multi.FIFO_In[Bus] - Multi.FIFO_Out[Bus]) & CRICKET_MULTI_WRAP );
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketMultiSend - Send everything queued, on all buses in parallel
+//
+// Each pass takes the next byte from every bus that has one and transposes them into
+//   one port value per bit cell, so bit N of Slots[SLOT_DATA+k] is bit k of the byte
+//   for bus N. Buses with nothing to send stay high for the whole pass.
+//
+// The transposing is done with interrupts on; only the transmit loop itself runs with
+//   interrupts off.
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void CricketMultiSend(void) {
+    uint8_t Slots[SLOT_COUNT];
+
+    while(1) {
+        uint8_t Active = 0;
+        uint8_t Idle;
+        uint8_t Base;
+        uint8_t Bus;
+        uint8_t Pin;
+        uint8_t Slot;
+
+        memset(Slots,0,sizeof(Slots));
+
+        for( Bus = 0, Pin = 0x01; Bus < CRICKET_MULTI_BUSES; Bus++, Pin <<= 1 ) {
+            uint16_t Entry;
+            uint8_t  Data;
+
+            if( !(CRICKET_MULTI_MASK & Pin) || Multi.FIFO_In[Bus] == Multi.FIFO_Out[Bus] )
+                continue;
+
+            Entry = Multi.FIFO[Bus][Multi.FIFO_Out[Bus]];
+            Multi.FIFO_Out[Bus] = (Multi.FIFO_Out[Bus]+1) & CRICKET_MULTI_WRAP;
+            Active |= Pin;
+
+            for( Data = Entry, Slot = SLOT_DATA; Slot < SLOT_CMD; Slot++, Data >>= 1 ) {
+                if( Data & 0x01 )
+                    Slots[Slot] |= Pin;
+                }
+
+            if( !(Entry & CRICKET_MULTI_CMD) )
+                Slots[SLOT_CMD] |= Pin;                 // Command bit is low for command
+            }
+
+        if( Active == 0 )
+            break;
+
+        //
+        // Idle buses stay high throughout, start and stop bits are high for everyone.
+        //
+        Idle = CRICKET_MULTI_MASK & ~Active;
+        for( Slot = 0; Slot < SLOT_COUNT; Slot++ )
+            Slots[Slot] |= Idle;
+        Slots[SLOT_START] = CRICKET_MULTI_MASK;
+        Slots[SLOT_STOP]  = CRICKET_MULTI_MASK;
+
+        cli();                                          // Disable interrupts
+
+        //
+        // Merge in the other (non-bus) pins of the port, now that nothing else can
+        //   change them, then send. Each pass of the loop is exactly one bit cell.
+        //
+        Base = _PORT(CRICKET_MULTI_PORT) & ~CRICKET_MULTI_MASK;
+        for( Slot = 0; Slot < SLOT_COUNT; Slot++ )
+            Slots[Slot] |= Base;
+
+#if defined(__AVR__)
+        {
+        uint8_t *Next = Slots;
+        uint8_t  Left = SLOT_COUNT;
+        uint8_t  Temp;
+        uint8_t  Count;
+
+        __asm__ __volatile__ (
+            "1: ld  %[Temp],%a[Next]+"  "\n\t"
+            "out    %[Port],%[Temp]"    "\n\t"
+            "ldi    %[Count],%[Loops]"  "\n\t"
+            "2: dec %[Count]"           "\n\t"
+            "brne   2b"                 "\n\t"
+            ".rept  %[Nops]"            "\n\t"
+            "nop"                       "\n\t"
+            ".endr"                     "\n\t"
+            "dec    %[Left]"            "\n\t"
+            "brne   1b"                 "\n\t"
+            : [Temp]  "=&r" (Temp),
+              [Count] "=&d" (Count),
+              [Next]  "+e"  (Next),
+              [Left]  "+r"  (Left)
+            : [Port]  "I"   (_SFR_IO_ADDR(_PORT(CRICKET_MULTI_PORT))),
+              [Loops] "n"   (MULTI_WAIT_LOOPS),
+              [Nops]  "n"   (MULTI_WAIT_NOPS)
+            : "memory"
+            );
+        }
+#else
+        for( Slot = 0; Slot < SLOT_COUNT; Slot++ ) {
+            _PORT(CRICKET_MULTI_PORT) = Slots[Slot];
+            _delay_us(CRICKET_BIT_US);
+            }
+#endif
+
+        sei();                                          // Enable interrupts
+        }
+    }
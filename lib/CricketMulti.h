@@ -0,0 +1,221 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      CricketMulti.h - Bit-sliced transmit on several cricket buses
+//
+//  SYNOPSIS
+//
+//      //////////////////////////////////////
+//      //
+//      // In CricketMulti.h
+//      //
+//      #define CRICKET_MULTI_PORT          C       // All buses on PORTC
+//      #define CRICKET_MULTI_MASK          0x0F    // Buses on pins 0-3
+//
+//      //////////////////////////////////////
+//      //
+//      // In main.c
+//      //
+//      CricketMultiInit();                 // Called once at startup
+//
+//      CricketMultiPut(2,0x10,true);       // Queue command byte 0x10 on bus 2 (== PORTC.2)
+//      CricketMultiPutW(2,0x05,false);     // Same, but flush all buses if queue full
+//
+//      CricketMultiSend();                 // Send everything queued, all buses at once
+//
+//      CricketMultiLEDDec(Bus,1025,ID)     // CricketLEDDec(1025,ID) on bus Bus
+//      CricketMultiLEDHex(Bus,0x1025,ID)
+//      CricketMultiLEDBright(Bus,7,ID)
+//      CricketMultiLEDPat(Bus,a,b,c,d,ID)
+//
+//  DESCRIPTION
+//
+//      Drive up to 8 independent cricket buses from the pins of one port.
+//
+//      Bytes are queued per bus. CricketMultiSend() takes the next byte from every bus
+//        that has one, transposes them into one port value per bit cell, and bit-bangs
+//        all of them with a single port write per cell. Eight buses then cost the same
+//        time with interrupts disabled as one does on CricketBus.c.
+//
+//      The bus numbers are the pin numbers on CRICKET_MULTI_PORT; only pins set in
+//        CRICKET_MULTI_MASK are touched.
+//
+//  NOTES
+//
+//      CRICKET_MULTI_PORT must be in the I/O space (ports A-G), since the transmit
+//        loop uses OUT to get cycle exact timing.
+//
+//      Bytes are not sent until CricketMultiSend() (or CricketMultiPutW with a full
+//        queue) is called.
+//
+//      CricketMultiSend() runs with interrupts off for a byte time at a time, which
+//        stretches the bits of any byte the interrupt driven main bus (CricketBus.c)
+//        is sending. Don't call it, or CricketMultiPutW, while CricketBusBusy().
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CRICKETMULTI_H
+#define CRICKETMULTI_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "CricketBus.h"
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Specify the multi-bus connection to the system
+//
+#define CRICKET_MULTI_PORT      C
+#define CRICKET_MULTI_MASK      0x0F        // One bus per pin set
+
+//
+// The per-bus FIFO must be a power of two long, since the code uses a mask for
+//   wraparound.
+//
+#ifndef CRICKET_MULTI_FIFO_SIZE
+#define CRICKET_MULTI_FIFO_SIZE (1 << 3)    // == 8 bytes per bus (one LED pattern frame)
+#endif
+
+//
+// End of user configurable options
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#define CRICKET_MULTI_BUSES     8           // Max buses (pins per port)
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketMultiInit - Initialize multi-bus interface
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void CricketMultiInit(void);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketMultiPut - Queue one byte and command bit for one bus
+//
+// Inputs:      Bus number (== pin number on CRICKET_MULTI_PORT)
+//              Byte to send
+//              TRUE if this is a command byte
+//
+// Outputs:     TRUE  if byte was queued OK,
+//              FALSE if bus FIFO full (or bus not in CRICKET_MULTI_MASK)
+//
+bool CricketMultiPut(uint8_t Bus,uint8_t Byte,bool Command);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketMultiPutW - Queue one byte, sending queued data on all buses to make room
+//
+// Inputs:      Bus number (must be in CRICKET_MULTI_MASK)
+//              Byte to send
+//              TRUE if this is a command byte
+//
+// Outputs:     None.
+//
+#define CricketMultiPutW(_Bus_,_Byte_,_Command_) {                                      \
+    uint8_t _MultiPutW_ = (_Byte_);             /* Evaluate once, not per try */        \
+    while(!CricketMultiPut(_Bus_,_MultiPutW_,_Command_))                                \
+        CricketMultiSend();                                                             \
+    }
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketMultiSend - Send everything queued, on all buses in parallel
+//
+// Blocks until all bus FIFOs are empty. Interrupts are disabled for one byte time
+//   (CRICKET_BYTE_US) at a time, during which one byte goes out on every bus that
+//   has data.
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void CricketMultiSend(void);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketMultiQueued - Return number of bytes queued for one bus
+//
+// Inputs:      Bus number
+//
+// Outputs:     Number of bytes waiting for CricketMultiSend()
+//
+uint8_t CricketMultiQueued(uint8_t Bus);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketMultiLEDxxx - Cricket LED calls for one bus of the set
+//
+// As CricketLEDDec, CricketLEDHex, CricketLEDBright and CricketLEDPat in CricketLED.h,
+//   with the bus number first. The frame is queued, use CricketMultiSend() to send.
+//
+#define CricketMultiLEDDec(_Bus_,_Number_,_ID_) {                                       \
+    CricketMultiPutW(_Bus_,CRICKET_BUS_LED          ,true);                             \
+    CricketMultiPutW(_Bus_,CRICKET_LED_NUMBER+(_ID_),false);                            \
+    CricketMultiPutW(_Bus_,((_Number_) >> 8) & 0xFF ,false);                            \
+    CricketMultiPutW(_Bus_,((_Number_) >> 0) & 0xFF ,false);                            \
+    }
+
+#define CricketMultiLEDHex(_Bus_,_Number_,_ID_) {                                       \
+    CricketMultiPutW(_Bus_,CRICKET_BUS_LED          ,true);                             \
+    CricketMultiPutW(_Bus_,CRICKET_LED_HEX+(_ID_)   ,false);                            \
+    CricketMultiPutW(_Bus_,((_Number_) >> 8) & 0xFF ,false);                            \
+    CricketMultiPutW(_Bus_,((_Number_) >> 0) & 0xFF ,false);                            \
+    }
+
+#define CricketMultiLEDBright(_Bus_,_Level_,_ID_) {                                     \
+    CricketMultiPutW(_Bus_,CRICKET_BUS_LED          ,true);                             \
+    CricketMultiPutW(_Bus_,CRICKET_LED_BRIGHT+(_ID_),false);                            \
+    CricketMultiPutW(_Bus_,                        0,false);                            \
+    CricketMultiPutW(_Bus_,         (_Level_) & 0x07,false);                            \
+    }
+
+#define CricketMultiLEDPat(_Bus_,_Dig1_,_Dig2_,_Dig3_,_Dig4_,_ID_) {                    \
+    CricketMultiPutW(_Bus_,CRICKET_BUS_LED       ,true);                                \
+    CricketMultiPutW(_Bus_,CRICKET_LED_PAT+(_ID_),false);                               \
+    CricketMultiPutW(_Bus_,_Dig1_,false);                                               \
+    CricketMultiPutW(_Bus_,_Dig2_,false);                                               \
+    CricketMultiPutW(_Bus_,_Dig3_,false);                                               \
+    CricketMultiPutW(_Bus_,_Dig4_,false);                                               \
+    }
+
+#endif  // CRICKETMULTI_H - entire file
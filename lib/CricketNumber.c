@@ -0,0 +1,198 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      CricketNumber.c
+//
+//  SYNOPSIS
+//
+//      CricketNumber(-42,0,0,1,1);                 // "  -42" on display 1
+//      CricketNumber(31416,4,0,1,1);               // "3.1416" doesn't fit: "----"
+//      CricketNumber(-1234567,3,0,1,2);            // "-1234.567" across displays 1 and 2
+//      CricketNumber(5,2,CRICKET_NUM_ZEROS,0,1);   // "00.05" - all displays
+//
+//      uint8_t Segs[8];
+//      bool Fits = CricketNumberSegs(Value,Decimals,Flags,Segs,8);  // Just make the patterns
+//
+//  DESCRIPTION
+//
+//      Signed, 32-bit and fixed point numbers on the LED displays. See CricketNumber.h
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+
+#include "CricketNumber.h"
+#include "PortMacros.h"
+
+#define NUM_BCD_BYTES   5                   // 10 BCD digits, enough for 2^32-1
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// ToBCD - Convert binary to packed BCD by double dabble
+//
+// Each pass shifts the binary value into the BCD digits one bit at a time, first
+//   adding 3 to any digit of 5 or more so that it carries into the next digit.
+//
+// Inputs:      Binary value
+//              Where to put the BCD digits, two per byte, least significant first
+//
+// Outputs:     Number of significant digits (0 if Bin is 0)
+//
+static uint8_t ToBCD(uint32_t Bin,uint8_t *BCD) {
+    uint8_t Bits = 32;
+    uint8_t Index;
+
+    memset(BCD,0,NUM_BCD_BYTES);
+
+    if( Bin == 0 )
+        return(0);
+
+    while( !(Bin & 0x80000000UL) ) {                    // Skip leading zeros
+        Bin <<= 1;
+        Bits--;
+        }
+
+    while( Bits-- ) {
+        uint8_t Carry = (Bin & 0x80000000UL) ? 1 : 0;
+
+        Bin <<= 1;
+
+        for( Index = 0; Index < NUM_BCD_BYTES; Index++ ) {
+            uint8_t Byte = BCD[Index];
+            uint8_t Next;
+
+            if( (Byte & 0x0F) >= 0x05 ) Byte += 0x03;
+            if( (Byte & 0xF0) >= 0x50 ) Byte += 0x30;
+
+            Next       = Byte >> 7;
+            BCD[Index] = (Byte << 1) | Carry;
+            Carry      = Next;
+            }
+        }
+
+    for( Index = 2*NUM_BCD_BYTES; Index > 0; Index-- ) {
+        if( (BCD[(Index-1)/2] >> (((Index-1) & 1)*4)) & 0x0F )
+            break;
+        }
+
+    return(Index);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketNumberSegs - Convert a number to segment patterns
+//
+// Inputs:      Value (signed)
+//              Number of digits after the decimal point
+//              Flags (CRICKET_NUM_xxx)
+//              Where to put the patterns, leftmost digit first
+//              Number of digits
+//
+// Outputs:     TRUE  if the number fit
+//              FALSE if it didn't (the patterns are all dashes)
+//
+bool CricketNumberSegs(int32_t Value,uint8_t Decimals,uint8_t Flags,uint8_t *Segs,uint8_t Digits) {
+    uint8_t BCD[NUM_BCD_BYTES];
+    uint8_t Sign = Value < 0 ? 1 : 0;                   // Digits used by the sign
+    uint8_t Shown;
+    uint8_t Pos;
+    uint8_t Digit;
+
+    Shown = ToBCD(Sign ? -(uint32_t) Value : (uint32_t) Value,BCD);
+
+    if( Decimals < Digits && Shown < Decimals+1 )       // At least "0." before decimals
+        Shown = Decimals+1;
+
+    if( (Flags & CRICKET_NUM_ZEROS) && Shown + Sign < Digits )
+        Shown = Digits - Sign;
+
+    if( Decimals >= Digits || Shown + Sign > Digits ) {
+        memset(Segs,CRICKET_SEG('-'),Digits);
+        return(false);
+        }
+
+    memset(Segs,0,Digits);
+
+    Pos = Digits;
+    for( Digit = 0; Digit < Shown; Digit++ ) {
+        uint8_t Number = 0;                             // Zeros past the BCD digits
+
+        if( Digit < 2*NUM_BCD_BYTES )
+            Number = (BCD[Digit/2] >> ((Digit & 1)*4)) & 0x0F;
+
+        Segs[--Pos] = CricketFontChar('0'+Number);
+        if( Decimals && Digit == Decimals )
+            Segs[Pos] |= CRICKET_SEG_DP;
+        }
+
+    if( Sign )
+        Segs[Pos-1] = CRICKET_SEG('-');
+
+    return(true);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketNumber - Show a number on one or more displays
+//
+// Inputs:      Value (signed)
+//              Number of digits after the decimal point
+//              Flags (CRICKET_NUM_xxx)
+//              First device ID (0, 1 or 2)
+//              Number of displays, left to right from the first ID
+//
+// Outputs:     TRUE  if the number fit
+//              FALSE if it didn't (dashes are shown)
+//
+bool CricketNumber(int32_t Value,uint8_t Decimals,uint8_t Flags,uint8_t ID,uint8_t Displays) {
+    uint8_t Segs[CRICKET_NUM_DIGITS];
+    uint8_t Index;
+    bool    Fits;
+
+    //
+    // ID 0 is all displays, so it only makes sense on its own
+    //
+    if( Displays == 0 || ID + Displays > CRICKET_LED_IDS || (ID == 0 && Displays > 1) )
+        return(false);
+
+    Fits = CricketNumberSegs(Value,Decimals,Flags,Segs,4*Displays);
+
+    for( Index = 0; Index < Displays; Index++ ) {
+        uint8_t *Digits = &Segs[4*Index];
+
+        CricketLEDPat(Digits[0],Digits[1],Digits[2],Digits[3],ID+Index);
+        }
+
+    return(Fits);
+    }
@@ -0,0 +1,110 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      CricketNumber.h - Signed, 32-bit and fixed point numbers on the LED displays
+//
+//  SYNOPSIS
+//
+//      CricketNumber(-42,0,0,1,1);                 // "  -42" on display 1
+//      CricketNumber(31416,4,0,1,1);               // "3.1416" doesn't fit: "----"
+//      CricketNumber(-1234567,3,0,1,2);            // "-1234.567" across displays 1 and 2
+//      CricketNumber(5,2,CRICKET_NUM_ZEROS,0,1);   // "00.05" - all displays
+//
+//      uint8_t Segs[8];
+//      bool Fits = CricketNumberSegs(Value,Decimals,Flags,Segs,8);  // Just make the patterns
+//
+//  DESCRIPTION
+//
+//      Number rendering for the LED displays.
+//
+//      The display's own number commands take an unsigned 16-bit value, on one display.
+//        These calls format signed 32-bit and fixed-point values on the MCU instead,
+//        and send the result as pattern frames, spread over one or more displays.
+//
+//      The value is an integer, with Decimals of its digits shown after the decimal
+//        point: CricketNumber(314,2,...) shows "3.14". At least one digit is shown
+//        before the point. A minus sign goes just left of the first digit, or in the
+//        leftmost digit with CRICKET_NUM_ZEROS (leading zeros).
+//
+//      The value is converted to BCD by double dabble (shift and add-3), which needs
+//        no divide - the AVR has none, and a 32-bit software divide per digit costs
+//        far more.
+//
+//      Values that don't fit show as all dashes.
+//
+//      With several displays, the digits run left to right from the first ID, so
+//        ID 1 and 2 displays make one 8-digit number.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CRICKETNUMBER_H
+#define CRICKETNUMBER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "CricketLED.h"
+
+#define CRICKET_NUM_ZEROS       0x01        // Flags: show leading zeros
+
+#define CRICKET_NUM_DIGITS      (4*(CRICKET_LED_IDS-1))     // Most digits shown
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketNumber - Show a number on one or more displays
+//
+// Inputs:      Value (signed)
+//              Number of digits after the decimal point
+//              Flags (CRICKET_NUM_xxx)
+//              First device ID (0, 1 or 2)
+//              Number of displays, left to right from the first ID
+//
+// Outputs:     TRUE  if the number fit
+//              FALSE if it didn't (dashes are shown)
+//
+bool CricketNumber(int32_t Value,uint8_t Decimals,uint8_t Flags,uint8_t ID,uint8_t Displays);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketNumberSegs - Convert a number to segment patterns
+//
+// Inputs:      Value (signed)
+//              Number of digits after the decimal point
+//              Flags (CRICKET_NUM_xxx)
+//              Where to put the patterns, leftmost digit first
+//              Number of digits
+//
+// Outputs:     TRUE  if the number fit
+//              FALSE if it didn't (the patterns are all dashes)
+//
+bool CricketNumberSegs(int32_t Value,uint8_t Decimals,uint8_t Flags,uint8_t *Segs,uint8_t Digits);
+
+#endif  // CRICKETNUMBER_H - entire file
@@ -0,0 +1,268 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      CricketRamp.c
+//
+//  SYNOPSIS
+//
+//      CricketRampProfile(0,200,0);        // Motor 0: trapezoid, 200 speed units/sec
+//      CricketRampProfile(1,200,800);      // Motor 1: S-curve, also 800 units/sec/sec jerk
+//
+//      CricketRampTo(0,127);               // Ramp motor 0 up to full forward
+//      CricketRampStop(1);                 // Ramp motor 1 down to stopped
+//
+//      CricketRampTick();                  // Called every CRICKET_TICK_MS
+//      CricketMotorService();              // Called often, from the main loop
+//
+//      if( CricketRampDone(0) ) ...        // TRUE when motor 0 is at its target
+//      int8_t Speed = CricketRampSpeed(0); // Speed commanded right now
+//
+//  DESCRIPTION
+//
+//      Motor speed ramps. See CricketRamp.h
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#include "CricketRamp.h"
+
+#define RAMP_ONE        256L                // Fixed point 1.0 (speed units)
+
+//
+// The per-tick conversions in CricketRampProfile stay within 32 bits up to here
+//
+#if CRICKET_TICK_MS > 255
+#   error "CricketRamp.c: CRICKET_TICK_MS too long (255 mS max)"
+#endif
+
+//
+// Speed of a fixed point value, rounded
+//
+#define RAMP_WHOLE(_x_) ((int8_t) (((_x_) + RAMP_ONE/2) >> 8))
+
+typedef struct {
+    int16_t     Speed;                      // Current speed, 1/256ths
+    int16_t     Target;                     // Target speed,  1/256ths
+    int16_t     Accel;                      // Current acceleration, 1/256ths per tick
+    uint16_t    AccelMax;                   // Max |Accel|
+    uint16_t    Jerk;                       // Max change of Accel per tick, 0 == none
+    int8_t      Sent;                       // Speed last given to CricketMotorSet
+    } RAMP;
+
+static RAMP Ramp[CRICKET_MOTORS];
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketRampProfile - Set the ramp profile of one motor
+//
+// Converts the units to per-tick fixed point. The only divisions are here.
+//
+// Inputs:      Motor number (0-3)
+//              Max acceleration, speed units per second (0 == no ramp, jump to target)
+//              Max jerk, speed units per second per second (0 == trapezoid ramp)
+//
+// Outputs:     None.
+//
+void CricketRampProfile(uint8_t Motor,uint16_t Accel,uint16_t Jerk) {
+    uint32_t PerTick;
+
+    if( Motor >= CRICKET_MOTORS )
+        return;
+
+    PerTick = ((uint32_t) Accel*RAMP_ONE*CRICKET_TICK_MS)/1000UL;
+    if( Accel == 0 || PerTick > 0x7FFF )
+        PerTick = 0x7FFF;                               // One tick to anywhere
+    if( PerTick == 0 )
+        PerTick = 1;
+    Ramp[Motor].AccelMax = PerTick;
+
+    //
+    // Per tick per tick, one tick at a time: all at once, a large jerk overflows 32
+    //   bits with a tick of 12 mS or more.
+    //
+    PerTick = ((uint32_t) Jerk*RAMP_ONE*CRICKET_TICK_MS)/1000UL;
+    PerTick = (PerTick*CRICKET_TICK_MS)/1000UL;
+    if( Jerk != 0 && PerTick == 0 )
+        PerTick = 1;
+    if( PerTick > 0x7FFF )
+        PerTick = 0x7FFF;
+    Ramp[Motor].Jerk = PerTick;
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketRampTo - Start ramping one motor to a new speed
+//
+// Inputs:      Motor number (0-3)
+//              Target speed, -127 to 127
+//
+// Outputs:     None.
+//
+void CricketRampTo(uint8_t Motor,int8_t Target) {
+
+    if( Motor >= CRICKET_MOTORS )
+        return;
+
+    if( Target < -127 )
+        Target = -127;
+
+    if( Ramp[Motor].AccelMax == 0 )                     // No profile yet: no ramp
+        Ramp[Motor].AccelMax = 0x7FFF;
+
+    Ramp[Motor].Target = Target*RAMP_ONE;
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// RampStep - Move one motor one tick along its ramp
+//
+// Trapezoid: step straight toward the target at the max acceleration.
+//
+// S-curve: the acceleration moves by at most the jerk each tick. Easing the
+//   acceleration A back to zero at J per tick changes the speed by about A*(A+J)/2J
+//   more, so once 2*J*(distance to go) <= A*(A+J) it's time to ease off.
+//
+// Inputs:      Ramp to step
+//
+// Outputs:     None.
+//
+static void RampStep(RAMP *R) {
+    int32_t  Error = (int32_t) R->Target - R->Speed;
+    int16_t  Accel = R->Accel;
+    bool     Down  = false;
+    uint16_t Mag;
+
+    if( Error == 0 && Accel == 0 )
+        return;
+
+    if( R->Jerk == 0 ) {
+        if     ( Error >  (int32_t) R->AccelMax ) Error =  R->AccelMax;
+        else if( Error < -(int32_t) R->AccelMax ) Error = -R->AccelMax;
+        R->Speed += Error;
+        R->Accel  = 0;
+        return;
+        }
+
+    //
+    // Work with the target in the positive direction, so one set of rules covers both.
+    //
+    if( Error < 0 ) {
+        Error = -Error;
+        Accel = -Accel;
+        Down  = true;
+        }
+
+    if( Accel <= 0 ) {                                  // Stopped, or heading away
+        Accel += R->Jerk;
+        if( Accel > (int16_t) R->AccelMax )             // Jerk can be more than that
+            Accel = R->AccelMax;
+        }
+    else {
+        Mag = Accel;
+        if( 2UL*R->Jerk*(uint32_t) Error <= (uint32_t) Mag*(Mag+R->Jerk) )
+            Accel = (Mag > R->Jerk) ? Accel - R->Jerk : 0;
+        else if( (uint32_t) Mag+R->Jerk <= R->AccelMax )
+            Accel += R->Jerk;
+        else
+            Accel = R->AccelMax;
+        }
+
+    //
+    // Arriving (or easing off with nothing left to go): land on the target.
+    //
+    if( Accel >= Error || (Accel == 0 && Error <= R->Jerk) ) {
+        R->Speed = R->Target;
+        R->Accel = 0;
+        return;
+        }
+
+    if( Down )
+        Accel = -Accel;
+
+    R->Accel  = Accel;
+    R->Speed += Accel;
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketRampTick - Advance every motor's ramp by one tick
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void CricketRampTick(void) {
+    uint8_t Motor;
+
+    for( Motor = 0; Motor < CRICKET_MOTORS; Motor++ ) {
+        RAMP  *R = &Ramp[Motor];
+        int8_t Speed;
+
+        RampStep(R);
+
+        Speed = RAMP_WHOLE(R->Speed);
+        if( Speed != R->Sent ) {
+            R->Sent = Speed;
+            CricketMotorSet(Motor,Speed);
+            }
+        }
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketRampDone  - Return TRUE if a motor has reached its target speed
+// CricketRampSpeed - Return the speed a motor is commanded to right now
+//
+// Inputs:      Motor number (0-3)
+//
+// Outputs:     As above
+//
+bool CricketRampDone(uint8_t Motor) {
+
+    if( Motor >= CRICKET_MOTORS )
+        return(true);
+
+    return( Ramp[Motor].Speed == Ramp[Motor].Target && Ramp[Motor].Accel == 0 );
+    }
+
+int8_t CricketRampSpeed(uint8_t Motor) {
+
+    if( Motor >= CRICKET_MOTORS )
+        return(0);
+
+    return(Ramp[Motor].Sent);
+    }
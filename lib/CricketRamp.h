@@ -0,0 +1,127 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      CricketRamp.h - Motor speed ramps
+//
+//  SYNOPSIS
+//
+//      CricketRampProfile(0,200,0);        // Motor 0: trapezoid, 200 speed units/sec
+//      CricketRampProfile(1,200,800);      // Motor 1: S-curve, also 800 units/sec/sec jerk
+//
+//      CricketRampTo(0,127);               // Ramp motor 0 up to full forward
+//      CricketRampStop(1);                 // Ramp motor 1 down to stopped
+//
+//      CricketRampTick();                  // Called every CRICKET_TICK_MS
+//      CricketMotorService();              // Called often, from the main loop
+//
+//      if( CricketRampDone(0) ) ...        // TRUE when motor 0 is at its target
+//      int8_t Speed = CricketRampSpeed(0); // Speed commanded right now
+//
+//  DESCRIPTION
+//
+//      Motor speed ramps, for smooth starts and stops on the cricket motor board.
+//
+//      Each motor has a profile: a maximum acceleration and, for an S-curve, a jerk
+//        limit (how fast the acceleration itself may change). With no jerk limit the
+//        speed changes at a constant rate, which gives a trapezoid speed vs. time.
+//
+//      CricketRampTick() moves every ramping motor one tick along. All the math is
+//        8.8 fixed point in 16 bits (speed in 1/256ths), with no division per tick -
+//        the units are converted once, in CricketRampProfile(). The S-curve decides
+//        when to start easing off by comparing multiplies, not by dividing.
+//
+//      Each tick costs the same for every motor, so any number of motors can ramp at
+//        once. A new speed goes to CricketMotorSet() only when the whole-number speed
+//        changes, and from there through the motor outbox (see CricketMotor.h).
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CRICKETRAMP_H
+#define CRICKETRAMP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "CricketMotor.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketRampProfile - Set the ramp profile of one motor
+//
+// Inputs:      Motor number (0-3)
+//              Max acceleration, speed units per second (0 == no ramp, jump to target)
+//              Max jerk, speed units per second per second (0 == trapezoid ramp)
+//
+// Outputs:     None.
+//
+void CricketRampProfile(uint8_t Motor,uint16_t Accel,uint16_t Jerk);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketRampTo   - Start ramping one motor to a new speed
+// CricketRampStop - Start ramping one motor down to stopped
+//
+// Inputs:      Motor number (0-3)
+//              [CricketRampTo] Target speed, -127 to 127
+//
+// Outputs:     None.
+//
+void CricketRampTo(uint8_t Motor,int8_t Target);
+
+#define CricketRampStop(_Motor_)    CricketRampTo(_Motor_,0)
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketRampTick - Advance every motor's ramp by one tick
+//
+// Call once every CRICKET_TICK_MS, from the main loop.
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void CricketRampTick(void);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketRampDone  - Return TRUE if a motor has reached its target speed
+// CricketRampSpeed - Return the speed a motor is commanded to right now
+//
+// Inputs:      Motor number (0-3)
+//
+// Outputs:     As above
+//
+bool   CricketRampDone (uint8_t Motor);
+int8_t CricketRampSpeed(uint8_t Motor);
+
+#endif  // CRICKETRAMP_H - entire file
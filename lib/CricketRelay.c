@@ -0,0 +1,144 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      CricketRelay.c
+//
+//  SYNOPSIS
+//
+//      CricketBusInit();                   // Called once at startup (see CricketBus.h)
+//
+//      CricketRelaySet(0x05);              // Relays 0 and 2 on, the rest off
+//      CricketRelayOn(1);                  // Relay 1 on, the rest unchanged
+//      CricketRelayOff(0);                 // Relay 0 off, the rest unchanged
+//
+//      CricketRelayService();              // Called often, from the main loop
+//
+//      if( CricketRelayPending() ) ...     // TRUE if new relay state not yet sent
+//
+//  DESCRIPTION
+//
+//      Cricket lamp/relay board driver. See CricketRelay.h
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+
+#include "CricketRelay.h"
+#include "PortMacros.h"
+
+#if CRICKET_RELAY_FRAME > CRICKET_FIFO_RESERVE
+#   error "CricketRelay.c: CRICKET_FIFO_RESERVE too small for a relay frame"
+#endif
+
+//
+// The outbox: newest relay mask, and what the board was last sent
+//
+static struct {
+    uint8_t     Mask;                       // Newest mask
+    uint8_t     Shown;                      // Mask last sent
+    bool        Known;                      // Shown is valid
+    bool        Dirty;                      // Mask not yet sent
+    uint16_t    Ticket;                     // CricketBusPosted() after last frame
+    } Relay;
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketRelaySet - Set all relays at once
+// CricketRelayOn  - Turn one relay on
+// CricketRelayOff - Turn one relay off
+//
+// Inputs:      [CricketRelaySet]            Relay mask, bit per relay (1 == on)
+//              [CricketRelayOn, _Off]       Relay number (0-7)
+//
+// Outputs:     None.
+//
+void CricketRelaySet(uint8_t Mask) {
+
+    Relay.Mask  = Mask;
+    Relay.Dirty = !Relay.Known || Relay.Shown != Mask;    // Last writer wins
+
+    CricketRelayService();
+    }
+
+void CricketRelayOn(uint8_t Number) {
+
+    if( Number < CRICKET_RELAYS )
+        CricketRelaySet(Relay.Mask | _PIN_MASK(Number));
+    }
+
+void CricketRelayOff(uint8_t Number) {
+
+    if( Number < CRICKET_RELAYS )
+        CricketRelaySet(Relay.Mask & ~_PIN_MASK(Number));
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketRelayService - Send the relay mask, if changed and the bus is free
+//
+// Only one relay frame is on the bus at a time, so changes coalesce in the outbox
+//   instead of the bus FIFO.
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void CricketRelayService(void) {
+
+    if( !CricketRelayPending() || !CricketBusDone(Relay.Ticket) )
+        return;
+
+    if( CricketBusRoom() < CRICKET_RELAY_FRAME )
+        return;
+
+    CricketBusPut(CRICKET_BUS_RELAY,true);
+    CricketBusPut(CRICKET_RELAY_SET,false);
+    CricketBusPut(Relay.Mask,false);
+
+    Relay.Ticket = CricketBusPosted();
+    Relay.Shown  = Relay.Mask;
+    Relay.Known  = true;
+    Relay.Dirty  = false;
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketRelayPending - Return TRUE if a new relay mask is waiting to be sent
+//
+// Inputs:      None.
+//
+// Outputs:     TRUE  if the board doesn't have the newest mask yet
+//              FALSE if up to date
+//
+bool CricketRelayPending(void) { return( Relay.Dirty ); }
@@ -0,0 +1,118 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      CricketRelay.h - Cricket lamp/relay board driver
+//
+//  SYNOPSIS
+//
+//      CricketBusInit();                   // Called once at startup (see CricketBus.h)
+//
+//      CricketRelaySet(0x05);              // Relays 0 and 2 on, the rest off
+//      CricketRelayOn(1);                  // Relay 1 on, the rest unchanged
+//      CricketRelayOff(0);                 // Relay 0 off, the rest unchanged
+//
+//      CricketRelayService();              // Called often, from the main loop
+//
+//      if( CricketRelayPending() ) ...     // TRUE if new relay state not yet sent
+//
+//  DESCRIPTION
+//
+//      Cricket lamp/relay board driver, with a coalescing outbox.
+//
+//      The whole board is set with one frame holding a bit per relay. The calls below
+//        only change the newest relay mask. The outbox sends it when the previous relay
+//        frame has completely left the bus, so a control loop can switch relays as
+//        often as it likes and the bus only ever carries the newest mask (and never
+//        one the board already has).
+//
+//  NOTES
+//
+//      Author has only tested the LED display. The command bytes below follow the same
+//        layout as the LED (command + number, then data), but have not been checked
+//        against a real board - verify them against your board's documentation.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CRICKETRELAY_H
+#define CRICKETRELAY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "CricketBus.h"
+
+#define CRICKET_RELAYS          8           // Relays 0-7, bit per relay
+
+#define CRICKET_RELAY_SET       0x00        // Next byte is relay mask
+#define CRICKET_RELAY_FRAME     3           // Device, command, mask
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketRelaySet - Set all relays at once
+// CricketRelayOn  - Turn one relay on
+// CricketRelayOff - Turn one relay off
+//
+// The new mask is sent from CricketRelayService(), when the bus is free.
+//
+// Inputs:      [CricketRelaySet]            Relay mask, bit per relay (1 == on)
+//              [CricketRelayOn, _Off]       Relay number (0-7)
+//
+// Outputs:     None.
+//
+void CricketRelaySet(uint8_t Mask);
+void CricketRelayOn (uint8_t Relay);
+void CricketRelayOff(uint8_t Relay);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketRelayService - Send the relay mask, if changed and the bus is free
+//
+// Call often, from the main loop. The calls above also call this.
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void CricketRelayService(void);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketRelayPending - Return TRUE if a new relay mask is waiting to be sent
+//
+// Inputs:      None.
+//
+// Outputs:     TRUE  if the board doesn't have the newest mask yet
+//              FALSE if up to date
+//
+bool CricketRelayPending(void);
+
+#endif  // CRICKETRELAY_H - entire file
@@ -0,0 +1,308 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      CricketSched.c
+//
+//  SYNOPSIS
+//
+//      //////////////////////////////////////
+//      //
+//      // In CricketSched.h
+//      //
+//      #define CRICKET_SCHED_LOAD      80      // Max % of bus time for non-urgent frames
+//      #define CRICKET_SCHED_BACKLOG   8       // Max non-urgent bytes in the bus FIFO
+//
+//      //////////////////////////////////////
+//      //
+//      // In main.c
+//      //
+//      CricketBusInit();                   // Called once at startup
+//      CricketSchedInit();
+//
+//      uint8_t Frame[] = { CRICKET_BUS_RELAY, 0x01 };
+//
+//      CricketSchedPut(CRICKET_SCHED_URGENT,Key,Frame,sizeof(Frame));   // Queue a frame
+//
+//      CricketSchedTick();                 // Called every CRICKET_TICK_MS
+//      CricketSchedService();              // Called often, from the main loop
+//
+//      uint8_t Queued = CricketSchedQueued(CRICKET_SCHED_DISPLAY);   // Frames waiting
+//
+//  DESCRIPTION
+//
+//      Priority frame scheduler for the cricket bus. See CricketSched.h
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+
+#include <avr/interrupt.h>
+
+#include "CricketSched.h"
+#include "PortMacros.h"
+
+#if CRICKET_SCHED_BURST_US > 32767
+#   error "CricketSched.c: CRICKET_TICK_MS too long for the scheduler budget"
+#endif
+
+#if CRICKET_SCHED_BACKLOG + CRICKET_SCHED_FRAME_MAX > CRICKET_FIFO_SIZE - 1 - CRICKET_FIFO_RESERVE
+#   error "CricketSched.c: CRICKET_SCHED_BACKLOG too large for the bus FIFO"
+#endif
+
+#define SCHED_BUDGET    ((int16_t) CRICKET_SCHED_BUDGET_US)
+#define SCHED_BURST     ((int16_t) CRICKET_SCHED_BURST_US)
+
+typedef struct {
+    uint8_t Key;
+    uint8_t Len;
+    uint8_t Bytes[CRICKET_SCHED_FRAME_MAX];
+    } SCHED_FRAME;
+
+//
+// Each class queue is kept in order, oldest first, so that a superseded frame can be
+//   squeezed out of the middle.
+//
+static struct {
+    SCHED_FRAME Queue[CRICKET_SCHED_CLASSES][CRICKET_SCHED_DEPTH];
+    uint8_t     Count[CRICKET_SCHED_CLASSES];
+
+    int16_t     Budget;                     // uS of bus time available to non-urgent
+    } Sched NOINIT;
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketSchedInit - Initialize the frame scheduler
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void CricketSchedInit(void) {
+
+    memset(&Sched,0,sizeof(Sched));
+
+    Sched.Budget = SCHED_BUDGET;
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// RemoveFrame - Take one frame out of a class queue
+//
+// Inputs:      Priority class
+//              Index of frame to remove
+//
+// Outputs:     None.
+//
+static void RemoveFrame(uint8_t Class,uint8_t Index) {
+    SCHED_FRAME *Queue = Sched.Queue[Class];
+
+    Sched.Count[Class]--;
+    memmove(&Queue[Index],&Queue[Index+1],(Sched.Count[Class]-Index)*sizeof(SCHED_FRAME));
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketSchedPut - Queue one frame for the bus
+//
+// Inputs:      Priority class (CRICKET_SCHED_URGENT, _DISPLAY or _BULK)
+//              Key identifying what the frame sets, or CRICKET_SCHED_NOKEY
+//              Frame bytes: device byte, then data
+//              Number of frame bytes (1 to CRICKET_SCHED_FRAME_MAX)
+//
+// Outputs:     TRUE  if frame was queued OK,
+//              FALSE if class queue full (or bad class or length)
+//
+bool CricketSchedPut(uint8_t Class,uint8_t Key,const uint8_t *Frame,uint8_t Len) {
+    SCHED_FRAME *Queue;
+    uint8_t      Index;
+
+    if( Class >= CRICKET_SCHED_CLASSES || Len == 0 || Len > CRICKET_SCHED_FRAME_MAX )
+        return(false);
+
+    Queue = Sched.Queue[Class];
+
+    //
+    // Drop any stale frame for the same thing. The new one goes at the end, so it
+    //   still follows anything queued after the stale one.
+    //
+    if( Key != CRICKET_SCHED_NOKEY ) {
+        for( Index = 0; Index < Sched.Count[Class]; Index++ ) {
+            if( Queue[Index].Key == Key && Queue[Index].Bytes[0] == Frame[0] ) {
+                RemoveFrame(Class,Index);
+                break;
+                }
+            }
+        }
+
+    if( Sched.Count[Class] >= CRICKET_SCHED_DEPTH )
+        return(false);
+
+    Queue      = &Queue[Sched.Count[Class]++];
+    Queue->Key = Key;
+    Queue->Len = Len;
+    memcpy(Queue->Bytes,Frame,Len);
+
+    CricketSchedService();
+
+    return(true);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketSchedTick - Add one tick's worth of bus time to the budget
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void CricketSchedTick(void) {
+
+    Sched.Budget += SCHED_BUDGET;
+    if( Sched.Budget > SCHED_BURST )
+        Sched.Budget = SCHED_BURST;
+
+    CricketSchedService();
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// SendFrame - Hand the head frame of a class queue to the bus
+//
+// The caller has checked that there's room for it.
+//
+// Inputs:      Priority class
+//
+// Outputs:     None.
+//
+static void SendFrame(uint8_t Class) {
+    SCHED_FRAME *Frame = &Sched.Queue[Class][0];
+    uint8_t      Index;
+
+    for( Index = 0; Index < Frame->Len; Index++ )
+        CricketBusPut(Frame->Bytes[Index],Index == 0);
+
+    Sched.Budget -= CRICKET_FRAME_US(Frame->Len);
+    if( Sched.Budget < -SCHED_BURST )
+        Sched.Budget = -SCHED_BURST;
+
+    RemoveFrame(Class,0);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketSchedService - Move frames from the class queues to the bus
+//
+// Strict priority: if the head frame of a class can't go yet, nothing from a lower
+//   class goes either.
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void CricketSchedService(void) {
+    uint8_t Class;
+
+    for( Class = 0; Class < CRICKET_SCHED_CLASSES; Class++ ) {
+        while( Sched.Count[Class] ) {
+            SCHED_FRAME *Frame = &Sched.Queue[Class][0];
+
+            if( CricketBusRoom() < Frame->Len )
+                return;
+
+            if( Class != CRICKET_SCHED_URGENT ) {
+                if( Sched.Budget < (int16_t) CRICKET_FRAME_US(Frame->Len) )
+                    return;
+                if( CricketBusQueued() + Frame->Len > CRICKET_SCHED_BACKLOG )
+                    return;
+                }
+
+            SendFrame(Class);
+            }
+        }
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketSchedFlush - Hand every frame in a class, and the classes above it, to the bus
+//
+// Frames go out in the usual order, waiting for room in the bus FIFO but not for the
+//   budget or backlog limits. They're still charged to the budget. Non-urgent frames
+//   leave CRICKET_FIFO_RESERVE free, as CricketBusPutW does.
+//
+// Inputs:      Priority class
+//
+// Outputs:     None.
+//
+void CricketSchedFlush(uint8_t Class) {
+    uint8_t Above;
+
+    if( Class >= CRICKET_SCHED_CLASSES )
+        return;
+
+    for( Above = 0; Above <= Class; Above++ ) {
+        uint8_t Reserve = Above == CRICKET_SCHED_URGENT ? 0 : CRICKET_FIFO_RESERVE;
+
+        while( Sched.Count[Above] ) {
+            while( CricketBusRoom() < Sched.Queue[Above][0].Len + Reserve )
+                ;
+            SendFrame(Above);
+            }
+        }
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketSchedQueued - Return number of frames waiting in a class
+//
+// Inputs:      Priority class
+//
+// Outputs:     Number of frames not yet handed to the bus
+//
+uint8_t CricketSchedQueued(uint8_t Class) {
+
+    if( Class >= CRICKET_SCHED_CLASSES )
+        return(0);
+
+    return(Sched.Count[Class]);
+    }
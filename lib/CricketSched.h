@@ -0,0 +1,224 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      CricketSched.h - Priority frame scheduler for the cricket bus
+//
+//  SYNOPSIS
+//
+//      //////////////////////////////////////
+//      //
+//      // In CricketSched.h
+//      //
+//      #define CRICKET_SCHED_LOAD      80      // Max % of bus time for non-urgent frames
+//      #define CRICKET_SCHED_BACKLOG   8       // Max non-urgent bytes in the bus FIFO
+//
+//      //////////////////////////////////////
+//      //
+//      // In main.c
+//      //
+//      CricketBusInit();                   // Called once at startup
+//      CricketSchedInit();
+//
+//      uint8_t Frame[] = { CRICKET_BUS_RELAY, 0x01 };
+//
+//      CricketSchedPut(CRICKET_SCHED_URGENT,Key,Frame,sizeof(Frame));   // Queue a frame
+//
+//      CricketSchedTick();                 // Called every CRICKET_TICK_MS
+//      CricketSchedService();              // Called often, from the main loop
+//
+//      uint8_t Queued = CricketSchedQueued(CRICKET_SCHED_DISPLAY);   // Frames waiting
+//
+//  DESCRIPTION
+//
+//      Frame scheduler for the cricket bus.
+//
+//      A frame is a device byte (sent as a command) followed by its data bytes. Frames
+//        are queued by priority class and fed to CricketBusPut() whole, highest class
+//        first:
+//
+//          CRICKET_SCHED_URGENT    Motor and relay commands
+//          CRICKET_SCHED_DISPLAY   LED display updates
+//          CRICKET_SCHED_BULK      Anything that can wait
+//
+//      Non-urgent frames are limited two ways:
+//
+//        - A bus-time budget, refilled by CricketSchedTick() with CRICKET_SCHED_LOAD
+//            percent of each tick. Each frame costs its real time on the wire, which
+//            is the pre-start plus the bit cells of every byte (CRICKET_FRAME_US).
+//
+//        - At most CRICKET_SCHED_BACKLOG bytes of them sit in the bus FIFO at once.
+//
+//      Urgent frames skip both checks (but are charged to the budget), so an urgent
+//        frame waits for at most CRICKET_SCHED_BACKLOG bytes of display traffic plus
+//        any urgent frames ahead of it, no matter how much display traffic is queued.
+//
+//      Each frame has a Key. Queuing a frame with the same device byte and Key as one
+//        already waiting in that class drops the stale one, so a display that gets
+//        updated faster than the bus can keep up only sends the newest contents.
+//        Use CRICKET_SCHED_NOKEY for frames that must all be sent.
+//
+//  NOTES
+//
+//      The scheduler is not interrupt safe: call everything from the main loop (or
+//        everything from one ISR).
+//
+//      With CRICKET_DRIVER_BITBANG, frames are sent from CricketSchedService()
+//        before it returns.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CRICKETSCHED_H
+#define CRICKETSCHED_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "CricketBus.h"
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Scheduler limits
+//
+#ifndef CRICKET_SCHED_LOAD
+#define CRICKET_SCHED_LOAD      80          // Max % of bus time for non-urgent frames
+#endif
+
+#ifndef CRICKET_SCHED_BACKLOG
+#define CRICKET_SCHED_BACKLOG   8           // Max non-urgent bytes in the bus FIFO
+#endif
+
+#ifndef CRICKET_SCHED_DEPTH
+#define CRICKET_SCHED_DEPTH     8           // Frames queued per class
+#endif
+
+//
+// End of user configurable options
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#define CRICKET_SCHED_URGENT    0           // Motor and relay commands
+#define CRICKET_SCHED_DISPLAY   1           // LED display updates
+#define CRICKET_SCHED_BULK      2           // Anything that can wait
+#define CRICKET_SCHED_CLASSES   3
+
+#define CRICKET_SCHED_FRAME_MAX 6           // Device + command + 4 data (LED pattern)
+#define CRICKET_SCHED_NOKEY     0xFF        // Frame never supersedes, nor is superseded
+
+//
+// Budget added per tick, and the most that can build up while the bus is idle (two
+//   ticks' worth), in uS of bus time.
+//
+#define CRICKET_SCHED_BUDGET_US ((CRICKET_TICK_MS*1000UL*CRICKET_SCHED_LOAD)/100)
+#define CRICKET_SCHED_BURST_US  (2*CRICKET_SCHED_BUDGET_US)
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketSchedInit - Initialize the frame scheduler
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void CricketSchedInit(void);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketSchedPut - Queue one frame for the bus
+//
+// The frame is queued in its class, after anything already waiting there. A waiting
+//   frame with the same device byte (Frame[0]) and Key is dropped.
+//
+// Inputs:      Priority class (CRICKET_SCHED_URGENT, _DISPLAY or _BULK)
+//              Key identifying what the frame sets, or CRICKET_SCHED_NOKEY
+//              Frame bytes: device byte, then data
+//              Number of frame bytes (1 to CRICKET_SCHED_FRAME_MAX)
+//
+// Outputs:     TRUE  if frame was queued OK,
+//              FALSE if class queue full (or bad class or length)
+//
+bool CricketSchedPut(uint8_t Class,uint8_t Key,const uint8_t *Frame,uint8_t Len);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketSchedTick - Add one tick's worth of bus time to the budget
+//
+// Call once every CRICKET_TICK_MS, from the main loop (it services the queues as
+//   well, so it isn't safe from an interrupt; see NOTES above).
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void CricketSchedTick(void);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketSchedService - Move frames from the class queues to the bus
+//
+// Call often, from the main loop. CricketSchedPut() and CricketSchedTick() also call
+//   this.
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void CricketSchedService(void);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketSchedFlush - Hand every frame in a class, and the classes above it, to the bus
+//
+// For a burst that has to go out back to back (see CricketSync.h). Waits for room in
+//   the bus FIFO, but not for the budget, which it overdraws. Main loop only.
+//
+// Inputs:      Priority class
+//
+// Outputs:     None.
+//
+void CricketSchedFlush(uint8_t Class);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketSchedQueued - Return number of frames waiting in a class
+//
+// Inputs:      Priority class
+//
+// Outputs:     Number of frames not yet handed to the bus
+//
+uint8_t CricketSchedQueued(uint8_t Class);
+
+#endif  // CRICKETSCHED_H - entire file
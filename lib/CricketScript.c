@@ -0,0 +1,258 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      CricketScript.c
+//
+//  SYNOPSIS
+//
+//      static const uint8_t Demo[] PROGMEM = {
+//          CRICKET_S_BRIGHT(0,4),                  // Brightness 4, all displays
+//          CRICKET_S_SET(1025),                    // Counter = 1025
+//          CRICKET_S_REPEAT(0),                    // Forever:
+//              CRICKET_S_TEXT(0,4,'H','E','L','P'),    // Show "HELP"
+//              CRICKET_S_WAIT(1000),                   // 1 second
+//              CRICKET_S_REPEAT(64),                   // 64 times:
+//                  CRICKET_S_SHOWDEC(0),                   // Show counter in decimal
+//                  CRICKET_S_ADD(1),                       // Count up
+//                  CRICKET_S_WAIT(100),                    // 100 mS
+//              CRICKET_S_NEXT,
+//          CRICKET_S_NEXT,
+//          CRICKET_S_END };
+//
+//      CricketScriptRun(Demo,CRICKET_SCRIPT_PROGMEM);  // Start a script in flash
+//      CricketScriptRun(Addr,CRICKET_SCRIPT_EEPROM);   // ...or in EEPROM
+//      CricketScriptStop();
+//
+//      if( CricketScriptBusy() ) ...               // TRUE while running
+//
+//      CricketScriptTick();                        // Called every CRICKET_TICK_MS
+//
+//  DESCRIPTION
+//
+//      Bytecode interpreter for display sequences. See CricketScript.h
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#include <avr/pgmspace.h>
+#include <avr/eeprom.h>
+
+#include "CricketScript.h"
+#include "PortMacros.h"
+
+static struct {
+    const uint8_t *PC;                      // Next byte to run
+    uint8_t     Where;                      // CRICKET_SCRIPT_PROGMEM, &c
+    uint16_t    Counter;
+    uint16_t    Wait;                       // Ticks left to wait
+    uint8_t     Depth;                      // REPEATs open
+    struct {
+        const uint8_t *Loop;                // First instruction of the loop
+        uint8_t     Count;                  // Passes left, 0 == forever
+        } Repeat[CRICKET_SCRIPT_DEPTH];
+    bool        Running;
+    } Script;
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Fetch - Get the next script byte
+//
+// Inputs:      None.
+//
+// Outputs:     Next byte of the script
+//
+static uint8_t Fetch(void) {
+    const uint8_t *PC = Script.PC++;
+
+    if( Script.Where == CRICKET_SCRIPT_PROGMEM ) return(pgm_read_byte(PC));
+    if( Script.Where == CRICKET_SCRIPT_EEPROM  ) return(eeprom_read_byte(PC));
+
+    return(*PC);
+    }
+
+static uint16_t Fetch16(void) {
+    uint16_t Hi = Fetch();
+
+    return((Hi << 8) | Fetch());
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketScriptRun - Start running a script
+//
+// Inputs:      Script address
+//              Where it is (CRICKET_SCRIPT_PROGMEM, _EEPROM or _RAM)
+//
+// Outputs:     None.
+//
+void CricketScriptRun(const uint8_t *Start,uint8_t Where) {
+
+    Script.PC      = Start;
+    Script.Where   = Where;
+    Script.Counter = 0;
+    Script.Wait    = 0;
+    Script.Depth   = 0;
+    Script.Running = true;
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketScriptStop - Stop the script
+// CricketScriptBusy - Return TRUE if a script is running
+//
+// Inputs:      None.
+//
+// Outputs:     [CricketScriptBusy] TRUE if running, FALSE if stopped or done
+//
+void CricketScriptStop(void) { Script.Running = false; }
+bool CricketScriptBusy(void) { return(Script.Running); }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Step - Run one instruction
+//
+// Inputs:      None.
+//
+// Outputs:     TRUE  to keep going this tick
+//              FALSE to stop for this tick (WAIT, END or error)
+//
+static bool Step(void) {
+    uint8_t Op = Fetch();
+    uint8_t ID = Op & CRICKET_OP_ID;
+
+    switch( Op & CRICKET_OP_MASK ) {
+
+        case CRICKET_OP_DEC:     CricketLEDDec(Fetch16(),ID);       break;
+        case CRICKET_OP_HEX:     CricketLEDHex(Fetch16(),ID);       break;
+        case CRICKET_OP_BRIGHT:  CricketLEDBright(Fetch(),ID);      break;
+        case CRICKET_OP_SHOWDEC: CricketLEDDec(Script.Counter,ID);  break;
+        case CRICKET_OP_SHOWHEX: CricketLEDHex(Script.Counter,ID);  break;
+        case CRICKET_OP_SET:     Script.Counter  = Fetch16();       break;
+        case CRICKET_OP_ADD:     Script.Counter += (int8_t) Fetch();break;
+
+        case CRICKET_OP_PAT: {
+            uint8_t Pat[4];
+            uint8_t Index;
+
+            for( Index = 0; Index < 4; Index++ )
+                Pat[Index] = Fetch();
+
+            CricketLEDPat(Pat[0],Pat[1],Pat[2],Pat[3],ID);
+            break;
+            }
+
+        case CRICKET_OP_TEXT: {
+            char    Text[CRICKET_SCRIPT_TEXT_MAX+1];
+            uint8_t Len = Fetch();
+            uint8_t Index;
+
+            for( Index = 0; Index < Len; Index++ ) {
+                char Char = Fetch();
+
+                if( Index < CRICKET_SCRIPT_TEXT_MAX )
+                    Text[Index] = Char;
+                }
+            Text[Len < CRICKET_SCRIPT_TEXT_MAX ? Len : CRICKET_SCRIPT_TEXT_MAX] = 0;
+
+            CricketLEDText(Text,0,ID);
+            break;
+            }
+
+        case CRICKET_OP_WAIT:
+            Script.Wait = Fetch16();
+            return(false);
+
+        case CRICKET_OP_REPEAT:
+            if( Script.Depth == CRICKET_SCRIPT_DEPTH ) {
+                Script.Running = false;                 // Nested too deep
+                return(false);
+                }
+            Script.Repeat[Script.Depth].Count = Fetch();
+            Script.Repeat[Script.Depth].Loop  = Script.PC;
+            Script.Depth++;
+            break;
+
+        case CRICKET_OP_NEXT: {
+            uint8_t *Count;
+
+            if( Script.Depth == 0 ) {
+                Script.Running = false;                 // NEXT without REPEAT
+                return(false);
+                }
+
+            Count = &Script.Repeat[Script.Depth-1].Count;
+
+            if( *Count == 0 || --(*Count) ) {
+                Script.PC = Script.Repeat[Script.Depth-1].Loop;
+                break;
+                }
+
+            Script.Depth--;
+            break;
+            }
+
+        case CRICKET_OP_END:
+        default:
+            Script.Running = false;
+            return(false);
+        }
+
+    return(true);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketScriptTick - Run the script for one tick
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void CricketScriptTick(void) {
+    uint8_t Steps;
+
+    if( !Script.Running )
+        return;
+
+    if( Script.Wait && --Script.Wait )
+        return;
+
+    for( Steps = 0; Steps < CRICKET_SCRIPT_STEPS; Steps++ ) {
+        if( !Step() )
+            break;
+        }
+    }
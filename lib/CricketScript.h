@@ -0,0 +1,200 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      CricketScript.h - Bytecode interpreter for display sequences
+//
+//  SYNOPSIS
+//
+//      static const uint8_t Demo[] PROGMEM = {
+//          CRICKET_S_BRIGHT(0,4),                  // Brightness 4, all displays
+//          CRICKET_S_SET(1025),                    // Counter = 1025
+//          CRICKET_S_REPEAT(0),                    // Forever:
+//              CRICKET_S_TEXT(0,4,'H','E','L','P'),    // Show "HELP"
+//              CRICKET_S_WAIT(1000),                   // 1 second
+//              CRICKET_S_REPEAT(64),                   // 64 times:
+//                  CRICKET_S_SHOWDEC(0),                   // Show counter in decimal
+//                  CRICKET_S_ADD(1),                       // Count up
+//                  CRICKET_S_WAIT(100),                    // 100 mS
+//              CRICKET_S_NEXT,
+//          CRICKET_S_NEXT,
+//          CRICKET_S_END };
+//
+//      CricketScriptRun(Demo,CRICKET_SCRIPT_PROGMEM);  // Start a script in flash
+//      CricketScriptRun(Addr,CRICKET_SCRIPT_EEPROM);   // ...or in EEPROM
+//      CricketScriptStop();
+//
+//      if( CricketScriptBusy() ) ...               // TRUE while running
+//
+//      CricketScriptTick();                        // Called every CRICKET_TICK_MS
+//
+//  DESCRIPTION
+//
+//      Bytecode interpreter for scripted display sequences.
+//
+//      A script is a byte string in PROGMEM, EEPROM or RAM, built with the
+//        CRICKET_S_xxx macros below. Scripts in EEPROM can be changed (over the serial
+//        port, say) without reflashing. Each step of a sequence costs 1 to 6 bytes of
+//        script, instead of a function call with its arguments in code.
+//
+//      Opcodes are one byte, with the device ID (where there is one) in the low bits,
+//        followed by their operands:
+//
+//          END                         Stop
+//          DEC     ID, hi, lo          Show number in decimal
+//          HEX     ID, hi, lo          Show number in hex
+//          PAT     ID, a, b, c, d      Show segment pattern
+//          TEXT    ID, len, chars...   Show text (see CricketLEDText), len <= 8
+//          BRIGHT  ID, level           Set brightness
+//          SHOWDEC ID                  Show the counter in decimal
+//          SHOWHEX ID                  Show the counter in hex
+//          SET     hi, lo              Counter = value
+//          ADD     delta               Counter += delta (signed, -128 to 127)
+//          WAIT    hi, lo              Wait, in ticks (CRICKET_TICK_MS each)
+//          REPEAT  count               Run to the matching NEXT count times, 0 == forever
+//          NEXT                        End of REPEAT
+//
+//      CricketScriptTick() runs the script until a WAIT, or until it has run
+//        CRICKET_SCRIPT_STEPS instructions, so that a script without WAITs can't hang
+//        the main loop.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CRICKETSCRIPT_H
+#define CRICKETSCRIPT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "CricketLED.h"
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// User configurable options
+//
+#ifndef CRICKET_SCRIPT_DEPTH
+#define CRICKET_SCRIPT_DEPTH    4           // Max REPEAT nesting
+#endif
+
+#ifndef CRICKET_SCRIPT_STEPS
+#define CRICKET_SCRIPT_STEPS    16          // Max instructions per tick
+#endif
+
+//
+// End of user configurable options
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#define CRICKET_SCRIPT_PROGMEM  0           // Where the script is
+#define CRICKET_SCRIPT_EEPROM   1
+#define CRICKET_SCRIPT_RAM      2
+
+#define CRICKET_SCRIPT_TEXT_MAX 8           // Max chars in TEXT
+
+//
+// Opcodes. Those with a device ID have it in the low 2 bits.
+//
+#define CRICKET_OP_END          0x00
+#define CRICKET_OP_DEC          0x10
+#define CRICKET_OP_HEX          0x20
+#define CRICKET_OP_PAT          0x30
+#define CRICKET_OP_TEXT         0x40
+#define CRICKET_OP_BRIGHT       0x50
+#define CRICKET_OP_SHOWDEC      0x60
+#define CRICKET_OP_SHOWHEX      0x70
+#define CRICKET_OP_SET          0x80
+#define CRICKET_OP_ADD          0x90
+#define CRICKET_OP_WAIT         0xA0
+#define CRICKET_OP_REPEAT       0xB0
+#define CRICKET_OP_NEXT         0xC0
+
+#define CRICKET_OP_MASK         0xF0
+#define CRICKET_OP_ID           0x03
+
+//
+// Script building macros
+//
+#define CRICKET_S_HI(_n_)       (((_n_) >> 8) & 0xFF)
+#define CRICKET_S_LO(_n_)       ((_n_) & 0xFF)
+
+#define CRICKET_S_END                   CRICKET_OP_END
+#define CRICKET_S_DEC(_ID_,_n_)         CRICKET_OP_DEC+(_ID_),CRICKET_S_HI(_n_),CRICKET_S_LO(_n_)
+#define CRICKET_S_HEX(_ID_,_n_)         CRICKET_OP_HEX+(_ID_),CRICKET_S_HI(_n_),CRICKET_S_LO(_n_)
+#define CRICKET_S_PAT(_ID_,_a_,_b_,_c_,_d_) CRICKET_OP_PAT+(_ID_),_a_,_b_,_c_,_d_
+#define CRICKET_S_TEXT(_ID_,_Len_,...)  CRICKET_OP_TEXT+(_ID_),_Len_,__VA_ARGS__
+#define CRICKET_S_BRIGHT(_ID_,_Level_)  CRICKET_OP_BRIGHT+(_ID_),_Level_
+#define CRICKET_S_SHOWDEC(_ID_)         CRICKET_OP_SHOWDEC+(_ID_)
+#define CRICKET_S_SHOWHEX(_ID_)         CRICKET_OP_SHOWHEX+(_ID_)
+#define CRICKET_S_SET(_n_)              CRICKET_OP_SET,CRICKET_S_HI(_n_),CRICKET_S_LO(_n_)
+#define CRICKET_S_ADD(_Delta_)          CRICKET_OP_ADD,(uint8_t) (_Delta_)
+#define CRICKET_S_WAIT(_MS_)            CRICKET_OP_WAIT,CRICKET_S_HI((_MS_)/CRICKET_TICK_MS),  \
+                                                        CRICKET_S_LO((_MS_)/CRICKET_TICK_MS)
+#define CRICKET_S_REPEAT(_Count_)       CRICKET_OP_REPEAT,_Count_
+#define CRICKET_S_NEXT                  CRICKET_OP_NEXT
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketScriptRun - Start running a script
+//
+// Inputs:      Script address
+//              Where it is (CRICKET_SCRIPT_PROGMEM, _EEPROM or _RAM)
+//
+// Outputs:     None.
+//
+void CricketScriptRun(const uint8_t *Script,uint8_t Where);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketScriptStop - Stop the script
+// CricketScriptBusy - Return TRUE if a script is running
+//
+// Inputs:      None.
+//
+// Outputs:     [CricketScriptBusy] TRUE if running, FALSE if stopped or done
+//
+void CricketScriptStop(void);
+bool CricketScriptBusy(void);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketScriptTick - Run the script for one tick
+//
+// Call once every CRICKET_TICK_MS, from the main loop.
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void CricketScriptTick(void);
+
+#endif  // CRICKETSCRIPT_H - entire file
@@ -0,0 +1,182 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      CricketSync.c
+//
+//  SYNOPSIS
+//
+//      CricketSyncPat(a,b,c,d,1);          // Stage a pattern for display 1
+//      CricketSyncText("12.5",0,2);        // Stage text for display 2
+//      CricketSyncSegs(Segs,2);            // Stage 4 patterns (from CricketNumberSegs, &c)
+//
+//      uint16_t Skew = CricketSyncCommit();    // Send all staged frames in one burst
+//      uint16_t Skew = CricketSyncSkew();      // Skew of the last commit, in uS
+//
+//      CricketSyncCancel();                // Drop the staged frames
+//
+//  DESCRIPTION
+//
+//      Synchronized updates of several LED displays. See CricketSync.h
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+
+#include "CricketSync.h"
+#include "PortMacros.h"
+
+#if !defined(CRICKET_LED_SCHED) && \
+    CRICKET_FIFO_SIZE <= CRICKET_SYNC_FRAME*CRICKET_LED_IDS + CRICKET_FIFO_RESERVE
+#   error "CricketSync.c: CRICKET_FIFO_SIZE too small for a burst to every display"
+#endif
+
+static struct {
+    uint8_t     Back[CRICKET_LED_IDS][4];   // Staged patterns
+    uint8_t     Staged;                     // Bit per ID
+    uint16_t    Skew;                       // Last commit, uS
+    } Sync;
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketSyncPat  - Stage a pattern for one display
+// CricketSyncSegs - Stage a pattern for one display, from an array
+// CricketSyncText - Stage text for one display (see CricketLEDText)
+//
+// Inputs:      [Pat]  Pattern, as four bytes
+//              [Segs] Pattern, as an array of four bytes
+//              [Text] Text, and extra decimal points
+//              Device ID (0, 1 or 2)
+//
+// Outputs:     None.
+//
+void CricketSyncPat(uint8_t Dig1,uint8_t Dig2,uint8_t Dig3,uint8_t Dig4,uint8_t ID) {
+    uint8_t Segs[4] = { Dig1, Dig2, Dig3, Dig4 };
+
+    CricketSyncSegs(Segs,ID);
+    }
+
+void CricketSyncSegs(const uint8_t *Segs,uint8_t ID) {
+
+    if( ID >= CRICKET_LED_IDS )
+        return;
+
+    memcpy(Sync.Back[ID],Segs,4);
+    _SET_BIT(Sync.Staged,ID);
+    }
+
+void CricketSyncText(const char *Text,uint8_t Dots,uint8_t ID) {
+    uint8_t Segs[4] = { 0, 0, 0, 0 };
+    uint8_t Index;
+
+    CricketFontText(Text,Segs,sizeof(Segs));
+
+    for( Index = 0; Index < 4; Index++ ) {
+        if( _BIT_ON(Dots,Index) )
+            Segs[Index] |= CRICKET_SEG_DP;
+        }
+
+    CricketSyncSegs(Segs,ID);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketSyncCommit - Send every staged frame, in one burst
+// CricketSyncCancel - Drop every staged frame
+//
+// Inputs:      None.
+//
+// Outputs:     [CricketSyncCommit] Skew between the first and last display, in uS
+//
+uint16_t CricketSyncCommit(void) {
+    uint16_t Posted;
+    uint16_t Bytes;
+    uint8_t  ID;
+
+#ifdef CRICKET_LED_SCHED
+    //
+    // LED frames go through the scheduler. Send what's already waiting first, so that
+    //   nothing older follows the burst, and the burst is all that's left to flush.
+    //
+    CricketSchedFlush(CRICKET_LED_SCHED);
+#else
+    uint8_t Frames = 0;
+
+    for( ID = 0; ID < CRICKET_LED_IDS; ID++ ) {
+        if( _BIT_ON(Sync.Staged,ID) )
+            Frames++;
+        }
+
+    //
+    // Wait for room for the whole burst (past the reserve CricketBusPutW leaves), so
+    //   that CricketLEDPat never waits for the FIFO part way through and leaves a gap.
+    //
+    while( CricketBusRoom() < Frames*CRICKET_SYNC_FRAME + CRICKET_FIFO_RESERVE )
+        ;
+#endif
+
+    Posted = CricketBusPosted();
+
+    for( ID = 0; ID < CRICKET_LED_IDS; ID++ ) {
+        uint8_t *Segs = Sync.Back[ID];
+
+        if( _BIT_ON(Sync.Staged,ID) )
+            CricketLEDPat(Segs[0],Segs[1],Segs[2],Segs[3],ID);
+        }
+
+#ifdef CRICKET_LED_SCHED
+    CricketSchedFlush(CRICKET_LED_SCHED);
+#endif
+
+    Sync.Staged = 0;
+
+    //
+    // Skew is everything that went on the bus after the first frame
+    //
+    Bytes     = CricketBusPosted() - Posted;
+    Sync.Skew = Bytes > CRICKET_SYNC_FRAME ? CRICKET_FRAME_US(Bytes - CRICKET_SYNC_FRAME) : 0;
+
+    return(Sync.Skew);
+    }
+
+void CricketSyncCancel(void) { Sync.Staged = 0; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketSyncSkew - Return the skew of the last commit
+//
+// Inputs:      None.
+//
+// Outputs:     Skew between the first and last display to change, in uS
+//
+uint16_t CricketSyncSkew(void) { return(Sync.Skew); }
@@ -0,0 +1,129 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      CricketSync.h - Synchronized updates of several LED displays
+//
+//  SYNOPSIS
+//
+//      CricketSyncPat(a,b,c,d,1);          // Stage a pattern for display 1
+//      CricketSyncText("12.5",0,2);        // Stage text for display 2
+//      CricketSyncSegs(Segs,2);            // Stage 4 patterns (from CricketNumberSegs, &c)
+//
+//      uint16_t Skew = CricketSyncCommit();    // Send all staged frames in one burst
+//      uint16_t Skew = CricketSyncSkew();      // Skew of the last commit, in uS
+//
+//      CricketSyncCancel();                // Drop the staged frames
+//
+//  DESCRIPTION
+//
+//      Double-buffered, synchronized updates of several LED displays.
+//
+//      Writes to displays one after another show a mix of old and new values for a
+//        frame time or more in between. Here, the new contents are staged in a back
+//        buffer first, then CricketSyncCommit() sends them all as one burst.
+//
+//      The commit waits until the bus FIFO has room for the whole burst, then queues
+//        every frame at once. The bus driver sends queued bytes back to back, so the
+//        frames follow each other with no gap beyond the pre-start every byte has
+//        anyway.
+//
+//      Frames go through CricketLEDPat(), so the LED shadow stays current, and a staged
+//        display that's already showing its new contents costs nothing.
+//
+//      A display changes when the last byte of its frame arrives, so the skew between
+//        the first and last display to change is the bus time of everything queued
+//        after the first frame - 1.26 mS per extra display at the standard bus
+//        timing. CricketSyncCommit() counts the bytes that actually went into the bus
+//        FIFO (CricketBusPosted), so unchanged displays don't count, and returns the
+//        skew. It can be read back later with CricketSyncSkew().
+//
+//  NOTES
+//
+//      With CRICKET_LED_SCHED defined, the commit hands the scheduler's LED class to
+//        the bus before and after the burst (CricketSchedFlush), so older LED frames
+//        go out first and the burst still goes out whole. That overdraws the
+//        scheduler's budget for a while.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CRICKETSYNC_H
+#define CRICKETSYNC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "CricketLED.h"
+
+#define CRICKET_SYNC_FRAME      6           // Bytes in a pattern frame
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketSyncPat  - Stage a pattern for one display
+// CricketSyncSegs - Stage a pattern for one display, from an array
+// CricketSyncText - Stage text for one display (see CricketLEDText)
+//
+// Staging a display again replaces what was staged before.
+//
+// Inputs:      [Pat]  Pattern, as four bytes
+//              [Segs] Pattern, as an array of four bytes
+//              [Text] Text, and extra decimal points
+//              Device ID (0, 1 or 2)
+//
+// Outputs:     None.
+//
+void CricketSyncPat (uint8_t Dig1,uint8_t Dig2,uint8_t Dig3,uint8_t Dig4,uint8_t ID);
+void CricketSyncSegs(const uint8_t *Segs,uint8_t ID);
+void CricketSyncText(const char *Text,uint8_t Dots,uint8_t ID);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketSyncCommit - Send every staged frame, in one burst
+// CricketSyncCancel - Drop every staged frame
+//
+// Inputs:      None.
+//
+// Outputs:     [CricketSyncCommit] Skew between the first and last display, in uS
+//
+uint16_t CricketSyncCommit(void);
+void     CricketSyncCancel(void);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketSyncSkew - Return the skew of the last commit
+//
+// Inputs:      None.
+//
+// Outputs:     Skew between the first and last display to change, in uS
+//
+uint16_t CricketSyncSkew(void);
+
+#endif  // CRICKETSYNC_H - entire file
@@ -0,0 +1,399 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      CricketTask.c
+//
+//  SYNOPSIS
+//
+//      CricketTaskInit();                  // Called once at startup
+//
+//      CricketTaskEvery(CricketFadeTick,CRICKET_TICK_MS);  // Periodic task
+//      CricketTaskEvery(CricketSchedService,1);
+//      CricketTaskAfter(LightsOut,60000);                  // One-shot task, in a minute
+//      CricketTaskStart(Demo);                             // Resumable task, see below
+//
+//      sei();
+//
+//      CricketTaskRun();                   // Never returns
+//
+//      uint32_t MS = CricketTaskMS();      // Time since startup
+//      uint32_t US = CricketTaskUS();
+//
+//      static void Demo(void) {
+//          static uint8_t Count;           // Locals don't survive a yield, use statics
+//
+//          CRICKET_PT_BEGIN;
+//
+//          for( Count = 0; Count < 10; Count++ ) {
+//              CricketLEDDec(Count,0);
+//              CRICKET_PT_DELAY(100);      // Other tasks run meanwhile
+//              }
+//
+//          CRICKET_PT_WAIT_UNTIL(!CricketBusBusy());
+//
+//          CRICKET_PT_END;                 // Task is done
+//          }
+//
+//  DESCRIPTION
+//
+//      See CricketTask.h
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+
+#include "CricketTask.h"
+#include "PortMacros.h"
+
+#if CRICKET_TASK_PER_MS > 256
+#   error "CricketTask.c: Timer0 counts more than 256 per mS, raise CRICKET_TASK_PRESCALE"
+#endif
+
+#define TASK_ONCE       0x01                // Remove after running
+#define TASK_RESCHED    0x02                // Task set its own next run
+#define TASK_IDLE       0x04                // Task found nothing to do
+#define TASK_EXIT       0x08                // Task asked to be removed
+
+typedef struct {
+    CricketTaskFn   Fn;                     // NULL if unused
+    uint32_t        Wake;                   // mS of the next run
+    uint16_t        Period;                 // mS, zero if not periodic
+    uint8_t         Flags;
+    } TASK;
+
+static struct {
+    volatile uint32_t   MS;                 // Counted by the Timer0 interrupt
+    volatile bool       Ticked;             // Set by the Timer0 interrupt
+    TASK                Tasks[CRICKET_TASK_MAX];
+    uint8_t             Current;            // Task running now
+    } Task;
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketTaskInit - Start the timebase, and clear the task table
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void CricketTaskInit(void) {
+
+    memset(&Task,0,sizeof(Task));
+    Task.Current = CRICKET_TASK_NONE;
+
+    //
+    // Timer0 in CTC mode, interrupting each mS
+    //
+    TCCR0A = _PIN_MASK(WGM01);
+    OCR0A  = CRICKET_TASK_PER_MS-1;
+    TCNT0  = 0;
+#if   CRICKET_TASK_PRESCALE == 8
+    TCCR0B = _PIN_MASK(CS01);
+#elif CRICKET_TASK_PRESCALE == 64
+    TCCR0B = _PIN_MASK(CS01) | _PIN_MASK(CS00);
+#elif CRICKET_TASK_PRESCALE == 256
+    TCCR0B = _PIN_MASK(CS02);
+#else
+#   error "CricketTask.c: CRICKET_TASK_PRESCALE must be 8, 64 or 256"
+#endif
+    TIFR0  = _PIN_MASK(OCF0A);
+    _SET_BIT(TIMSK0,OCIE0A);
+
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketTaskMS - Return mS since startup
+// CricketTaskUS - Return uS since startup
+//
+// For uS, if the compare matched since the last interrupt (because interrupts are
+//   off), that mS is counted here.
+//
+// Inputs:      None.
+//
+// Outputs:     Time since CricketTaskInit()
+//
+uint32_t CricketTaskMS(void) {
+    uint8_t  SaveSREG = SREG;
+    uint32_t MS;
+
+    cli();
+    MS   = Task.MS;
+    SREG = SaveSREG;
+
+    return(MS);
+    }
+
+uint32_t CricketTaskUS(void) {
+    uint8_t  SaveSREG = SREG;
+    uint32_t MS;
+    uint8_t  Count;
+
+    cli();
+    Count = TCNT0;
+    MS    = Task.MS;
+
+    if( _BIT_ON(TIFR0,OCF0A) ) {
+        Count = TCNT0;                      // Count from after the wrap
+        MS++;
+        }
+    SREG = SaveSREG;
+
+    return(MS*1000 + (uint32_t) Count*CRICKET_TASK_PRESCALE/(F_CPU/1000000UL));
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Add - Add a task to the table
+//
+// Inputs:      Task function
+//              mS until the first run
+//              Period in mS, or zero
+//              Flags
+//
+// Outputs:     Task number, or CRICKET_TASK_NONE if the table is full
+//
+static uint8_t Add(CricketTaskFn Fn,uint16_t MS,uint16_t Period,uint8_t Flags) {
+    uint8_t Index;
+
+    for( Index = 0; Index < CRICKET_TASK_MAX; Index++ ) {
+        TASK *T = &Task.Tasks[Index];
+
+        if( T->Fn != NULL )
+            continue;
+
+        T->Wake   = CricketTaskMS() + MS;
+        T->Period = Period;
+        T->Flags  = Flags;
+        T->Fn     = Fn;
+        return(Index);
+        }
+
+    return(CRICKET_TASK_NONE);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketTaskEvery - Add a task that runs every so often
+// CricketTaskAfter - Add a task that runs once, after a delay
+// CricketTaskStart - Add a task that runs every pass (resumable task)
+//
+// Inputs:      Task function
+//              [Every] Period in mS
+//              [After] Delay in mS
+//
+// Outputs:     Task number (for CricketTaskStop), or CRICKET_TASK_NONE if the table is full
+//
+uint8_t CricketTaskEvery(CricketTaskFn Fn,uint16_t MS) {
+
+    if( MS == 0 )
+        MS = 1;
+
+    return(Add(Fn,0,MS,0));
+    }
+
+uint8_t CricketTaskAfter(CricketTaskFn Fn,uint16_t MS) { return(Add(Fn,MS,0,TASK_ONCE)); }
+uint8_t CricketTaskStart(CricketTaskFn Fn)             { return(Add(Fn,0,0,0)); }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketTaskStop - Remove a task
+//
+// Inputs:      Task number, from when it was added
+//
+// Outputs:     None.
+//
+void CricketTaskStop(uint8_t Index) {
+
+    if( Index < CRICKET_TASK_MAX )
+        Task.Tasks[Index].Fn = NULL;
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketTaskDelay - Run the current task next after a delay
+// CricketTaskIdle  - Note that the current task found nothing to do
+// CricketTaskExit  - Remove the current task once it returns
+//
+// Inputs:      [Delay] mS until the next run
+//
+// Outputs:     None.
+//
+void CricketTaskDelay(uint16_t MS) {
+
+    if( Task.Current == CRICKET_TASK_NONE )
+        return;
+
+    Task.Tasks[Task.Current].Wake   = CricketTaskMS() + MS;
+    Task.Tasks[Task.Current].Flags |= TASK_RESCHED;
+    }
+
+void CricketTaskIdle(void) {
+
+    if( Task.Current != CRICKET_TASK_NONE )
+        Task.Tasks[Task.Current].Flags |= TASK_IDLE;
+    }
+
+void CricketTaskExit(void) {
+
+    if( Task.Current != CRICKET_TASK_NONE )
+        Task.Tasks[Task.Current].Flags |= TASK_EXIT;
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketTaskPass - Run each task that is due, once
+//
+// Inputs:      None.
+//
+// Outputs:     TRUE  if some task did something
+//              FALSE if all were idle, or none were due
+//
+bool CricketTaskPass(void) {
+    uint8_t Index;
+    bool    Work = false;
+
+    Task.Ticked = false;
+
+    for( Index = 0; Index < CRICKET_TASK_MAX; Index++ ) {
+        TASK    *T = &Task.Tasks[Index];
+        uint32_t Now;
+
+        if( T->Fn == NULL )
+            continue;
+
+        Now = CricketTaskMS();
+
+        if( (int32_t) (Now - T->Wake) < 0 )
+            continue;                               // Not due yet
+
+        T->Flags    &= ~(TASK_RESCHED | TASK_IDLE | TASK_EXIT);
+        Task.Current = Index;
+        T->Fn();
+        Task.Current = CRICKET_TASK_NONE;
+
+        if( T->Fn == NULL )
+            continue;                               // Stopped itself
+
+        if( !(T->Flags & TASK_IDLE) )
+            Work = true;
+
+        if( T->Flags & TASK_EXIT ) {
+            T->Fn = NULL;
+            continue;
+            }
+
+        if( T->Flags & TASK_RESCHED )
+            continue;                               // Delay set the next run
+
+        if( T->Flags & TASK_ONCE ) {
+            T->Fn = NULL;
+            continue;
+            }
+
+        //
+        // Periodic tasks keep to their schedule, but drop runs that were missed
+        //   entirely.
+        //
+        if( T->Period ) {
+            T->Wake += T->Period;
+
+            if( (int32_t) (Now - T->Wake) >= 0 )
+                T->Wake = Now + T->Period;
+            }
+        }
+
+    return(Work);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketTaskRun - Run tasks forever, sleeping when there's nothing to do
+//
+// A pass that found nothing to do sleeps until the next interrupt, unless the mS
+//   tick came during the pass (and might have made a task due). The sleep
+//   instruction right after sei() runs before any pending interrupt, so an interrupt
+//   can't slip in between the check and the sleep.
+//
+// Inputs:      None.
+//
+// Outputs:     None. (Never returns)
+//
+void CricketTaskRun(void) {
+
+    while(1) {
+        if( CricketTaskPass() )
+            continue;
+
+        cli();
+        if( !Task.Ticked ) {
+            sleep_enable();
+            sei();
+            sleep_cpu();
+            sleep_disable();
+            }
+        sei();
+        }
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// TIMER0_COMPA_vect - Count mS
+//
+// Inputs:      None. (ISR)
+//
+// Outputs:     None.
+//
+ISR(TIMER0_COMPA_vect) {
+
+    Task.MS++;
+    Task.Ticked = true;
+    }
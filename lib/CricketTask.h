@@ -0,0 +1,246 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      CricketTask.h - Cooperative task scheduler
+//
+//  SYNOPSIS
+//
+//      CricketTaskInit();                  // Called once at startup
+//
+//      CricketTaskEvery(CricketFadeTick,CRICKET_TICK_MS);  // Periodic task
+//      CricketTaskEvery(CricketSchedService,1);
+//      CricketTaskAfter(LightsOut,60000);                  // One-shot task, in a minute
+//      CricketTaskStart(Demo);                             // Resumable task, see below
+//
+//      sei();
+//
+//      CricketTaskRun();                   // Never returns
+//
+//      uint32_t MS = CricketTaskMS();      // Time since startup
+//      uint32_t US = CricketTaskUS();
+//
+//      static void Demo(void) {
+//          static uint8_t Count;           // Locals don't survive a yield, use statics
+//
+//          CRICKET_PT_BEGIN;
+//
+//          for( Count = 0; Count < 10; Count++ ) {
+//              CricketLEDDec(Count,0);
+//              CRICKET_PT_DELAY(100);      // Other tasks run meanwhile
+//              }
+//
+//          CRICKET_PT_WAIT_UNTIL(!CricketBusBusy());
+//
+//          CRICKET_PT_END;                 // Task is done
+//          }
+//
+//  DESCRIPTION
+//
+//      Cooperative task scheduler, on a 1 mS Timer0 timebase.
+//
+//      Timer0 runs in CTC mode at clk/64, interrupting every mS. The interrupt counts
+//        mS since startup; CricketTaskUS() adds the count in Timer0 for 4 uS steps
+//        (at 16 MHz). Both wrap: mS after 49 days, uS after 71 minutes.
+//
+//      Tasks are functions taking and returning nothing, in a table of CRICKET_TASK_MAX
+//        entries. CricketTaskRun() loops calling each task that is due, forever:
+//
+//          CricketTaskEvery    Runs every so many mS, the first time right away.
+//                                If a run is late by a whole period, the missed runs
+//                                are dropped rather than run back to back.
+//
+//          CricketTaskAfter    Runs once, after so many mS.
+//
+//          CricketTaskStart    Runs every pass until it stops itself. Meant for the
+//                                CRICKET_PT_xxx macros below.
+//
+//      From inside a task, CricketTaskDelay() sets when the task runs next (in place
+//        of its usual schedule), CricketTaskIdle() says that it found nothing to do,
+//        and CricketTaskExit() takes it out of the table.
+//
+//      The CRICKET_PT_xxx macros make a task resumable ("protothreads"): written as
+//        straight line code with loops and delays, each delay or wait returns to the
+//        scheduler and the next run picks up where it left off. There's one
+//        resume point per function, so a function can only be one task, and locals
+//        must be static if they're needed across a delay.
+//
+//      When a whole pass finds nothing to do (every task ran was idle, or none were
+//        due), the CPU sleeps in idle mode until the next interrupt, which is at most
+//        1 mS away. Timer1, the UART and the bus keep running while asleep.
+//
+//      Nothing is preemptive: a task runs until it returns, so keep each run short.
+//        The bit-bang bus driver blocks for each byte it sends; the other bus drivers,
+//        and the UART, just queue bytes for their interrupts.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef CRICKETTASK_H
+#define CRICKETTASK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// User configurable options
+//
+#ifndef CRICKET_TASK_MAX
+#define CRICKET_TASK_MAX        8           // Tasks at one time
+#endif
+
+//
+// Timer0 runs at clk/CRICKET_TASK_PRESCALE, and must count less than 256 per mS.
+//   64 suits 8 to 16 MHz.
+//
+#ifndef CRICKET_TASK_PRESCALE
+#define CRICKET_TASK_PRESCALE   64
+#endif
+
+//
+// End of user configurable options
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#define CRICKET_TASK_PER_MS     (F_CPU/CRICKET_TASK_PRESCALE/1000)   // Timer0 counts per mS
+
+#define CRICKET_TASK_NONE       0xFF        // Returned if the task table is full
+
+typedef void (*CricketTaskFn)(void);
+
+//
+// Resumable task macros
+//
+// CRICKET_PT_BEGIN and CRICKET_PT_END bracket the whole body of the task. In between,
+//   CRICKET_PT_YIELD lets other tasks run, CRICKET_PT_DELAY waits a number of mS, and
+//   CRICKET_PT_WAIT_UNTIL waits for a condition (set by an interrupt or another task).
+//
+// The resume point is a case label in a switch, so the body can't have a switch of
+//   its own around a yield.
+//
+#define CRICKET_PT_BEGIN    static uint16_t _PT_Line_ = 0; switch( _PT_Line_ ) { case 0:
+
+#define CRICKET_PT_YIELD    do { _PT_Line_ = __LINE__; return; case __LINE__:; } while(0)
+
+#define CRICKET_PT_DELAY(_MS_)                                                          \
+    do { CricketTaskDelay(_MS_); CRICKET_PT_YIELD; } while(0)
+
+#define CRICKET_PT_WAIT_UNTIL(_Cond_)                                                   \
+    do { _PT_Line_ = __LINE__; case __LINE__:                                           \
+         if( !(_Cond_) ) { CricketTaskIdle(); return; } } while(0)
+
+#define CRICKET_PT_END      } _PT_Line_ = 0; CricketTaskExit()
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketTaskInit - Start the timebase, and clear the task table
+//
+// Inputs:      None.
+//
+// Outputs:     None.
+//
+void CricketTaskInit(void);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketTaskMS - Return mS since startup
+// CricketTaskUS - Return uS since startup
+//
+// Inputs:      None.
+//
+// Outputs:     Time since CricketTaskInit()
+//
+uint32_t CricketTaskMS(void);
+uint32_t CricketTaskUS(void);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketTaskEvery - Add a task that runs every so often
+// CricketTaskAfter - Add a task that runs once, after a delay
+// CricketTaskStart - Add a task that runs every pass (resumable task)
+//
+// Inputs:      Task function
+//              [Every] Period in mS
+//              [After] Delay in mS
+//
+// Outputs:     Task number (for CricketTaskStop), or CRICKET_TASK_NONE if the table is full
+//
+uint8_t CricketTaskEvery(CricketTaskFn Fn,uint16_t MS);
+uint8_t CricketTaskAfter(CricketTaskFn Fn,uint16_t MS);
+uint8_t CricketTaskStart(CricketTaskFn Fn);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketTaskStop - Remove a task
+//
+// Inputs:      Task number, from when it was added
+//
+// Outputs:     None.
+//
+void CricketTaskStop(uint8_t Task);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketTaskDelay - Run the current task next after a delay
+// CricketTaskIdle  - Note that the current task found nothing to do
+// CricketTaskExit  - Remove the current task once it returns
+//
+// Called from inside a task.
+//
+// Inputs:      [Delay] mS until the next run
+//
+// Outputs:     None.
+//
+void CricketTaskDelay(uint16_t MS);
+void CricketTaskIdle(void);
+void CricketTaskExit(void);
+
+///////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketTaskPass - Run each task that is due, once
+// CricketTaskRun  - Run tasks forever, sleeping when there's nothing to do
+//
+// Use CricketTaskPass from a main loop of your own, CricketTaskRun otherwise.
+//
+// Inputs:      None.
+//
+// Outputs:     [CricketTaskPass] TRUE  if some task did something
+//                                FALSE if all were idle, or none were due
+//
+bool CricketTaskPass(void);
+void CricketTaskRun(void);
+
+#endif  // CRICKETTASK_H - entire file
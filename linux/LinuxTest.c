@@ -0,0 +1,472 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      LinuxTest.c - Tests for the Linux bus driver
+//
+//  SYNOPSIS
+//
+//      make -C linux test                  // All tests, on the mock line
+//
+//      linux/LinuxTest                     // Same
+//      linux/LinuxTest LED Timing          // Just these
+//      linux/LinuxTest -v Timing           // With the jitter report
+//      linux/LinuxTest -g /dev/gpiochip1 -l 0   // GPIO test too, on a real or gpio-sim line
+//
+//  DESCRIPTION
+//
+//      Tests for the Linux bus driver (CricketBusLinux.c), without hardware.
+//
+//      The driver runs with its mock line, which records each edge with the time it was
+//        scheduled and the time it was set. The emulated bus devices of the host build
+//        (host/HostBus.c, built here with F_CPU at 1 GHz so that its cycles are nS)
+//        decode the recording: on the scheduled times, to check the frames, and on the
+//        actual times, to see what a device on a real line would have made of them.
+//
+//      Whether the actual times hold up depends on the machine. With the bus thread on
+//        an isolated core they should; on a loaded desktop or a single core VM they may
+//        not. Late edges fail the Timing test if the bus thread got SCHED_FIFO and a
+//        core of its own; without those it reports the jitter and is SKIPPED.
+//
+//      With -g and -l the GPIO test runs as well, on a GPIO character device line. With
+//        the gpio-sim module, for instance:
+//
+//          modprobe gpio-sim
+//          mkdir -p /sys/kernel/config/gpio-sim/cricket/gpio-bank0
+//          echo 8 > /sys/kernel/config/gpio-sim/cricket/gpio-bank0/num_lines
+//          echo 1 > /sys/kernel/config/gpio-sim/cricket/live
+//          linux/LinuxTest -g /dev/gpiochip1 -l 0 GPIO     // Whichever chip it made
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "CricketBusLinux.h"
+#include "CricketLED.h"
+#include "CricketMotor.h"
+#include "CricketRelay.h"
+#include "HostBus.h"
+#include "PortMacros.h"
+
+#define RECORD              (1 << 16)       // Edges recorded by the mock line
+
+static struct {
+    uint64_t    Scheduled;
+    uint64_t    Actual;
+    uint8_t     Level;
+    } Record[RECORD];
+
+static uint32_t     Recorded;
+static int          Fails;
+static bool         Skipped;                // Test couldn't say either way
+static bool         Verbose;
+
+//
+// Test process exit status
+//
+#define TEST_PASSED     0
+#define TEST_FAILED     1
+#define TEST_SKIPPED    2
+static const char  *Chip;
+static uint32_t     Line;
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CHECK - Note a failed condition, and carry on
+//
+#define CHECK(_c_)  Check(_c_,#_c_,__LINE__)
+
+static void Check(bool OK,const char *What,int Line) {
+
+    if( OK )
+        return;
+
+    printf("    line %d: %s\n",Line,What);
+    Fails++;
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Mock - The mock line: record each edge
+//
+static void Mock(uint64_t Scheduled,uint64_t Actual,uint8_t Level) {
+
+    if( Recorded < RECORD )
+        Record[Recorded++] = (typeof(Record[0])) { Scheduled, Actual, Level };
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Start  - Start the driver on the mock line
+// Drain  - Wait until the bus is done sending
+// Decode - Pass the recording to the emulated devices
+//
+// Inputs:      [Decode] TRUE for the actual times, FALSE for the scheduled ones
+//
+static void Start(void) {
+    CRICKET_LINUX Config = CRICKET_LINUX_DEFAULT;
+
+    Config.Chip = NULL;
+    Config.Mock = Mock;
+
+    CHECK(CricketBusLinuxInit(&Config));
+    }
+
+static void Drain(void) {
+
+    while( CricketBusBusy() )
+        usleep(1000);
+    }
+
+static void Decode(bool Actual) {
+    uint32_t Index;
+    uint64_t At = 0;
+
+    HostBusReset();
+
+    for( Index = 0; Index < Recorded; Index++ ) {
+        At = Actual ? Record[Index].Actual : Record[Index].Scheduled;
+        HostBusEdge(At,Record[Index].Level);
+        }
+
+    HostBusSync(At + 1000000);                          // Past the last stop bit
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// LED display calls, as scheduled
+//
+static void TestLED(void) {
+    static const uint8_t Pat[4] = { 0x01, 0x80, 0x55, 0xAA };
+
+    Start();
+    CricketLEDDec(1234,1);
+    CricketLEDHex(0xBEEF,2);
+    CricketLEDBright(5,0);
+    CricketLEDPat(Pat[0],Pat[1],Pat[2],Pat[3],2);
+    Drain();
+    Decode(false);
+
+    CHECK(HostLED[1].Mode   == HOST_LED_NUMBER);
+    CHECK(HostLED[1].Number == 1234);
+    CHECK(HostLED[1].Bright == 5);
+    CHECK(HostLED[2].Mode   == HOST_LED_PAT);
+    CHECK(memcmp(HostLED[2].Pat,Pat,4) == 0);
+    CHECK(HostLED[2].Bright == 5);
+    CHECK(HostLED[2].Frames == 3);
+    CHECK(HostBus.Bytes     == 4+4+4+6);
+    CHECK(HostBus.Errors    == 0);
+    CHECK(HostBus.MaxErrNS  == 0);
+    CHECK(CricketBusSent()  == CricketBusPosted());
+    }
+
+static void TestMotorRelay(void) {
+
+    Start();
+    CricketMotorSet(2,-50);
+    CricketRelaySet(0xA5);
+
+    while( CricketMotorPending() || CricketRelayPending() ) {
+        CricketMotorService();
+        CricketRelayService();
+        usleep(1000);
+        }
+
+    Drain();
+    Decode(false);
+
+    CHECK(HostMotor[2].Speed == -50);
+    CHECK(HostRelay.Mask     == 0xA5);
+    CHECK(HostBus.Errors     == 0);
+    }
+
+//
+// More than the FIFO holds, sent in order
+//
+static void TestFIFO(void) {
+    CRICKET_LINUX_STATS Stats;
+    uint8_t  Frame;
+    bool     InOrder = true;
+    uint64_t Length;
+
+    Start();
+
+    for( Frame = 0; Frame < 20; Frame++ )
+        CricketLEDPat(Frame,0,0,Frame,1);
+
+    Drain();
+    Decode(false);
+    CricketBusLinuxStats(&Stats);
+
+    for( Frame = 0; Frame < 20; Frame++ )
+        if( HostBus.Log[Frame*6 + 2].Byte != Frame )
+            InOrder = false;
+
+    Length = HostBus.FrameEnd - HostBus.Log[0].At;
+
+    CHECK(HostLED[1].Frames == 20);
+    CHECK(HostLED[1].Pat[0] == 19);
+    CHECK(InOrder);
+    CHECK(Stats.Bytes       == 20*6);
+    CHECK(Length            >= 20*6*CRICKET_BYTE_US*1000ULL); // More if the queue ran dry
+    CHECK(HostBus.Errors    == 0);
+    }
+
+//
+// Exit sends what's queued, and the driver starts again
+//
+static void TestExit(void) {
+
+    Start();
+    CricketLEDDec(1,1);
+    CricketLEDDec(2,2);
+    CricketBusLinuxExit();
+    Decode(false);
+
+    CHECK(HostLED[1].Number == 1);
+    CHECK(HostLED[2].Number == 2);
+
+    Recorded = 0;
+    Start();
+    CricketLEDDec(3,1);
+    Drain();
+    Decode(false);
+
+    CHECK(HostLED[1].Number == 3);
+    CHECK(HostBus.Bytes     == 4);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Timing, as set on the line
+//
+// Edges are never early, the stats agree with the recording, and if the machine kept
+//   every edge within tolerance a device would have read every frame.
+//
+// Late edges are only a failure if the bus thread ran as it should: SCHED_FIFO, pinned
+//   to a core. On a single core machine that core is shared with everything else, so
+//   it doesn't count. Otherwise the machine can't show either way, and the test is
+//   skipped.
+//
+static void TestTiming(void) {
+    CRICKET_LINUX_STATS Stats;
+    uint32_t Index;
+    uint32_t Early = 0;
+    uint16_t Frame;
+    bool     RealTime;
+
+    Start();
+
+    for( Frame = 0; Frame < 100; Frame++ ) {
+        CricketLEDPat(Frame,Frame >> 8,~Frame,Frame ^ 0x55,1);
+        if( Frame % 10 == 9 )
+            usleep(20000);                              // Some idle, some back to back
+        }
+
+    Drain();
+    CricketBusLinuxStats(&Stats);
+
+    for( Index = 0; Index < Recorded; Index++ )
+        if( Record[Index].Actual < Record[Index].Scheduled )
+            Early++;
+
+    Decode(true);
+
+    RealTime = Stats.Realtime && Stats.Pinned && sysconf(_SC_NPROCESSORS_ONLN) > 1;
+
+    CHECK(Early == 0);
+    CHECK(Stats.Bytes == 100*6);
+    CHECK(Stats.Edges + 100*6 == Recorded);             // Every edge but the pre-starts
+    CHECK(Stats.MaxLateNS*(uint64_t) Stats.Edges >= Stats.SumLateNS);
+
+    if( Stats.Misses == 0 || RealTime ) {
+        CHECK(Stats.Misses      == 0);
+        CHECK(HostBus.Errors    == 0);
+        CHECK(HostLED[1].Frames == 100);
+        }
+    else {
+        printf("    %u of %u edges late by over %u nS, without SCHED_FIFO on a core of its own:"
+               " %u bytes misread\n",Stats.Misses,Stats.Edges,CRICKET_LINUX_TOL_NS,HostBus.Errors);
+        Skipped = true;
+        }
+
+    if( Verbose )
+        CricketBusLinuxReport(stdout);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// GPIO - The same, on a GPIO character device line (-g and -l)
+//
+static void TestGPIO(void) {
+    CRICKET_LINUX Config = CRICKET_LINUX_DEFAULT;
+    uint16_t Frame;
+
+    Config.Chip = Chip;
+    Config.Line = Line;
+
+    if( !CricketBusLinuxInit(&Config) ) {
+        perror(Chip);
+        Fails++;
+        return;
+        }
+
+    for( Frame = 0; Frame < 100; Frame++ )
+        CricketLEDDec(Frame,0);
+
+    Drain();
+    CricketBusLinuxExit();
+    CricketBusLinuxReport(stdout);
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Test list
+//
+typedef struct {
+    const char *Name;
+    void      (*Fn)(void);
+    bool        GPIO;                       // Needs a GPIO line
+    } TEST;
+
+static const TEST Tests[] = {
+    { "LED",        TestLED,        false },
+    { "MotorRelay", TestMotorRelay, false },
+    { "FIFO",       TestFIFO,       false },
+    { "Exit",       TestExit,       false },
+    { "Timing",     TestTiming,     false },
+    { "GPIO",       TestGPIO,       true  },
+    };
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// RunTest - Run one test in a process of its own
+//
+// Inputs:      Test
+//
+// Outputs:     TEST_PASSED, TEST_FAILED or TEST_SKIPPED
+//
+static int RunTest(const TEST *Test) {
+    pid_t Child;
+    int   Status;
+
+    printf("%-12s\n",Test->Name);
+    fflush(stdout);
+
+    Child = fork();
+
+    if( Child == 0 ) {
+        Test->Fn();
+        CricketBusLinuxExit();
+        if( HostBus.Errors )
+            printf("    %u bus errors, last: %s\n",HostBus.Errors,HostBus.LastError);
+        fflush(stdout);
+        _exit(Fails ? TEST_FAILED : Skipped ? TEST_SKIPPED : TEST_PASSED);
+        }
+
+    if( Child < 0 || waitpid(Child,&Status,0) != Child || !WIFEXITED(Status) )
+        return(TEST_FAILED);
+
+    if( WEXITSTATUS(Status) == TEST_SKIPPED )
+        return(TEST_SKIPPED);
+
+    return(WEXITSTATUS(Status) == TEST_PASSED ? TEST_PASSED : TEST_FAILED);
+    }
+
+
+int main(int argc,char *argv[]) {
+    int     Option;
+    int     Failed = 0;
+    int     Skips  = 0;
+    int     Run    = 0;
+    uint8_t Index;
+
+    while( (Option = getopt(argc,argv,"vg:l:")) != -1 ) {
+        switch( Option ) {
+            case 'v': Verbose = true;               break;
+            case 'g': Chip    = optarg;             break;
+            case 'l': Line    = atoi(optarg);       break;
+            default:
+                fprintf(stderr,"Usage: %s [-v] [-g chip -l line] [test ...]\n",argv[0]);
+                return(2);
+            }
+        }
+
+    printf("Linux bus driver tests, %s\n",Chip ? Chip : "mock line only");
+
+    for( Index = 0; Index < NUMOF(Tests); Index++ ) {
+        int Name;
+
+        for( Name = optind; Name < argc && strcmp(argv[Name],Tests[Index].Name) != 0; Name++ );
+
+        if( optind < argc && Name == argc )
+            continue;                                   // Not asked for
+
+        if( Tests[Index].GPIO && Chip == NULL )
+            continue;                                   // No line to test on
+
+        Run++;
+        switch( RunTest(&Tests[Index]) ) {
+            case TEST_FAILED:
+                printf("    FAILED\n");
+                Failed++;
+                break;
+
+            case TEST_SKIPPED:
+                printf("    SKIPPED\n");
+                Skips++;
+                break;
+            }
+        }
+
+    printf("%d of %d tests passed",Run-Failed-Skips,Run);
+    if( Skips )
+        printf(", %d skipped",Skips);
+    printf("\n");
+
+    return(Failed ? 1 : 0);
+    }
@@ -0,0 +1,216 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//      Copyright (C) 2018 Peter Walsh, Milford, NH 03055
+//      All Rights Reserved under the MIT license as outlined below.
+//
+//  FILE
+//      CricketAnimEncode.c
+//
+//  SYNOPSIS
+//
+//      cc -o CricketAnimEncode CricketAnimEncode.c
+//
+//      ./CricketAnimEncode MyAnim < frames.txt > MyAnim.h
+//
+//      frames.txt has one frame per line: four segment patterns (as for CricketLEDPat)
+//        and the frame duration in ticks (1-255), numbers in C notation. Blank lines
+//        and lines starting with # are ignored.
+//
+//          # Spin the top segment around the display
+//          0x01 0x00 0x00 0x00 5
+//          0x00 0x01 0x00 0x00 5
+//          ...
+//
+//  DESCRIPTION
+//
+//      Host tool: encode a frame list as a CricketAnim.h delta-compressed animation.
+//
+//      Writes a C header with the animation as a PROGMEM byte array, and reports the
+//        size against the raw frames (4 pattern bytes plus a duration byte each) on
+//        stderr.
+//
+//      Each frame becomes whichever is smaller, a keyframe or a delta. A delta that's
+//        the same as the one before (same duration, too) bumps that record's repeat
+//        count instead of taking a new record.
+//
+//      See CricketAnim.h for the format.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+//  MIT LICENSE
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy of
+//    this software and associated documentation files (the "Software"), to deal in
+//    the Software without restriction, including without limitation the rights to
+//    use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+//    of the Software, and to permit persons to whom the Software is furnished to do
+//    so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//    all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+//    INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+//    PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//    OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "../lib/CricketAnim.h"
+
+#define MAX_ANIM    65536                   // Max encoded size
+
+static uint8_t Out[MAX_ANIM];
+static size_t  OutLen;
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Emit - Add one byte to the encoded animation
+//
+// Inputs:      Byte to add
+//
+// Outputs:     None.
+//
+static void Emit(uint8_t Byte) {
+
+    if( OutLen >= MAX_ANIM ) {
+        fprintf(stderr,"CricketAnimEncode: animation too long\n");
+        exit(1);
+        }
+
+    Out[OutLen++] = Byte;
+    }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// CricketAnimEncode - Encode a frame list
+//
+// Inputs:      Name of the animation (argv[1])
+//
+// Outputs:     Exit status, 0 if OK
+//
+int main(int argc,char *argv[]) {
+    char     Line[256];
+    uint8_t  Frame[4];
+    uint8_t  Prev[4];
+    unsigned Duration     = 0;              // Duration as of the last record
+    size_t   LastDelta    = 0;              // Control byte of last delta record...
+    uint8_t  LastXOR[4];                    //   ...its XOR bytes
+    uint8_t  LastMask     = 0;
+    bool     CanRepeat    = false;          //   ...TRUE if it can take another repeat
+    unsigned Frames       = 0;
+    unsigned LineNo       = 0;
+    size_t   Index;
+
+    if( argc != 2 ) {
+        fprintf(stderr,"Usage: %s Name < frames.txt > Name.h\n",argv[0]);
+        return(1);
+        }
+
+    while( fgets(Line,sizeof(Line),stdin) ) {
+        int      Dig[4];
+        int      Ticks;
+        uint8_t  XOR[4];
+        uint8_t  Mask = 0;
+        uint8_t  Dur  = 0;
+        unsigned Digit;
+        unsigned DeltaLen;
+        char    *Start = Line;
+
+        LineNo++;
+        while( *Start == ' ' || *Start == '\t' )
+            Start++;
+        if( *Start == '#' || *Start == '\n' || *Start == '\r' || *Start == 0 )
+            continue;
+
+        if( sscanf(Start,"%i %i %i %i %i",&Dig[0],&Dig[1],&Dig[2],&Dig[3],&Ticks) != 5 ||
+            Ticks < 1 || Ticks > 255 ) {
+            fprintf(stderr,"CricketAnimEncode: line %u: need 4 patterns and 1-255 ticks\n",LineNo);
+            return(1);
+            }
+
+        for( Digit = 0; Digit < 4; Digit++ ) {
+            Frame[Digit] = Dig[Digit] & 0xFF;
+            XOR  [Digit] = Frames ? Frame[Digit] ^ Prev[Digit] : 0;
+            if( XOR[Digit] )
+                Mask |= 1 << Digit;
+            }
+
+        if( (unsigned) Ticks != Duration )
+            Dur = CRICKET_ANIM_DURATION;
+
+        DeltaLen = __builtin_popcount(Mask);
+
+        //
+        // Same delta and duration as the last record: just repeat it.
+        //
+        if( Frames && CanRepeat && Dur == 0 && Mask == LastMask &&
+            memcmp(XOR,LastXOR,4) == 0 ) {
+            Out[LastDelta] += CRICKET_ANIM_REPEAT;
+            if( (Out[LastDelta] & CRICKET_ANIM_REPEATS) == CRICKET_ANIM_REPEATS )
+                CanRepeat = false;
+            }
+
+        //
+        // Keyframe if it's the first, or no bigger than the delta
+        //
+        else if( Frames == 0 || DeltaLen == 4 ) {
+            Emit(CRICKET_ANIM_KEY | Dur);
+            if( Dur )
+                Emit(Ticks);
+            for( Digit = 0; Digit < 4; Digit++ )
+                Emit(Frame[Digit]);
+            CanRepeat = false;
+            }
+
+        else {
+            if( Mask == 0 )
+                Dur = CRICKET_ANIM_DURATION;    // 0x00 would be the end marker
+            LastDelta = OutLen;
+            Emit(Mask | Dur);
+            if( Dur )
+                Emit(Ticks);
+            for( Digit = 0; Digit < 4; Digit++ ) {
+                if( XOR[Digit] )
+                    Emit(XOR[Digit]);
+                }
+            memcpy(LastXOR,XOR,4);
+            LastMask  = Mask;
+            CanRepeat = true;
+            }
+
+        Duration = Ticks;
+        memcpy(Prev,Frame,4);
+        Frames++;
+        }
+
+    if( Frames == 0 ) {
+        fprintf(stderr,"CricketAnimEncode: no frames\n");
+        return(1);
+        }
+
+    Emit(CRICKET_ANIM_END);
+
+    printf("//\n// %s - %u frames, made by CricketAnimEncode\n//\n",argv[1],Frames);
+    printf("static const uint8_t %s[%zu] PROGMEM = {",argv[1],OutLen);
+    for( Index = 0; Index < OutLen; Index++ )
+        printf("%s0x%02X,",(Index % 12) ? " " : "\n    ",Out[Index]);
+    printf("\n    };\n");
+
+    fprintf(stderr,"%s: %u frames, %u bytes raw, %zu bytes encoded, ratio %.2f:1\n",
+            argv[1],Frames,Frames*5,OutLen,(double) (Frames*5)/OutLen);
+
+    return(0);
+    }